@@ -15,6 +15,7 @@ project "App"
       "../FNN/Source/Neuron",
       "../FNN/Source/NNetwork",
       "../FNN/Source/Random",
+      "../FNN/Source/Statistics",
 
       -- Include Examples
       "Source/Example",
@@ -35,6 +36,10 @@ project "App"
        systemversion "latest"
        defines { "WINDOWS" }
 
+   -- Shared memory of data parallel training lives in librt on older glibc
+   filter "system:linux"
+       links { "pthread", "rt" }
+
    filter "configurations:Debug"
        defines { "DEBUG" }
        runtime "Debug"
@@ -1,7 +1,13 @@
 #include <iostream>
 #include <vector>
 
+#include "Example/ExampleAsync.hpp"
+#include "Example/ExampleBatchingQueue.hpp"
+#include "Example/ExampleCodegen.hpp"
 #include "Example/ExampleConnections.hpp"
+#include "Example/ExampleDataParallel.hpp"
+#include "Example/ExampleModelPublisher.hpp"
+#include "Example/ExampleReport.hpp"
 
 int main()
 {
@@ -33,5 +39,13 @@ int main()
     exampleConnections4(trainX, trainY, epochs);
     exampleConnections5(trainX, trainY, epochs);
 
-    return 0;
+    exampleReport();
+    const bool isDataParallelMatching = exampleDataParallel();
+    const bool isCodegenMatching = exampleCodegen();
+    const bool isPublisherMatching = exampleModelPublisher();
+    const bool isBatchingMatching = exampleBatchingQueue();
+    const bool isAsyncMatching = exampleAsync();
+
+    // Equivalence checks fail the run, so a regression does not go unnoticed
+    return isDataParallelMatching && isCodegenMatching && isPublisherMatching && isBatchingMatching && isAsyncMatching ? 0 : 1;
 }
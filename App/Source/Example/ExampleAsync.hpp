@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <stop_token>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "AsyncExecutor.hpp"
+#include "NModel.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleAsync
+ * @brief Demonstrates predicting and training through futures on a library managed executor.
+ *
+ * This function starts a long training job on fnn::AsyncExecutor and keeps requesting predictions on a compiled copy
+ * of the network while it runs. Training yields its worker every few samples, so predictions complete during
+ * training. A second job is cancelled through std::stop_source and a reference network trained with blocking
+ * NNetwork::Fit shows that asynchronous training updates weights identically.
+ *
+ * Key Steps:
+ * 1. Data: Generates 256 random samples with 8 inputs and 2 targets.
+ * 2. Network Configuration: Defines a network with 8 input, 32 and 16 hidden and 2 output neurons and copies its
+ *    weights into a reference network and a network that is cancelled.
+ * 3. Serving: Trains 10 epochs on an executor with 2 workers while predictions are requested one after another.
+ * 4. Check: Prints predictions completed during training, the result of the cancelled job, and compares the trained
+ *    weights to the reference network.
+ *
+ * @return True if training succeeded and the trained weights match the reference network, false otherwise.
+ */
+bool exampleAsync()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Random dataset, fixed seed keeps runs comparable
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<std::vector<float>> trainX(256, std::vector<float>(8));
+    std::vector<std::vector<float>> trainY(256, std::vector<float>(2));
+    for (auto &row : trainX)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+    for (auto &row : trainY)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+
+    // Create network with 4 layers -> 8 input, 32 hidden, 16 hidden, 2 output, an identical reference and a copy to cancel
+    auto fnn = fnn::NNetwork({ 8, 32, 16, 2 });
+    auto reference = fnn::NNetwork({ 8, 32, 16, 2 });
+    auto cancelled = fnn::NNetwork({ 8, 32, 16, 2 });
+    fnn.m_network->MapFunction<fnn::SigmoidStrategy>();
+    reference.m_network->MapFunction<fnn::SigmoidStrategy>();
+    cancelled.m_network->MapFunction<fnn::SigmoidStrategy>();
+    std::vector<float> weights;
+    fnn.GetWeights(weights);
+    reference.SetWeights(weights);
+    cancelled.SetWeights(weights);
+
+    // Predictions use a compiled model, the network itself belongs to the training job until it finishes
+    const auto model = fnn::NModel::Compile(fnn);
+
+    fnn::AsyncExecutor executor(2, 32);
+    std::stop_source cancel;
+    auto training = executor.Fit(fnn, trainX, trainY, 10);
+    auto cancelledTraining = executor.Fit(cancelled, trainX, trainY, 10, cancel.get_token());
+    cancel.request_stop();
+
+    size_t served = 0;
+    while (training.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        const auto output = executor.Predict(model, { trainX[served % trainX.size()] }).get();
+        served += output.size();
+    }
+
+    if (! training.get() || ! reference.Fit(trainX, trainY, 10))
+    {
+        printf("Training failed\n");
+        return false;
+    }
+
+    std::vector<float> trainedWeights;
+    std::vector<float> referenceWeights;
+    fnn.GetWeights(trainedWeights);
+    reference.GetWeights(referenceWeights);
+
+    const bool isTrainingMatching = trainedWeights == referenceWeights;
+    printf("Served %zu predictions while training, cancelled job returned %s, training %s\n", served,
+        cancelledTraining.get() ? "true" : "false",
+        isTrainingMatching ? "matches Fit" : "DIFFERS FROM Fit");
+
+    return isTrainingMatching;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "BatchingQueue.hpp"
+#include "NModel.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleBatchingQueue
+ * @brief Demonstrates coalescing single input requests from many threads into batched predictions.
+ *
+ * This function serves a compiled model through fnn::BatchingQueue. Eight producer threads each submit one input
+ * vector at a time and wait for its future, the queue groups concurrent requests into batches predicted by two
+ * workers. Every result is compared to NModel::Predict of the same input.
+ *
+ * Key Steps:
+ * 1. Data: Generates 512 random input vectors with 16 features.
+ * 2. Network Configuration: Defines a network with 16 input, 64 and 32 hidden and 4 output neurons and compiles it.
+ * 3. Serving: Eight producers submit 64 requests each, batches hold at most 16 requests and wait at most 500 us.
+ * 4. Check: Prints completed requests, mean batch size and latency histogram, and compares results to Predict.
+ *
+ * @return True if the model compiled and every served result matches Predict, false otherwise.
+ */
+bool exampleBatchingQueue()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Random inputs, fixed seed keeps runs comparable
+    std::mt19937 engine(11);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<std::vector<float>> testX(512, std::vector<float>(16));
+    for (auto &row : testX)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+
+    // Create network with 4 layers -> 16 input, 64 hidden, 32 hidden, 4 output
+    auto fnn = fnn::NNetwork({ 16, 64, 32, 4 });
+    fnn.m_network->MapFunction<fnn::SigmoidStrategy>();
+    const auto model = fnn::NModel::Compile(fnn);
+    if (model == nullptr)
+    {
+        printf("Compilation failed\n");
+        return false;
+    }
+
+    fnn::BatchingOptions options;
+    options.m_maxBatchSize = 16;
+    options.m_maxWait = std::chrono::microseconds(500);
+    options.m_workers = 2;
+
+    // Each producer keeps one request in flight, so concurrent producers are what fills a batch
+    const size_t producers = 8;
+    std::vector<std::vector<float>> served(testX.size());
+    fnn::BatchingStatistics statistics;
+    {
+        fnn::BatchingQueue queue(model, options);
+        std::vector<std::thread> threads;
+        for (size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&, producer] {
+                for (size_t row = producer; row < testX.size(); row += producers)
+                {
+                    served[row] = queue.Submit(testX[row]).get();
+                }
+            });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        queue.Stop();
+        statistics = queue.Statistics();
+    }
+
+    fnn::InferenceContext context;
+    std::vector<float> expected;
+    float difference = 0.0f;
+    for (size_t row = 0; row < testX.size(); ++row)
+    {
+        model->Predict(context, testX[row], expected);
+        if (served[row].size() != expected.size())
+        {
+            difference = INFINITY;
+            break;
+        }
+        for (size_t o = 0; o < expected.size(); ++o)
+        {
+            difference = std::max(difference, std::abs(expected[o] - served[row][o]));
+        }
+    }
+
+    printf("Completed %llu requests in %llu batches, mean batch %.1f, results %s\n",
+        static_cast<unsigned long long>(statistics.m_requests), static_cast<unsigned long long>(statistics.m_batches),
+        statistics.m_batches == 0 ? 0.0 : static_cast<double>(statistics.m_requests) / static_cast<double>(statistics.m_batches),
+        difference == 0.0f ? "match Predict" : "DIFFER FROM Predict");
+    printf("Latency histogram [us bucket: requests]:");
+    for (size_t bucket = 0; bucket < statistics.m_latencyHistogram.size(); ++bucket)
+    {
+        if (statistics.m_latencyHistogram[bucket] != 0)
+        {
+            printf(" <%llu: %llu", 1ull << bucket, static_cast<unsigned long long>(statistics.m_latencyHistogram[bucket]));
+        }
+    }
+    printf("\n");
+
+    return difference == 0.0f;
+}
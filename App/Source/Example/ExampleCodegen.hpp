@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "CodeGenerator.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleCodegen
+ * @brief Demonstrates exporting a trained network as standalone C++ source with a self check against Predict.
+ *
+ * This function trains a small network with different activations per layer and writes it as generated C++ source
+ * into the temporary directory. The source contains a main comparing the generated inference function to outputs
+ * NNetwork::Predict returned during export, enabled by defining FNN_GENERATED_SELF_CHECK.
+ *
+ * Key Steps:
+ * 1. Data: Generates 64 random samples with 6 inputs and 2 targets.
+ * 2. Network Configuration: Defines a network with 6 input, 16 and 8 hidden and 2 output neurons, using FastTanh,
+ *    Tanh and Sigmoid activations for the hidden and output layers.
+ * 3. Training: Runs 3 epochs with Fit.
+ * 4. Export: Writes the source with 16 check inputs.
+ * 5. Check: Compiles the source with the compiler named by the CXX environment variable, c++ by default, and runs the
+ *    self check. The check is skipped with a notice when no such compiler is found or no shell is available.
+ *
+ * @return True if the network was exported and the self check passed or was skipped, false otherwise.
+ */
+bool exampleCodegen()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Random dataset, fixed seed keeps runs comparable
+    std::mt19937 engine(11);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::vector<std::vector<float>> trainX(64, std::vector<float>(6));
+    std::vector<std::vector<float>> trainY(64, std::vector<float>(2));
+    for (auto &row : trainX)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+    for (auto &row : trainY)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+
+    // Create network with 4 layers -> 6 input, 16 hidden, 8 hidden, 2 output
+    auto fnn = fnn::NNetwork({ 6, 16, 8, 2 });
+    fnn.m_network->MapFunction(std::make_shared<fnn::FastTanhStrategy>(), 1);
+    fnn.m_network->MapFunction(std::make_shared<fnn::TanhStrategy>(), 2);
+    fnn.m_network->MapFunction(std::make_shared<fnn::SigmoidStrategy>(), 3);
+    if (! fnn.Fit(trainX, trainY, 3))
+    {
+        printf("Training failed\n");
+        return false;
+    }
+
+    fnn::CodeGenerationOptions options;
+    options.m_namespace = "example_network";
+    options.m_checkInputs.assign(trainX.begin(), trainX.begin() + 16);
+
+    const auto path = (std::filesystem::temp_directory_path() / "fnn_example_network.cpp").string();
+    if (! fnn::utility::writeSource(fnn, options, path))
+    {
+        printf("Export failed\n");
+        return false;
+    }
+
+    // Contraction into fused multiply-add would change rounding against Predict
+    const char *environmentCompiler = std::getenv("CXX");
+    const std::string compiler = environmentCompiler != nullptr && *environmentCompiler != '\0' ? environmentCompiler : "c++";
+    const std::string executable = (std::filesystem::temp_directory_path() / "fnn_example_network").string();
+    const std::string command = compiler + " -std=c++17 -O3 -march=native -ffp-contract=off -DFNN_GENERATED_SELF_CHECK \"" + path +
+                                "\" -o \"" + executable + "\" && \"" + executable + "\"";
+    printf("Generated %s, checking it with:\n  %s\n", path.c_str(), command.c_str());
+
+#if defined(_WIN32)
+    printf("Self check skipped, run the command above with a GCC or Clang compatible compiler\n");
+    return true;
+#else
+    if (std::system(nullptr) == 0 || std::system(("command -v " + compiler + " > /dev/null 2>&1").c_str()) != 0)
+    {
+        printf("Self check skipped, compiler %s not found\n", compiler.c_str());
+        return true;
+    }
+
+    // Output of the self check reports the number of differing outputs, exit code fails the example
+    std::fflush(stdout);
+    const bool isMatching = std::system(command.c_str()) == 0;
+    printf("Generated source %s\n", isMatching ? "matches Predict" : "DIFFERS FROM Predict or failed to compile");
+    return isMatching;
+#endif
+}
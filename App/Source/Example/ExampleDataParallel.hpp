@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "DataParallel.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleDataParallel
+ * @brief Demonstrates mini-batch training split between worker processes and checks it against a single process.
+ *
+ * This function trains two copies of the same network on the same data, once with NNetwork::FitMiniBatch in this
+ * process and once with fnn::utility::dataParallelFit across forked workers that sum their weight changes in shared
+ * memory. Both runs apply the same averaged update per batch, so their weights may only differ by rounding.
+ *
+ * Key Steps:
+ * 1. Data: Generates 256 random samples with 8 inputs and 2 targets.
+ * 2. Network Configuration: Defines a network with 8 input, 32 and 16 hidden and 2 output neurons and copies its
+ *    weights into a second network.
+ * 3. Training: Runs 4 epochs with batches of 32 samples in a single process and in 4 processes.
+ * 4. Check: Prints run times and the largest weight difference, reporting a mismatch above 1e-4.
+ *
+ * @return True if both runs trained and their weights match, false otherwise.
+ */
+bool exampleDataParallel()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Random dataset, fixed seed keeps runs comparable
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<std::vector<float>> trainX(256, std::vector<float>(8));
+    std::vector<std::vector<float>> trainY(256, std::vector<float>(2));
+    for (auto &row : trainX)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+    for (auto &row : trainY)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+
+    // Create network with 4 layers -> 8 input, 32 hidden, 16 hidden, 2 output and an identical copy
+    auto single = fnn::NNetwork({ 8, 32, 16, 2 });
+    auto parallel = fnn::NNetwork({ 8, 32, 16, 2 });
+    single.m_network->MapFunction<fnn::SigmoidStrategy>();
+    parallel.m_network->MapFunction<fnn::SigmoidStrategy>();
+    std::vector<float> weights;
+    single.GetWeights(weights);
+    parallel.SetWeights(weights);
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool singleTrained = single.FitMiniBatch(trainX, trainY, 4, 32);
+    const auto middle = std::chrono::steady_clock::now();
+    const bool parallelTrained = fnn::utility::dataParallelFit(parallel, trainX, trainY, 4, 32, 4);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (! singleTrained || ! parallelTrained)
+    {
+        printf("Training failed, single process: %d, 4 processes: %d\n", singleTrained, parallelTrained);
+        return false;
+    }
+
+    // Replicas sum weight changes in a different order, anything beyond rounding is a bug
+    std::vector<float> singleWeights;
+    std::vector<float> parallelWeights;
+    single.GetWeights(singleWeights);
+    parallel.GetWeights(parallelWeights);
+    float difference = 0.0f;
+    for (size_t i = 0; i < singleWeights.size(); ++i)
+    {
+        difference = std::max(difference, std::abs(singleWeights[i] - parallelWeights[i]));
+    }
+
+    printf("Single process: %.2f ms, 4 processes: %.2f ms, largest weight difference: %g (%s)\n",
+        std::chrono::duration<double, std::milli>(middle - start).count(),
+        std::chrono::duration<double, std::milli>(end - middle).count(),
+        difference, difference <= 1e-4f ? "match" : "MISMATCH");
+    return difference <= 1e-4f;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "ModelPublisher.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleModelPublisher
+ * @brief Demonstrates serving predictions from published snapshots while the same network keeps training.
+ *
+ * This function trains a network through fnn::ModelPublisher, which publishes a compiled snapshot every few batches,
+ * while two reader threads predict on whatever snapshot is current. A second network trained with plain
+ * NNetwork::FitMiniBatch shows that publishing does not change training.
+ *
+ * Key Steps:
+ * 1. Data: Generates 256 random samples with 8 inputs and 2 targets.
+ * 2. Network Configuration: Defines a network with 8 input, 32 and 16 hidden and 2 output neurons and copies its
+ *    weights into a reference network.
+ * 3. Serving: Trains 20 epochs with batches of 16 samples, publishing every 4 batches, while readers predict.
+ * 4. Check: Prints publishes and predictions served, and compares the last snapshot to Predict and the
+ *    trained weights to the reference network.
+ *
+ * @return True if training succeeded, the last snapshot matches Predict and the weights match the reference, false otherwise.
+ */
+bool exampleModelPublisher()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Random dataset, fixed seed keeps runs comparable
+    std::mt19937 engine(5);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+    std::vector<std::vector<float>> trainX(256, std::vector<float>(8));
+    std::vector<std::vector<float>> trainY(256, std::vector<float>(2));
+    for (auto &row : trainX)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+    for (auto &row : trainY)
+    {
+        std::ranges::generate(row, [&] { return value(engine); });
+    }
+
+    // Create network with 4 layers -> 8 input, 32 hidden, 16 hidden, 2 output and an identical reference
+    auto fnn = fnn::NNetwork({ 8, 32, 16, 2 });
+    auto reference = fnn::NNetwork({ 8, 32, 16, 2 });
+    fnn.m_network->MapFunction<fnn::SigmoidStrategy>();
+    reference.m_network->MapFunction<fnn::SigmoidStrategy>();
+    std::vector<float> weights;
+    fnn.GetWeights(weights);
+    reference.SetWeights(weights);
+
+    fnn::ModelPublisher publisher(fnn);
+
+    // Readers only ever see complete snapshots and never wait for training
+    std::atomic<bool> training = true;
+    std::atomic<size_t> served = 0;
+    std::vector<std::thread> readers;
+    for (size_t reader = 0; reader < 2; ++reader)
+    {
+        readers.emplace_back([&, reader] {
+            fnn::InferenceContext context;
+            std::vector<float> output;
+            for (size_t row = reader; training.load(std::memory_order_acquire); ++row)
+            {
+                const auto snapshot = publisher.Snapshot();
+                snapshot->Predict(context, trainX[row % trainX.size()], output);
+                served.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    const bool trained = publisher.FitMiniBatch(trainX, trainY, 20, 16, 4);
+    training.store(false, std::memory_order_release);
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    if (! trained || ! reference.FitMiniBatch(trainX, trainY, 20, 16))
+    {
+        printf("Training failed\n");
+        return false;
+    }
+
+    // Last snapshot holds the final weights, which must equal training without publishing
+    std::vector<std::vector<float>> expected;
+    std::vector<std::vector<float>> actual;
+    fnn::InferenceContext context;
+    fnn.Predict(trainX, expected);
+    publisher.Snapshot()->Predict(context, trainX, actual);
+    float snapshotDifference = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        for (size_t j = 0; j < expected[i].size(); ++j)
+        {
+            snapshotDifference = std::max(snapshotDifference, std::abs(expected[i][j] - actual[i][j]));
+        }
+    }
+
+    std::vector<float> trainedWeights;
+    std::vector<float> referenceWeights;
+    fnn.GetWeights(trainedWeights);
+    reference.GetWeights(referenceWeights);
+
+    const bool isSnapshotMatching = snapshotDifference == 0.0f;
+    const bool isTrainingMatching = trainedWeights == referenceWeights;
+    printf("Published %llu snapshots, served %zu predictions while training, snapshot %s, training %s\n",
+        static_cast<unsigned long long>(publisher.Generation()), served.load(),
+        isSnapshotMatching ? "matches Predict" : "DIFFERS FROM Predict",
+        isTrainingMatching ? "matches FitMiniBatch" : "DIFFERS FROM FitMiniBatch");
+
+    return isSnapshotMatching && isTrainingMatching;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdio>
+
+#include "ActivationStrategy.hpp"
+#include "NNetwork.hpp"
+
+/**
+ * @function exampleReport
+ * @brief Demonstrates inspecting memory footprint and shape of a neural network before using it.
+ *
+ * This function builds a layered network, prints the estimated bytes held by neurons, edges, strategies, hash tables
+ * and propagation workspaces, followed by the shape of the graph. Such a report can be used to size hosts before
+ * loading large models.
+ *
+ * Key Steps:
+ * 1. Network Configuration: Defines a neural network with 4 layers (2 input, 8 and 4 hidden, 1 output neuron).
+ * 2. Report: Computes the report with NNetwork::Report.
+ * 3. Display: Prints the memory breakdown and the whole report as JSON.
+ */
+void exampleReport()
+{
+    printf("%s\n", __FUNCTION__);
+
+    // Create network with 4 layers -> 2 input, 8 hidden, 4 hidden, 1 output
+    auto fnn = fnn::NNetwork({ 2, 8, 4, 1 });
+    fnn.m_network->MapFunction<fnn::ReLUStrategy>();
+
+    const auto report = fnn.Report();
+
+    // Display memory breakdown
+    printf("Total: %zu B, neurons: %zu B, edges: %zu B, strategies: %zu B in %zu instances\n",
+        report.m_memory.TotalBytes(), report.m_memory.m_neuronBytes, report.m_memory.m_edgeBytes,
+        report.m_memory.m_strategyBytes, report.m_memory.m_strategyInstances);
+
+    // Display complete report
+    printf("%s", report.ToJson().c_str());
+}
@@ -0,0 +1,59 @@
+project "Bench"
+   kind "ConsoleApp"
+   language "C++"
+   cppdialect "C++latest"
+   targetdir "Binaries/%{cfg.buildcfg}"
+   staticruntime "off"
+
+   files { "Source/**.h", "Source/**.c", "Source/**.hpp", "Source/**.cpp" }
+
+   includedirs
+   {
+      -- Include FNN
+      "../FNN/Source/Activation",
+      "../FNN/Source/Edge",
+      "../FNN/Source/Neuron",
+      "../FNN/Source/NNetwork",
+      "../FNN/Source/Random",
+      "../FNN/Source/Statistics",
+
+      -- Include Harness, Suites and Topologies
+      "Source/Harness",
+      "Source/Suites",
+      "Source/Topology",
+
+      -- Include Self
+      "Source"
+   }
+
+   links
+   {
+      "FNN"
+   }
+
+   targetdir ("../Binaries/" .. OutputDir .. "/%{prj.name}")
+   objdir ("../Binaries/Intermediates/" .. OutputDir .. "/%{prj.name}")
+
+   filter "system:windows"
+       systemversion "latest"
+       defines { "WINDOWS" }
+
+   filter "system:linux"
+       links { "pthread" }
+
+   filter "configurations:Debug"
+       defines { "DEBUG" }
+       runtime "Debug"
+       symbols "On"
+
+   filter "configurations:Release"
+       defines { "RELEASE" }
+       runtime "Release"
+       optimize "On"
+       symbols "On"
+
+   filter "configurations:Dist"
+       defines { "DIST" }
+       runtime "Release"
+       optimize "On"
+       symbols "Off"
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "BenchHarness.hpp"
+#include "Tracer.hpp"
+#include "Suites/ActivationBench.hpp"
+#include "Suites/MicroBench.hpp"
+#include "Suites/ScalingBench.hpp"
+
+namespace
+{
+    /**
+     * @brief Prints command line usage
+     * @param program [in] Name of the executable
+     */
+    void printUsage(const char *program)
+    {
+        printf("Usage: %s [options]\n", program);
+        printf("  --suite=<activation|micro|scaling|all>  Suite to run, default all\n");
+        printf("  --format=<json|csv>             Result format, default json\n");
+        printf("  --output=<path>                 Write results to file instead of stdout\n");
+        printf("  --baseline=<path>               Compare against results of an earlier run\n");
+        printf("  --threshold=<fraction>          Allowed slowdown against baseline, default 0.10\n");
+        printf("  --min-time=<seconds>            Minimal measured time per case, default 0.2\n");
+        printf("  --max-edges=<count>             Largest graph of scaling suite, default 1000000\n");
+        printf("  --threads=<count>               Largest thread count of scaling suite, default all cores\n");
+        printf("  --quick                         Reduced parameter matrix for smoke runs\n");
+        printf("  --perf-counters                 Collect hardware performance counters, Linux only\n");
+        printf("  --trace=<path>                  Write Chrome trace of the run, needs build with tracing\n");
+    }
+
+    /**
+     * @brief Parses command line into options
+     * @param argc [in] Number of arguments
+     * @param argv [in] Arguments
+     * @param options [out] Parsed options
+     * @return True if all arguments were understood, false otherwise
+     */
+    bool parseOptions(const int argc, char **argv, fnn::bench::BenchOptions &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string argument = argv[i];
+            const size_t separator = argument.find('=');
+            const std::string key = argument.substr(0, separator);
+            const std::string value = separator == std::string::npos ? "" : argument.substr(separator + 1);
+
+            if (key == "--suite")
+            {
+                options.m_suite = value;
+            }
+            else if (key == "--format" && (value == "json" || value == "csv"))
+            {
+                options.m_format = value;
+            }
+            else if (key == "--output")
+            {
+                options.m_outputPath = value;
+            }
+            else if (key == "--baseline")
+            {
+                options.m_baselinePath = value;
+            }
+            else if (key == "--threshold")
+            {
+                options.m_threshold = std::strtod(value.c_str(), nullptr);
+            }
+            else if (key == "--min-time")
+            {
+                options.m_minTime = std::strtod(value.c_str(), nullptr);
+            }
+            else if (key == "--max-edges")
+            {
+                options.m_maxEdges = std::strtoull(value.c_str(), nullptr, 10);
+            }
+            else if (key == "--threads")
+            {
+                options.m_maxThreads = std::strtoull(value.c_str(), nullptr, 10);
+            }
+            else if (key == "--quick")
+            {
+                options.m_quick = true;
+                options.m_minTime = 0.02;
+                options.m_maxEdges = 10000;
+            }
+            else if (key == "--perf-counters")
+            {
+                options.m_perfCounters = true;
+            }
+            else if (key == "--trace" && ! value.empty())
+            {
+                options.m_tracePath = value;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    fnn::bench::BenchOptions options;
+    options.m_maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (! parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    fnn::bench::BenchHarness harness(options);
+
+    if (! options.m_tracePath.empty())
+    {
+        if (! fnn::TRACING_ENABLED)
+        {
+            fprintf(stderr, "FNN was built without tracing, trace will contain no events\n");
+        }
+        fnn::Tracer::Start();
+    }
+
+    const bool runAll = options.m_suite == "all";
+    if (runAll || options.m_suite == "activation")
+    {
+        activationBenchmark(harness);
+    }
+    if (runAll || options.m_suite == "micro")
+    {
+        microBenchmark(harness);
+    }
+    if (runAll || options.m_suite == "scaling")
+    {
+        scalingBenchmark(harness);
+    }
+
+    if (! options.m_tracePath.empty())
+    {
+        fnn::Tracer::Stop();
+        if (! fnn::Tracer::WriteChromeTrace(options.m_tracePath))
+        {
+            fprintf(stderr, "Cannot write trace to %s\n", options.m_tracePath.c_str());
+            return 2;
+        }
+        if (fnn::Tracer::DroppedEvents() > 0)
+        {
+            fprintf(stderr, "Trace buffers were full, %zu events dropped\n", fnn::Tracer::DroppedEvents());
+        }
+    }
+
+    if (! harness.WriteResults())
+    {
+        fprintf(stderr, "Cannot write results to %s\n", options.m_outputPath.c_str());
+        return 2;
+    }
+
+    // Non zero exit code lets scripts fail on performance regressions and on equivalent paths that stopped agreeing
+    const bool isMatched = harness.ReportMismatches();
+    const bool isWithinThreshold = harness.CompareWithBaseline();
+    return isMatched && isWithinThreshold ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+#include "BenchHarness.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+using namespace fnn::bench;
+
+namespace
+{
+    /**
+     * @brief Escapes characters that cannot appear verbatim inside JSON string
+     * @param text [in] Text to escape
+     * @return Escaped text
+     */
+    std::string escapeJson(const std::string &text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (const char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    /**
+     * @brief Finds value of a "key": value pair on a single JSON line
+     * @param line [in] Line to search
+     * @param key [in] Key to look for
+     * @param value [out] Raw value, quotes removed for strings
+     * @return True if key was found, false otherwise
+     */
+    bool findJsonValue(const std::string &line, const std::string &key, std::string &value)
+    {
+        const std::string pattern = "\"" + key + "\":";
+        const size_t keyPosition = line.find(pattern);
+        if (keyPosition == std::string::npos)
+        {
+            return false;
+        }
+
+        size_t begin = line.find_first_not_of(' ', keyPosition + pattern.size());
+        if (begin == std::string::npos)
+        {
+            return false;
+        }
+
+        size_t end = 0;
+        if (line[begin] == '"')
+        {
+            ++begin;
+            end = line.find('"', begin);
+        }
+        else
+        {
+            end = line.find_first_of(",}", begin);
+        }
+
+        if (end == std::string::npos)
+        {
+            return false;
+        }
+        value = line.substr(begin, end - begin);
+        return true;
+    }
+}
+
+BenchHarness::BenchHarness(const BenchOptions &options)
+    : m_options(options)
+{
+    if (! m_options.m_perfCounters)
+    {
+        return;
+    }
+
+    m_perfCounters = std::make_unique<PerfCounters>();
+    if (! m_perfCounters->IsAvailable())
+    {
+        // Typical inside containers or with perf_event_paranoid above 2, results stay valid without counters
+        fprintf(stderr, "Hardware performance counters are not available, continuing without them\n");
+        m_perfCounters.reset();
+        return;
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(PerfCounter::Count); ++i)
+    {
+        const auto counter = static_cast<PerfCounter>(i);
+        if (! m_perfCounters->IsAvailable(counter))
+        {
+            fprintf(stderr, "Hardware performance counter %s is not available\n", perfCounterToString(counter).c_str());
+        }
+    }
+}
+
+const BenchOptions &BenchHarness::Options() const
+{
+    return m_options;
+}
+
+const std::vector<BenchResult> &BenchHarness::Results() const
+{
+    return m_results;
+}
+
+BenchResult &BenchHarness::Record(BenchResult result)
+{
+    // Progress goes to stderr, stdout is reserved for results when no output file is given
+    fprintf(stderr, "%-10s %-48s %14.1f ns %16.1f items/s\n",
+        result.m_suite.c_str(), result.m_name.c_str(), result.m_nsPerIteration, result.m_itemsPerSecond);
+
+    m_results.push_back(std::move(result));
+    return m_results.back();
+}
+
+bool BenchHarness::WriteResults() const
+{
+    const std::string document = m_options.m_format == "csv" ? ToCsv() : ToJson();
+
+    if (m_options.m_outputPath.empty())
+    {
+        std::cout << document;
+        return true;
+    }
+
+    std::ofstream file(m_options.m_outputPath);
+    if (! file)
+    {
+        return false;
+    }
+    file << document;
+    return static_cast<bool>(file);
+}
+
+bool BenchHarness::CompareWithBaseline() const
+{
+    if (m_options.m_baselinePath.empty())
+    {
+        return true;
+    }
+
+    std::vector<std::pair<std::string, double>> baseline;
+    if (! ReadBaseline(m_options.m_baselinePath, baseline))
+    {
+        fprintf(stderr, "Cannot read baseline %s\n", m_options.m_baselinePath.c_str());
+        return false;
+    }
+
+    std::unordered_map<std::string, double> baselineTimes(baseline.begin(), baseline.end());
+
+    size_t regressions = 0;
+    fprintf(stderr, "\n%-48s %14s %14s %9s\n", "Case", "Baseline ns", "Current ns", "Change");
+    for (const auto &result : m_results)
+    {
+        const auto it = baselineTimes.find(result.m_name);
+        if (it == baselineTimes.end() || it->second <= 0.0)
+        {
+            // New case, nothing to compare with
+            continue;
+        }
+
+        const double change = result.m_nsPerIteration / it->second - 1.0;
+        const bool regressed = change > m_options.m_threshold;
+        regressions += regressed ? 1 : 0;
+
+        fprintf(stderr, "%-48s %14.1f %14.1f %+8.1f%%%s\n",
+            result.m_name.c_str(), it->second, result.m_nsPerIteration, change * 100.0, regressed ? " REGRESSION" : "");
+    }
+
+    fprintf(stderr, "%zu regression(s) beyond %.1f%% threshold\n", regressions, m_options.m_threshold * 100.0);
+    return regressions == 0;
+}
+
+void BenchHarness::AddCounterMetrics(BenchResult &result, const std::string &unit, const double unitsPerIteration)
+{
+    if (unitsPerIteration <= 0.0)
+    {
+        return;
+    }
+
+    for (const auto &[counter, value] : result.m_counters)
+    {
+        result.m_metrics.emplace_back(counter + "_per_" + unit, value / unitsPerIteration);
+    }
+}
+
+void BenchHarness::ExpectMetric(BenchResult &result, const std::string &metric, const double value, const double expected)
+{
+    result.m_metrics.emplace_back(metric, value);
+    if (value != expected)
+    {
+        m_mismatches.push_back(result.m_name + " " + metric + "=" + std::to_string(value) + ", expected " + std::to_string(expected));
+    }
+}
+
+bool BenchHarness::ReportMismatches() const
+{
+    for (const auto &mismatch : m_mismatches)
+    {
+        fprintf(stderr, "MISMATCH %s\n", mismatch.c_str());
+    }
+    return m_mismatches.empty();
+}
+
+std::string BenchHarness::ToJson() const
+{
+    std::ostringstream stream;
+    stream.precision(9);
+
+    stream << "{\n  \"results\": [\n";
+    for (size_t i = 0; i < m_results.size(); ++i)
+    {
+        const auto &result = m_results[i];
+        stream << "    {\"suite\": \"" << escapeJson(result.m_suite)
+               << "\", \"name\": \"" << escapeJson(result.m_name)
+               << "\", \"parameters\": \"" << escapeJson(result.m_parameters)
+               << "\", \"iterations\": " << result.m_iterations
+               << ", \"ns_per_iteration\": " << result.m_nsPerIteration
+               << ", \"items_per_second\": " << result.m_itemsPerSecond
+               << ", \"metrics\": {";
+
+        for (size_t j = 0; j < result.m_metrics.size(); ++j)
+        {
+            stream << (j == 0 ? "" : ", ") << "\"" << escapeJson(result.m_metrics[j].first) << "\": " << result.m_metrics[j].second;
+        }
+        stream << "}}" << (i + 1 < m_results.size() ? "," : "") << "\n";
+    }
+    stream << "  ]\n}\n";
+
+    return stream.str();
+}
+
+std::string BenchHarness::ToCsv() const
+{
+    std::ostringstream stream;
+    stream.precision(9);
+
+    stream << "suite,name,parameters,iterations,ns_per_iteration,items_per_second,metrics\n";
+    for (const auto &result : m_results)
+    {
+        stream << result.m_suite << ","
+               << result.m_name << ","
+               << result.m_parameters << ","
+               << result.m_iterations << ","
+               << result.m_nsPerIteration << ","
+               << result.m_itemsPerSecond << ",";
+
+        for (size_t j = 0; j < result.m_metrics.size(); ++j)
+        {
+            stream << (j == 0 ? "" : ";") << result.m_metrics[j].first << "=" << result.m_metrics[j].second;
+        }
+        stream << "\n";
+    }
+
+    return stream.str();
+}
+
+bool BenchHarness::ReadBaseline(const std::string &path, std::vector<std::pair<std::string, double>> &baseline)
+{
+    std::ifstream file(path);
+    if (! file)
+    {
+        return false;
+    }
+
+    std::string line;
+    bool isJson = false;
+    bool isFirstLine = true;
+    while (std::getline(file, line))
+    {
+        if (isFirstLine)
+        {
+            // JSON documents start with an object, CSV with the header line
+            isJson = line.find('{') != std::string::npos;
+            isFirstLine = false;
+            if (! isJson)
+            {
+                continue;
+            }
+        }
+
+        if (isJson)
+        {
+            std::string name;
+            std::string time;
+            if (findJsonValue(line, "name", name) && findJsonValue(line, "ns_per_iteration", time))
+            {
+                baseline.emplace_back(name, std::strtod(time.c_str(), nullptr));
+            }
+            continue;
+        }
+
+        // suite,name,parameters,iterations,ns_per_iteration,...
+        std::vector<std::string> columns;
+        std::stringstream stream(line);
+        for (std::string column; std::getline(stream, column, ',');)
+        {
+            columns.push_back(column);
+        }
+        if (columns.size() >= 5)
+        {
+            baseline.emplace_back(columns[1], std::strtod(columns[4].c_str(), nullptr));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+namespace fnn::bench
+{
+    /**
+     * @struct BenchOptions
+     * @brief Command line controlled settings of a benchmark run
+     */
+    struct BenchOptions final
+    {
+    public:
+        std::string m_suite = "all"; ///< Suite to run: activation, micro, scaling or all
+        std::string m_format = "json"; ///< Output format of results: json or csv
+        std::string m_outputPath; ///< File the results are written to, stdout when empty
+        std::string m_baselinePath; ///< Results of an earlier run to compare against, no comparison when empty
+        double m_threshold = 0.10; ///< Allowed relative slowdown against baseline before a case counts as regression
+        double m_minTime = 0.2; ///< Minimal measured time per case in seconds
+        size_t m_rounds = 5; ///< Number of measured rounds per case, median round is reported
+        size_t m_maxEdges = 1000000; ///< Largest graph generated by scaling suite, in edges
+        size_t m_maxThreads = 1; ///< Largest thread count measured by scaling suite
+        bool m_quick = false; ///< Runs a reduced parameter matrix
+        std::string m_tracePath; ///< Chrome trace file of the whole run, no tracing when empty
+        bool m_perfCounters = false; ///< Collects hardware performance counters around measured rounds
+    };
+
+    /**
+     * @struct BenchResult
+     * @brief Measurement of a single benchmark case
+     */
+    struct BenchResult final
+    {
+    public:
+        std::string m_suite; ///< Suite the case belongs to
+        std::string m_name; ///< Unique case name, used as key for baseline comparison
+        std::string m_parameters; ///< Human readable case parameters, "key=value;key=value"
+        size_t m_iterations = 0; ///< Iterations per measured round
+        double m_nsPerIteration = 0.0; ///< Median time of one iteration in nanoseconds
+        double m_itemsPerSecond = 0.0; ///< Processed items (samples, edges, evaluations) per second
+        std::vector<std::pair<std::string, double>> m_metrics; ///< Additional case specific metrics
+        std::vector<std::pair<std::string, double>> m_counters; ///< Hardware counter values per iteration, empty when not collected
+    };
+
+    /**
+     * @class BenchHarness
+     * @brief Measures benchmark cases, writes results and compares them against a stored baseline
+     */
+    class BenchHarness final
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param options [in] Settings of the run
+         */
+        explicit BenchHarness(const BenchOptions &options);
+
+        /**
+         * @brief Returns settings of the run
+         * @return Options the harness was created with
+         */
+        const BenchOptions &Options() const;
+
+        /**
+         * @brief Returns all results measured so far
+         * @return Measured results in order of measurement
+         */
+        const std::vector<BenchResult> &Results() const;
+
+        /**
+         * @brief Measures a case and records its result
+         *
+         * Iteration count is calibrated so a round takes at least m_minTime / m_rounds,
+         * reported time is the median of m_rounds rounds
+         * @param suite [in] Suite the case belongs to
+         * @param name [in] Unique case name
+         * @param parameters [in] Case parameters, "key=value;key=value"
+         * @param itemsPerIteration [in] Items processed by single call of function
+         * @param function [in] Measured function
+         * @return Reference to the recorded result, valid until the next measurement
+         */
+        template <typename Function>
+        BenchResult &Measure(const std::string &suite, const std::string &name, const std::string &parameters, const double itemsPerIteration, Function &&function);
+
+        /**
+         * @brief Records a result measured outside of Measure
+         * @param result [in] Result to record
+         * @return Reference to the recorded result, valid until the next measurement
+         */
+        BenchResult &Record(BenchResult result);
+
+        /**
+         * @brief Writes results in selected format to selected output
+         * @return True if results were written, false otherwise
+         */
+        bool WriteResults() const;
+
+        /**
+         * @brief Compares results against the baseline file and prints a report
+         * @return True if no case regressed beyond the threshold or no baseline was given, false otherwise
+         */
+        bool CompareWithBaseline() const;
+
+        /**
+         * @brief Adds hardware counter values normalized by a unit of work to result metrics
+         *
+         * Metric names are "<counter>_per_<unit>", nothing is added when counters were not collected
+         * @param result [in, out] Result holding counter values per iteration
+         * @param unit [in] Name of the unit, e.g. "sample" or "edge"
+         * @param unitsPerIteration [in] Units processed by single iteration
+         */
+        static void AddCounterMetrics(BenchResult &result, const std::string &unit, const double unitsPerIteration);
+
+        /**
+         * @brief Adds a metric whose value is known in advance, e.g. zero difference of two equivalent paths
+         *
+         * A value different from the expected one marks the case as mismatched
+         * @param result [in, out] Result the metric is added to
+         * @param metric [in] Name of the metric
+         * @param value [in] Measured value
+         * @param expected [in] Value the case must report
+         */
+        void ExpectMetric(BenchResult &result, const std::string &metric, const double value, const double expected);
+
+        /**
+         * @brief Prints cases whose expected metrics did not match
+         * @return True if every expected metric matched, false otherwise
+         */
+        bool ReportMismatches() const;
+
+    private:
+        BenchOptions m_options; ///< Settings of the run
+        std::vector<BenchResult> m_results; ///< Results measured so far
+        std::unique_ptr<PerfCounters> m_perfCounters; ///< Counters of the measuring thread, nullptr when not collected
+        std::vector<std::string> m_mismatches; ///< Descriptions of expected metrics that did not match
+
+        /**
+         * @brief Serializes results as JSON, one case per line
+         * @return JSON document
+         */
+        std::string ToJson() const;
+
+        /**
+         * @brief Serializes results as CSV with header line
+         * @return CSV document
+         */
+        std::string ToCsv() const;
+
+        /**
+         * @brief Reads case names and times from results written earlier in either format
+         * @param path [in] Path to the results file
+         * @param baseline [out] Pairs of case name and nanoseconds per iteration
+         * @return True if file was read, false otherwise
+         */
+        static bool ReadBaseline(const std::string &path, std::vector<std::pair<std::string, double>> &baseline);
+    };
+
+    template <typename Function>
+    BenchResult &BenchHarness::Measure(const std::string &suite, const std::string &name, const std::string &parameters, const double itemsPerIteration, Function &&function)
+    {
+        using clock = std::chrono::steady_clock;
+
+        const size_t rounds = std::max<size_t>(m_options.m_rounds, 1);
+        const double roundTime = m_options.m_minTime / static_cast<double>(rounds);
+
+        // Warm up caches and calibrate number of iterations per round
+        size_t iterations = 1;
+        while (true)
+        {
+            const auto start = clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                function();
+            }
+            const std::chrono::duration<double> elapsed = clock::now() - start;
+
+            if (elapsed.count() >= roundTime || iterations >= (size_t(1) << 30))
+            {
+                break;
+            }
+            // Aim slightly above the round time, at most 10x growth per step
+            const double scale = elapsed.count() > 0.0 ? roundTime / elapsed.count() * 1.2 : 10.0;
+            iterations = std::max(iterations + 1, static_cast<size_t>(static_cast<double>(iterations) * std::min(scale, 10.0)));
+        }
+
+        std::vector<double> samples;
+        samples.reserve(rounds);
+
+        // Counters only cover the measuring thread and all rounds, overhead of reading them is outside of the rounds
+        if (m_perfCounters != nullptr)
+        {
+            m_perfCounters->Start();
+        }
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            const auto start = clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                function();
+            }
+            const std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+            samples.push_back(elapsed.count() / static_cast<double>(iterations));
+        }
+        std::vector<std::pair<std::string, double>> counters;
+        if (m_perfCounters != nullptr)
+        {
+            counters = m_perfCounters->Stop();
+        }
+
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        const double median = samples[samples.size() / 2];
+
+        BenchResult result;
+        result.m_suite = suite;
+        result.m_name = name;
+        result.m_parameters = parameters;
+        result.m_iterations = iterations;
+        result.m_nsPerIteration = median;
+        result.m_itemsPerSecond = median > 0.0 ? itemsPerIteration * 1.0e9 / median : 0.0;
+
+        double cycles = 0.0;
+        double instructions = 0.0;
+        for (auto &[counter, value] : counters)
+        {
+            value /= static_cast<double>(rounds * iterations);
+            cycles = counter == "cycles" ? value : cycles;
+            instructions = counter == "instructions" ? value : instructions;
+        }
+        result.m_counters = std::move(counters);
+        if (cycles > 0.0 && instructions > 0.0)
+        {
+            result.m_metrics.emplace_back("ipc", instructions / cycles);
+        }
+
+        return Record(std::move(result));
+    }
+}
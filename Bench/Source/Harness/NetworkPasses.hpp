@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "NNetwork.hpp"
+
+namespace fnn::bench
+{
+    /**
+     * @class NetworkPasses
+     * @brief Drives the private validation and propagation passes of NNetwork one by one so they can be measured
+     *
+     * Only the bench is granted this access, library users go through Fit and Predict, which validate the graph and
+     * run the passes in the required order
+     */
+    class NetworkPasses final
+    {
+    public:
+        /**
+         * @brief Runs forward and backward cycle detection as Fit does before training
+         * @param network [in] Network to check
+         * @return True if a cycle is detected, false otherwise
+         */
+        static bool HasCycle(const NNetwork &network)
+        {
+            return network.HasCycleForward() || network.HasCycleBackward();
+        }
+
+        /**
+         * @brief Runs a single forward pass
+         * @param network [in, out] Network to propagate
+         * @param x [in] Single set of input features
+         * @return True if propagation is successful, false otherwise
+         */
+        static bool ForwardPropagate(NNetwork &network, const std::vector<float> &x)
+        {
+            return network.ForwardPropagate(x);
+        }
+
+        /**
+         * @brief Runs a single error pass
+         * @param network [in, out] Network to propagate
+         * @param y [in] Single set of target outputs
+         * @return True if error propagation is successful, false otherwise
+         */
+        static bool BackwardPropagateError(NNetwork &network, const std::vector<float> &y)
+        {
+            return network.BackwardPropagateError(y);
+        }
+
+        /**
+         * @brief Runs a single weight pass
+         * @param network [in, out] Network to update
+         * @return True if weight update is successful, false otherwise
+         */
+        static bool BackwardPropagateWeights(NNetwork &network)
+        {
+            return network.BackwardPropagateWeights();
+        }
+
+        /**
+         * @brief Runs a single fused error and weight pass
+         * @param network [in, out] Network to propagate
+         * @param y [in] Single set of target outputs
+         * @return True if propagation is successful, false otherwise
+         */
+        static bool BackwardPropagate(NNetwork &network, const std::vector<float> &y)
+        {
+            return network.BackwardPropagate(y);
+        }
+    };
+}
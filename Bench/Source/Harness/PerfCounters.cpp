@@ -0,0 +1,163 @@
+#include "PerfCounters.hpp"
+
+#if defined(__linux__)
+    #include <cstring>
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace fnn::bench;
+
+namespace
+{
+#if defined(__linux__)
+    /**
+     * @brief Opens a single disabled counter for the calling thread on any CPU
+     * @param type [in] perf_event_attr type
+     * @param config [in] perf_event_attr config
+     * @return File descriptor, -1 when counter is not available
+     */
+    int openCounter(const uint32_t type, const uint64_t config)
+    {
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        // User space only, allowed with the default perf_event_paranoid level of 2
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+
+    /**
+     * @brief Builds config of a cache counter
+     * @param cache [in] Cache level
+     * @param operation [in] Access type
+     * @param result [in] Access result
+     * @return perf_event_attr config value
+     */
+    constexpr uint64_t cacheConfig(const uint64_t cache, const uint64_t operation, const uint64_t result)
+    {
+        return cache | (operation << 8) | (result << 16);
+    }
+#endif
+}
+
+std::string fnn::bench::perfCounterToString(const PerfCounter counter)
+{
+    switch (counter)
+    {
+        case PerfCounter::Cycles:
+            return "cycles";
+        case PerfCounter::Instructions:
+            return "instructions";
+        case PerfCounter::L1DataMisses:
+            return "l1d_misses";
+        case PerfCounter::LastLevelMisses:
+            return "llc_misses";
+        case PerfCounter::BranchMisses:
+            return "branch_misses";
+        default:
+            return "unknown";
+    }
+}
+
+PerfCounters::PerfCounters()
+{
+    m_descriptors.fill(-1);
+
+#if defined(__linux__)
+    m_descriptors[static_cast<size_t>(PerfCounter::Cycles)] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    m_descriptors[static_cast<size_t>(PerfCounter::Instructions)] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    m_descriptors[static_cast<size_t>(PerfCounter::L1DataMisses)] = openCounter(PERF_TYPE_HW_CACHE,
+        cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    m_descriptors[static_cast<size_t>(PerfCounter::LastLevelMisses)] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    m_descriptors[static_cast<size_t>(PerfCounter::BranchMisses)] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for (const int descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::IsAvailable() const
+{
+    for (size_t i = 0; i < static_cast<size_t>(PerfCounter::Count); ++i)
+    {
+        if (IsAvailable(static_cast<PerfCounter>(i)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PerfCounters::IsAvailable(const PerfCounter counter) const
+{
+    return counter < PerfCounter::Count && m_descriptors[static_cast<size_t>(counter)] >= 0;
+}
+
+void PerfCounters::Start()
+{
+#if defined(__linux__)
+    for (const int descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+std::vector<std::pair<std::string, double>> PerfCounters::Stop()
+{
+    std::vector<std::pair<std::string, double>> values;
+
+#if defined(__linux__)
+    for (const int descriptor : m_descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(PerfCounter::Count); ++i)
+    {
+        if (m_descriptors[i] < 0)
+        {
+            continue;
+        }
+
+        // value, time enabled, time running
+        uint64_t data[3] = {};
+        if (read(m_descriptors[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+
+        // Extrapolate when counter shared the hardware with others
+        const double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        values.emplace_back(perfCounterToString(static_cast<PerfCounter>(i)), static_cast<double>(data[0]) * scale);
+    }
+#endif
+
+    return values;
+}
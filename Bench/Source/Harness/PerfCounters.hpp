@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fnn::bench
+{
+    /**
+     * @enum PerfCounter
+     * @brief Hardware events collected around measured cases
+     */
+    enum class PerfCounter
+    {
+        Cycles, ///< CPU cycles
+        Instructions, ///< Retired instructions
+        L1DataMisses, ///< L1 data cache read misses
+        LastLevelMisses, ///< Last level cache misses
+        BranchMisses, ///< Mispredicted branches
+        Count ///< Number of counters, not a counter
+    };
+
+    /**
+     * @brief Returns metric name of a counter
+     * @param counter [in] Counter to name
+     * @return Name in snake case, e.g. "l1d_misses"
+     */
+    std::string perfCounterToString(const PerfCounter counter);
+
+    /**
+     * @class PerfCounters
+     * @brief Reads hardware performance counters of the calling thread through Linux perf_event_open
+     *
+     * Every counter is opened on its own, so a counter the CPU, kernel or container does not provide only leaves a
+     * gap instead of disabling the rest. Values are scaled by enabled / running time when the kernel multiplexes.
+     * On other platforms, or when perf_event_paranoid forbids user space counting, no counter is available and
+     * measurements simply carry no counter metrics.
+     */
+    class PerfCounters final
+    {
+    public:
+        /**
+         * @brief Opens all counters for the calling thread, counters stay disabled until Start
+         */
+        PerfCounters();
+
+        /**
+         * @brief Closes opened counters
+         */
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters &operator=(const PerfCounters&) = delete;
+
+        /**
+         * @brief Checks whether at least one counter was opened
+         * @return True if any counter can be collected, false otherwise
+         */
+        bool IsAvailable() const;
+
+        /**
+         * @brief Checks whether a particular counter was opened
+         * @param counter [in] Counter to check
+         * @return True if counter can be collected, false otherwise
+         */
+        bool IsAvailable(const PerfCounter counter) const;
+
+        /**
+         * @brief Resets and enables all opened counters
+         */
+        void Start();
+
+        /**
+         * @brief Disables all opened counters and reads their values
+         * @return Pairs of counter name and counted events since Start, unavailable counters are left out
+         */
+        std::vector<std::pair<std::string, double>> Stop();
+
+    private:
+        std::array<int, static_cast<size_t>(PerfCounter::Count)> m_descriptors; ///< File descriptors of counters, -1 when unavailable, indexed by PerfCounter
+    };
+}
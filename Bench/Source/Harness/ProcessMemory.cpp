@@ -0,0 +1,60 @@
+#include "ProcessMemory.hpp"
+
+#if defined(WINDOWS)
+    #include <windows.h>
+    #include <psapi.h>
+#elif defined(__linux__)
+    #include <cstdio>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+size_t fnn::bench::currentResidentBytes()
+{
+#if defined(WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    // Second field of statm is resident pages
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == nullptr)
+    {
+        return 0;
+    }
+
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    const int parsed = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+
+    return parsed == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+size_t fnn::bench::peakResidentBytes()
+{
+#if defined(WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#elif defined(__linux__)
+    // ru_maxrss is reported in kilobytes on Linux
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace fnn::bench
+{
+    /**
+     * @brief Returns resident set size of the current process
+     * @return Resident memory in bytes, 0 when not available on the platform
+     */
+    size_t currentResidentBytes();
+
+    /**
+     * @brief Returns peak resident set size of the current process since its start
+     * @return Peak resident memory in bytes, 0 when not available on the platform
+     */
+    size_t peakResidentBytes();
+}
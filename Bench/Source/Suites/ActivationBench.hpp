@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "BenchHarness.hpp"
+
+/**
+ * @function activationBenchmark
+ * @brief Compares throughput and accuracy of exact and approximate activation strategies.
+ *
+ * Every strategy is evaluated twice over the same input block: element by element through the virtual
+ * Activation call, as the network does per neuron, and through ActivationBatch, as vectorised kernels do.
+ * Accuracy is the maximum absolute difference against the double precision reference over the same inputs,
+ * it is recorded as "max_error" metric next to the documented "bound".
+ *
+ * @param harness Harness measuring and recording the cases.
+ */
+void activationBenchmark(fnn::bench::BenchHarness &harness)
+{
+    struct Candidate
+    {
+        std::string name;
+        std::shared_ptr<fnn::INeuronFunctionStrategy> strategy;
+        double (*reference)(double);
+        float bound;
+    };
+
+    const auto sigmoid = [] (const double x) { return 1.0 / (1.0 + std::exp(-x)); };
+    const auto tanh = [] (const double x) { return std::tanh(x); };
+
+    const std::vector<Candidate> candidates =
+    {
+        { "sigmoid",              std::make_shared<fnn::SigmoidStrategy>(),                                          sigmoid, 0.0f },
+        { "fast-sigmoid/rational", std::make_shared<fnn::FastSigmoidStrategy>(fnn::ApproximationMode::Rational),   sigmoid, fnn::approximation::SIGMOID_RATIONAL_MAX_ERROR },
+        { "fast-sigmoid/lookup",  std::make_shared<fnn::FastSigmoidStrategy>(fnn::ApproximationMode::LookupTable), sigmoid, fnn::approximation::SIGMOID_LOOKUP_MAX_ERROR },
+        { "tanh",                 std::make_shared<fnn::TanhStrategy>(),                                             tanh,    0.0f },
+        { "fast-tanh/rational",   std::make_shared<fnn::FastTanhStrategy>(fnn::ApproximationMode::Rational),       tanh,    fnn::approximation::TANH_RATIONAL_MAX_ERROR },
+        { "fast-tanh/lookup",     std::make_shared<fnn::FastTanhStrategy>(fnn::ApproximationMode::LookupTable),    tanh,    fnn::approximation::TANH_LOOKUP_MAX_ERROR },
+    };
+
+    // Inputs spread evenly over [-16, 16], covering both saturated tails
+    const size_t samples = harness.Options().m_quick ? (1 << 12) : (1 << 16);
+    std::vector<float> inputs(samples);
+    for (size_t i = 0; i < samples; ++i)
+    {
+        inputs[i] = -16.0f + 32.0f * static_cast<float>(i) / static_cast<float>(samples - 1);
+    }
+    std::vector<float> outputs(samples);
+
+    const std::string parameters = "samples=" + std::to_string(samples);
+    for (const auto &candidate : candidates)
+    {
+        harness.Measure("activation", candidate.name + "/scalar", parameters, static_cast<double>(samples), [&] {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                outputs[i] = candidate.strategy->Activation(inputs[i]);
+            }
+        });
+
+        auto &batch = harness.Measure("activation", candidate.name + "/batch", parameters, static_cast<double>(samples), [&] {
+            candidate.strategy->ActivationBatch(inputs, outputs);
+        });
+
+        double maxError = 0.0;
+        for (size_t i = 0; i < samples; ++i)
+        {
+            maxError = std::max(maxError, std::abs(static_cast<double>(outputs[i]) - candidate.reference(inputs[i])));
+        }
+
+        batch.m_metrics.emplace_back("max_error", maxError);
+        batch.m_metrics.emplace_back("bound", candidate.bound);
+    }
+}
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ActivationStrategy.hpp"
+#include "BenchHarness.hpp"
+#include "InferenceSession.hpp"
+#include "NetworkPasses.hpp"
+#include "NNetwork.hpp"
+#include "PopulationTrainer.hpp"
+#include "RandomStrategy.hpp"
+#include "StaticNetwork.hpp"
+#include "Topology/TopologyGenerator.hpp"
+
+/**
+ * @function microStatic
+ * @brief Measures StaticNetwork against NNetwork of the same layer sizes and sigmoid activation.
+ *
+ * @tparam Layers Number of neurons in each layer, input layer first.
+ * @param harness Harness measuring and recording the cases.
+ * @param rows Number of samples in the dataset.
+ * @param seed Seed of the dataset.
+ */
+template <size_t... Layers>
+void microStatic(fnn::bench::BenchHarness &harness, const size_t rows, const uint64_t seed)
+{
+    using StaticNetwork = fnn::StaticNetwork<fnn::SigmoidStrategy, Layers...>;
+
+    std::string shape;
+    ((shape += (shape.empty() ? "" : "-") + std::to_string(Layers)), ...);
+    const std::string parameters = "layers=" + shape;
+    const std::string name = "/" + shape;
+
+    const auto trainX = fnn::bench::randomRows(rows, StaticNetwork::INPUTS, seed + 1);
+    const auto trainY = fnn::bench::randomRows(rows, StaticNetwork::OUTPUTS, seed + 2);
+
+    // Both networks start from the same weights
+    const auto makePair = [&]
+    {
+        auto dynamic = fnn::NNetwork({ Layers... });
+        dynamic.m_network->MapFunction<fnn::SigmoidStrategy>();
+        StaticNetwork fixed;
+        fixed.Import(*dynamic.m_network);
+        return std::make_pair(std::move(dynamic), fixed);
+    };
+
+    auto [dynamic, fixed] = makePair();
+    std::vector<std::vector<float>> output;
+    harness.Measure("micro", "predict-dynamic" + name, parameters, static_cast<double>(rows), [&] {
+        dynamic.Predict(trainX, output);
+    });
+    harness.Measure("micro", "predict-static" + name, parameters, static_cast<double>(rows), [&] {
+        fixed.Predict(trainX, output);
+    });
+    harness.Measure("micro", "fit-dynamic" + name, parameters, static_cast<double>(rows), [&] {
+        dynamic.Fit(trainX, trainY, 1);
+    });
+    auto &staticFit = harness.Measure("micro", "fit-static" + name, parameters, static_cast<double>(rows), [&] {
+        fixed.Fit(trainX, trainY, 1);
+    });
+
+    // Fresh pair trained for one epoch each way must predict the same
+    auto [dynamicCheck, fixedCheck] = makePair();
+    std::vector<std::vector<float>> expected;
+    std::vector<std::vector<float>> actual;
+    const bool trained = dynamicCheck.Fit(trainX, trainY, 1) && fixedCheck.Fit(trainX, trainY, 1) &&
+                         dynamicCheck.Predict(trainX, expected) && fixedCheck.Predict(trainX, actual);
+
+    double difference = trained ? 0.0 : std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < expected.size() && i < actual.size(); ++i)
+    {
+        for (size_t j = 0; j < expected[i].size() && j < actual[i].size(); ++j)
+        {
+            difference = std::max(difference, static_cast<double>(std::abs(expected[i][j] - actual[i][j])));
+        }
+    }
+    harness.ExpectMetric(staticFit, "max_abs_difference", difference, 0.0);
+}
+
+/**
+ * @function microBenchmark
+ * @brief Measures every phase of training and prediction across a matrix of layered network shapes.
+ *
+ * For each combination of layer width, number of hidden layers and connection density a layered network is generated
+ * with a fixed seed, so consecutive runs measure identical networks and can be compared against a stored baseline.
+ *
+ * Measured phases:
+ * 1. construct: Building the network through the public NGraph API, items are edges.
+ * 2. validate: Forward and backward cycle detection done by Fit before training, items are edges.
+ * 3. forward: Single ForwardPropagate call, items are samples.
+ * 4. backward-error: Single BackwardPropagateError call, items are samples.
+ * 5. weight-update, backward: Single BackwardPropagateWeights call and single BackwardPropagate call, which fuses
+ *    both passes, items are samples. The backward case reports its speedup over backward-error and weight-update together.
+ * 6. predict: Predict over the whole dataset, items are samples.
+ * 7. predict-cached: Predict over the dataset repeated four times with a prediction cache of dataset size, items are
+ *    samples; reports hit rate and the largest difference to uncached Predict after a training step invalidated the cache.
+ * 8. predict-cone: Predict of the first output only, items are samples; reports the largest difference to Predict.
+ * 9. session-update, session-update-delta: InferenceSession Update changing a single input in exact and delta mode,
+ *    items are updates; reports the fraction of neurons recomputed and the largest difference to Predict, which is
+ *    zero in exact mode and at rounding level in delta mode.
+ * 10. fit: Fit for single epoch over the whole dataset, items are samples.
+ * 11. fit-relu, fit-relu-sparse: Fit with ReLUStrategy in dense and sparse propagation mode, items are samples. The sparse
+ *     case reports skipped fractions and the largest prediction difference to the dense case, which is zero.
+ * 12. fit-sequential, fit-population: One epoch of Fit for 16 networks of equal topology with different weights and
+ *     learning rates, one after another and in lockstep through PopulationTrainer, items are member samples. The
+ *     population case reports the largest prediction difference to sequential Fit.
+ * 13. predict-dynamic, predict-static, fit-dynamic, fit-static: Predict and single epoch Fit of small fixed shapes
+ *     through NNetwork and through StaticNetwork holding the same weights, items are samples. The static fit case
+ *     reports the largest prediction difference to NNetwork after both trained one epoch.
+ * 14. random-get, random-fill, random-counter-fill: Initializing 2^20 weights with FastRandomStrategy one virtual
+ *     GetWeight call at a time, with FastRandomStrategy::Fill and with CounterRandomStrategy::Fill, items are weights.
+ *     The counter case reports whether the filled weights equal drawing them one by one.
+ *
+ * Differences of cases 7, 8, 11, 12, 13, exact session-update and the counter flag of case 14 are expected metrics,
+ * any other value fails the run.
+ *
+ * With hardware counters enabled the forward, backward-error, weight-update and backward cases report every counter normalized
+ * per sample and per edge, e.g. "cycles_per_edge" or "llc_misses_per_sample".
+ *
+ * @param harness Harness measuring and recording the cases.
+ */
+void microBenchmark(fnn::bench::BenchHarness &harness)
+{
+    const bool quick = harness.Options().m_quick;
+
+    const std::vector<size_t> widths = quick ? std::vector<size_t>{ 8, 32 } : std::vector<size_t>{ 8, 32, 128 };
+    const std::vector<size_t> depths = quick ? std::vector<size_t>{ 1, 2 } : std::vector<size_t>{ 1, 2, 4 };
+    const std::vector<float> densities = { 0.25f, 1.0f };
+    const size_t rows = quick ? 16 : 64;
+    const uint64_t seed = 42;
+
+    for (const size_t width : widths)
+    {
+        for (const size_t depth : depths)
+        {
+            for (const float density : densities)
+            {
+                // Input, depth hidden layers and output, all of the same width
+                const std::vector<size_t> layerSizes(depth + 2, width);
+
+                char parameters[96];
+                snprintf(parameters, sizeof(parameters), "width=%zu;depth=%zu;density=%.2f", width, depth, density);
+                char suffix[64];
+                snprintf(suffix, sizeof(suffix), "/w%zu/d%zu/p%.2f", width, depth, density);
+                const std::string name = suffix;
+
+                auto network = fnn::bench::buildLayered(layerSizes, density, seed);
+                const double edges = static_cast<double>(fnn::bench::countEdges(network));
+
+                const auto trainX = fnn::bench::randomRows(rows, width, seed + 1);
+                const auto trainY = fnn::bench::randomRows(rows, width, seed + 2);
+
+                harness.Measure("micro", "construct" + name, parameters, edges, [&] {
+                    auto built = fnn::bench::buildLayered(layerSizes, density, seed);
+                }).m_metrics.emplace_back("edges", edges);
+
+                harness.Measure("micro", "validate" + name, parameters, edges, [&] {
+                    const bool hasCycle = fnn::bench::NetworkPasses::HasCycle(network);
+                    (void)hasCycle;
+                });
+
+                size_t row = 0;
+                auto &forward = harness.Measure("micro", "forward" + name, parameters, 1.0, [&] {
+                    fnn::bench::NetworkPasses::ForwardPropagate(network, trainX[row++ % rows]);
+                });
+                fnn::bench::BenchHarness::AddCounterMetrics(forward, "sample", 1.0);
+                fnn::bench::BenchHarness::AddCounterMetrics(forward, "edge", edges);
+
+                auto &backwardError = harness.Measure("micro", "backward-error" + name, parameters, 1.0, [&] {
+                    fnn::bench::NetworkPasses::BackwardPropagateError(network, trainY[row++ % rows]);
+                });
+                fnn::bench::BenchHarness::AddCounterMetrics(backwardError, "sample", 1.0);
+                fnn::bench::BenchHarness::AddCounterMetrics(backwardError, "edge", edges);
+
+                auto &weightUpdate = harness.Measure("micro", "weight-update" + name, parameters, 1.0, [&] {
+                    fnn::bench::NetworkPasses::BackwardPropagateWeights(network);
+                });
+                fnn::bench::BenchHarness::AddCounterMetrics(weightUpdate, "sample", 1.0);
+                fnn::bench::BenchHarness::AddCounterMetrics(weightUpdate, "edge", edges);
+
+                // Both passes one after another take the sum of their times per sample
+                const double separateNs = backwardError.m_nsPerIteration + weightUpdate.m_nsPerIteration;
+                auto &backward = harness.Measure("micro", "backward" + name, parameters, 1.0, [&] {
+                    fnn::bench::NetworkPasses::BackwardPropagate(network, trainY[row++ % rows]);
+                });
+                backward.m_metrics.emplace_back("speedup", backward.m_nsPerIteration > 0.0 ? separateNs / backward.m_nsPerIteration : 0.0);
+                fnn::bench::BenchHarness::AddCounterMetrics(backward, "sample", 1.0);
+                fnn::bench::BenchHarness::AddCounterMetrics(backward, "edge", edges);
+
+                std::vector<std::vector<float>> output;
+                harness.Measure("micro", "predict" + name, parameters, static_cast<double>(rows), [&] {
+                    network.Predict(trainX, output);
+                });
+
+                // Four passes over the dataset, so after the first pass every row repeats
+                std::vector<std::vector<float>> repeatedX;
+                for (size_t pass = 0; pass < 4; ++pass)
+                {
+                    repeatedX.insert(repeatedX.end(), trainX.begin(), trainX.end());
+                }
+                std::vector<std::vector<float>> cachedOutput;
+                network.SetPredictionCache(rows);
+                auto &cached = harness.Measure("micro", "predict-cached" + name, parameters, static_cast<double>(repeatedX.size()), [&] {
+                    network.Predict(repeatedX, cachedOutput);
+                });
+                const auto cacheCounters = network.GetPredictionCacheCounters();
+
+                // One training step must invalidate the cache, cached and uncached prediction then have to agree
+                network.Fit({ trainX.front() }, { trainY.front() }, 1);
+                network.Predict(trainX, cachedOutput);
+                network.SetPredictionCache(0);
+                network.Predict(trainX, output);
+
+                double cachedDifference = 0.0;
+                for (size_t i = 0; i < output.size() && i < cachedOutput.size(); ++i)
+                {
+                    for (size_t j = 0; j < output[i].size() && j < cachedOutput[i].size(); ++j)
+                    {
+                        cachedDifference = std::max(cachedDifference, static_cast<double>(std::abs(output[i][j] - cachedOutput[i][j])));
+                    }
+                }
+                const double lookups = static_cast<double>(cacheCounters.m_hits + cacheCounters.m_misses);
+                cached.m_metrics.emplace_back("hit_rate", lookups == 0.0 ? 0.0 : static_cast<double>(cacheCounters.m_hits) / lookups);
+                harness.ExpectMetric(cached, "max_abs_difference", cachedDifference, 0.0);
+
+                const std::vector<size_t> firstOutput = { network.m_network->m_outputs.front() };
+                std::vector<std::vector<float>> coneOutput;
+                auto &cone = harness.Measure("micro", "predict-cone" + name, parameters, static_cast<double>(rows), [&] {
+                    network.Predict(trainX, firstOutput, coneOutput);
+                });
+                network.Predict(trainX, output);
+
+                double coneDifference = 0.0;
+                for (size_t i = 0; i < output.size() && i < coneOutput.size(); ++i)
+                {
+                    coneDifference = std::max(coneDifference, static_cast<double>(std::abs(output[i].front() - coneOutput[i].front())));
+                }
+                harness.ExpectMetric(cone, "max_abs_difference", coneDifference, 0.0);
+
+                // Sessions on a fresh network, the shared one above has been trained by weight-update
+                for (const auto mode : { fnn::SessionUpdate::Exact, fnn::SessionUpdate::Delta })
+                {
+                    auto streamed = fnn::bench::buildLayered(layerSizes, density, seed);
+                    fnn::InferenceSession session(streamed, mode);
+                    std::vector<float> current = trainX.front();
+                    session.Reset(current);
+
+                    size_t update = 0;
+                    size_t recomputed = 0;
+                    const std::string caseName = mode == fnn::SessionUpdate::Exact ? "session-update" : "session-update-delta";
+                    auto &sessionCase = harness.Measure("micro", caseName + name, parameters, 1.0, [&] {
+                        // Row advances once all inputs of the previous row were streamed, so every update changes a value
+                        const size_t input = update % width;
+                        const size_t source = (update / width + 1) % rows;
+                        session.Update({ input }, { trainX[source][input] });
+                        ++update;
+                        recomputed += session.LastRecomputed();
+                    });
+
+                    // Replay single input changes against full prediction on an identical network
+                    auto reference = fnn::bench::buildLayered(layerSizes, density, seed);
+                    session.Reset(current);
+                    double sessionDifference = 0.0;
+                    for (size_t i = 0; i < rows * width; ++i)
+                    {
+                        const size_t input = i % width;
+                        current[input] = trainX[(i / width + 1) % rows][input];
+                        session.Update({ input }, { current[input] });
+
+                        std::vector<std::vector<float>> expected;
+                        reference.Predict({ current }, expected);
+                        for (size_t j = 0; j < expected.front().size(); ++j)
+                        {
+                            sessionDifference = std::max(sessionDifference, static_cast<double>(std::abs(expected.front()[j] - session.Outputs()[j])));
+                        }
+                    }
+
+                    const double neurons = static_cast<double>(streamed.m_network->Size() - width);
+                    sessionCase.m_metrics.emplace_back("recomputed_fraction", update == 0 ? 0.0 : static_cast<double>(recomputed) / (static_cast<double>(update) * neurons));
+                    if (mode == fnn::SessionUpdate::Exact)
+                    {
+                        harness.ExpectMetric(sessionCase, "max_abs_difference", sessionDifference, 0.0);
+                    }
+                    else
+                    {
+                        // Reset and refreshed sums are exact, sums moved by deltas carry rounding error
+                        sessionCase.m_metrics.emplace_back("max_abs_difference", sessionDifference);
+                    }
+                }
+
+                harness.Measure("micro", "fit" + name, parameters, static_cast<double>(rows), [&] {
+                    network.Fit(trainX, trainY, 1);
+                });
+
+                // Identical ReLU networks differing only in propagation mode
+                auto dense = fnn::bench::buildLayered(layerSizes, density, seed);
+                auto sparse = fnn::bench::buildLayered(layerSizes, density, seed);
+                dense.m_network->MapFunction<fnn::ReLUStrategy>();
+                sparse.m_network->MapFunction<fnn::ReLUStrategy>();
+                sparse.SetPropagationMode(fnn::PropagationMode::Sparse);
+
+                harness.Measure("micro", "fit-relu" + name, parameters, static_cast<double>(rows), [&] {
+                    dense.Fit(trainX, trainY, 1);
+                });
+                sparse.ResetSparsityCounters();
+                auto &sparseFit = harness.Measure("micro", "fit-relu-sparse" + name, parameters, static_cast<double>(rows), [&] {
+                    sparse.Fit(trainX, trainY, 1);
+                });
+
+                // Both networks ran a different number of epochs, compare them after one fresh epoch each
+                auto denseCheck = fnn::bench::buildLayered(layerSizes, density, seed);
+                auto sparseCheck = fnn::bench::buildLayered(layerSizes, density, seed);
+                denseCheck.m_network->MapFunction<fnn::ReLUStrategy>();
+                sparseCheck.m_network->MapFunction<fnn::ReLUStrategy>();
+                sparseCheck.SetPropagationMode(fnn::PropagationMode::Sparse);
+                denseCheck.Fit(trainX, trainY, 1);
+                sparseCheck.Fit(trainX, trainY, 1);
+
+                std::vector<std::vector<float>> denseOutput;
+                std::vector<std::vector<float>> sparseOutput;
+                denseCheck.Predict(trainX, denseOutput);
+                sparseCheck.Predict(trainX, sparseOutput);
+
+                double maxDifference = 0.0;
+                for (size_t i = 0; i < denseOutput.size() && i < sparseOutput.size(); ++i)
+                {
+                    for (size_t j = 0; j < denseOutput[i].size() && j < sparseOutput[i].size(); ++j)
+                    {
+                        maxDifference = std::max(maxDifference, static_cast<double>(std::abs(denseOutput[i][j] - sparseOutput[i][j])));
+                    }
+                }
+
+                const auto counters = sparse.GetSparsityCounters();
+                sparseFit.m_metrics = {
+                    { "value_edges_skipped", fnn::SparsityCounters::Fraction(counters.m_valueEdgesSkipped, counters.m_valueEdges) },
+                    { "error_neurons_skipped", fnn::SparsityCounters::Fraction(counters.m_errorNeuronsSkipped, counters.m_errorNeurons) },
+                    { "weight_edges_skipped", fnn::SparsityCounters::Fraction(counters.m_weightEdgesSkipped, counters.m_weightEdges) },
+                };
+                harness.ExpectMetric(sparseFit, "max_abs_difference", maxDifference, 0.0);
+
+                // Population of identical topology, members differ in weights and learning rate
+                const size_t members = 16;
+                const auto makePopulation = [&]
+                {
+                    std::vector<fnn::NNetwork> population;
+                    for (size_t member = 0; member < members; ++member)
+                    {
+                        auto memberNetwork = fnn::bench::buildLayered(layerSizes, density, seed);
+                        std::mt19937_64 engine(seed * 31 + member);
+                        std::uniform_real_distribution<float> weight(0.0f, 1.0f);
+                        for (const auto &neuron : memberNetwork.m_network->Neurons())
+                        {
+                            if (neuron->m_headConnections.has_value())
+                            {
+                                for (auto &headEdge : neuron->m_headConnections.value())
+                                {
+                                    headEdge.m_weight = weight(engine);
+                                }
+                            }
+                        }
+                        memberNetwork.m_network->MapLearningRate(0.001f * static_cast<float>(member + 1));
+                        population.push_back(std::move(memberNetwork));
+                    }
+                    return population;
+                };
+
+                const double memberSamples = static_cast<double>(rows * members);
+                auto sequential = makePopulation();
+                harness.Measure("micro", "fit-sequential" + name, parameters, memberSamples, [&] {
+                    for (auto &member : sequential)
+                    {
+                        member.Fit(trainX, trainY, 1);
+                    }
+                });
+
+                auto lockstep = makePopulation();
+                fnn::PopulationTrainer trainer;
+                trainer.Load(lockstep);
+                auto &population = harness.Measure("micro", "fit-population" + name, parameters, memberSamples, [&] {
+                    trainer.Fit(trainX, trainY, 1);
+                });
+
+                // Fresh populations trained for one epoch each way must predict the same
+                auto sequentialCheck = makePopulation();
+                auto lockstepCheck = makePopulation();
+                for (auto &member : sequentialCheck)
+                {
+                    member.Fit(trainX, trainY, 1);
+                }
+                fnn::PopulationTrainer checkTrainer;
+                const bool loaded = checkTrainer.Load(lockstepCheck) && checkTrainer.Fit(trainX, trainY, 1) && checkTrainer.Store(lockstepCheck);
+
+                double populationDifference = loaded ? 0.0 : std::numeric_limits<double>::infinity();
+                for (size_t member = 0; member < members && loaded; ++member)
+                {
+                    std::vector<std::vector<float>> expected;
+                    std::vector<std::vector<float>> actual;
+                    sequentialCheck[member].Predict(trainX, expected);
+                    lockstepCheck[member].Predict(trainX, actual);
+                    for (size_t i = 0; i < expected.size() && i < actual.size(); ++i)
+                    {
+                        for (size_t j = 0; j < expected[i].size() && j < actual[i].size(); ++j)
+                        {
+                            populationDifference = std::max(populationDifference, static_cast<double>(std::abs(expected[i][j] - actual[i][j])));
+                        }
+                    }
+                }
+                population.m_metrics.emplace_back("members", static_cast<double>(members));
+                harness.ExpectMetric(population, "max_abs_difference", populationDifference, 0.0);
+            }
+        }
+    }
+
+    microStatic<2, 4, 1>(harness, rows, seed);
+    microStatic<8, 16, 16, 4>(harness, rows, seed);
+
+    // Weight initialization of a large graph, the strategy is reached through the interface as NGraph does
+    std::vector<float> weights(size_t(1) << 20);
+    const std::string randomParameters = "weights=" + std::to_string(weights.size());
+    const std::shared_ptr<fnn::IRandomStrategy> fast = std::make_shared<fnn::FastRandomStrategy>();
+    const std::shared_ptr<fnn::IRandomStrategy> counter = std::make_shared<fnn::CounterRandomStrategy>(seed);
+    harness.Measure("micro", "random-get", randomParameters, static_cast<double>(weights.size()), [&] {
+        for (float &weight : weights)
+        {
+            weight = fast->GetWeight(0.0f, 1.0f);
+        }
+    });
+    harness.Measure("micro", "random-fill", randomParameters, static_cast<double>(weights.size()), [&] {
+        fast->Fill(weights, 0.0f, 1.0f);
+    });
+    auto &counterFill = harness.Measure("micro", "random-counter-fill", randomParameters, static_cast<double>(weights.size()), [&] {
+        counter->Fill(weights, 0.0f, 1.0f);
+    });
+
+    fnn::CounterRandomStrategy filled(seed);
+    fnn::CounterRandomStrategy drawn(seed);
+    filled.Fill(weights, 0.0f, 1.0f);
+    const bool isIdentical = std::ranges::all_of(weights, [&drawn](const float weight) { return weight == drawn.GetWeight(0.0f, 1.0f); });
+    harness.ExpectMetric(counterFill, "identical_to_get", isIdentical ? 1.0 : 0.0, 1.0);
+}
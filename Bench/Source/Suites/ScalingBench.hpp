@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.hpp"
+#include "InferencePipeline.hpp"
+#include "NModel.hpp"
+#include "NNetwork.hpp"
+#include "ProcessMemory.hpp"
+#include "Topology/TopologyGenerator.hpp"
+
+/**
+ * @function scalingBenchmark
+ * @brief Records how build time, memory and throughput grow with graph size and thread count.
+ *
+ * Graph sizes grow tenfold from 10^4 edges up to BenchOptions::m_maxEdges, every size is generated for each synthetic
+ * topology family. Sizes are the outer loop so peak resident memory only grows together with the graph size.
+ *
+ * Recorded cases:
+ * 1. build/<kind>/e<edges>: Time to generate the graph, items are edges, metrics hold actual edge and neuron count,
+ *    resident memory growth caused by the graph next to the estimate of NNetwork::Report and peak resident memory.
+ * 2. predict/<kind>/e<edges>/t<threads>: Predict throughput, items are samples. NNetwork is not reentrant, so every
+ *    thread predicts on its own replica; thread counts are only measured while replicas fit into m_maxEdges in total.
+ * 3. predict-shared/<kind>/e<edges>/t<threads>: Predict throughput of one NModel shared by all threads, each with its
+ *    own InferenceContext, items are samples. Metrics hold the model size and the largest difference to NNetwork::Predict.
+ * 4. predict-stream/<kind>/e<edges>: Single threaded batch NModel::Predict of a stream of 256 samples, items are samples.
+ * 5. predict-pipeline/<kind>/e<edges>/s<stages>: InferencePipeline throughput on the same stream, items are samples.
+ *    Metrics hold the speedup over predict-stream and the largest difference to NModel::Predict.
+ * 6. fit/<kind>/e<edges>: Single threaded Fit throughput for one epoch, items are samples.
+ *
+ * Differences of cases 3 and 5 are expected to be zero, any other value fails the run.
+ *
+ * @param harness Harness measuring and recording the cases.
+ */
+void scalingBenchmark(fnn::bench::BenchHarness &harness)
+{
+    using namespace fnn::bench;
+
+    const auto &options = harness.Options();
+    const size_t maxEdges = options.m_maxEdges;
+    const size_t maxThreads = std::max<size_t>(options.m_maxThreads, 1);
+    const size_t rows = 8;
+    const size_t streamRows = 256;
+
+    const std::vector<TopologyKind> kinds = { TopologyKind::DeepLayered, TopologyKind::WideLayered, TopologyKind::RandomDag, TopologyKind::PowerLawFanIn };
+
+    for (size_t targetEdges = 10000; targetEdges <= maxEdges; targetEdges *= 10)
+    {
+        for (const auto kind : kinds)
+        {
+            TopologySpec spec;
+            spec.m_kind = kind;
+            spec.m_edges = targetEdges;
+
+            const std::string name = topologyKindToString(kind) + "/e" + std::to_string(targetEdges);
+            const std::string parameters = "kind=" + topologyKindToString(kind) + ";edges=" + std::to_string(targetEdges);
+
+            // Generate once outside of Measure, large graphs take too long to build repeatedly
+            const size_t residentBefore = currentResidentBytes();
+            const auto start = std::chrono::steady_clock::now();
+            auto network = generateTopology(spec);
+            const std::chrono::duration<double, std::nano> buildTime = std::chrono::steady_clock::now() - start;
+            const size_t residentAfter = currentResidentBytes();
+
+            const double edges = static_cast<double>(countEdges(network));
+            const size_t inputs = network.m_network->m_inputs.size();
+            const size_t outputs = network.m_network->m_outputs.size();
+
+            BenchResult build;
+            build.m_suite = "scaling";
+            build.m_name = "build/" + name;
+            build.m_parameters = parameters;
+            build.m_iterations = 1;
+            build.m_nsPerIteration = buildTime.count();
+            build.m_itemsPerSecond = buildTime.count() > 0.0 ? edges * 1.0e9 / buildTime.count() : 0.0;
+            build.m_metrics = {
+                { "edges", edges },
+                { "neurons", static_cast<double>(network.m_network->Size()) },
+                { "rss_delta_bytes", static_cast<double>(residentAfter > residentBefore ? residentAfter - residentBefore : 0) },
+                { "estimated_bytes", static_cast<double>(network.Report().m_memory.TotalBytes()) },
+                { "peak_rss_bytes", static_cast<double>(peakResidentBytes()) },
+            };
+            harness.Record(std::move(build));
+
+            const auto testX = randomRows(rows, inputs, spec.m_seed + 1);
+            const auto testY = randomRows(rows, outputs, spec.m_seed + 2);
+
+            // Every thread needs its own replica, the first one is the already generated network
+            std::vector<fnn::NNetwork> replicas = { network };
+            for (size_t threads = 1; threads <= maxThreads && (threads == 1 || targetEdges * threads <= maxEdges); threads *= 2)
+            {
+                while (replicas.size() < threads)
+                {
+                    replicas.push_back(generateTopology(spec));
+                }
+
+                auto &result = harness.Measure("scaling", "predict/" + name + "/t" + std::to_string(threads), parameters + ";threads=" + std::to_string(threads),
+                    static_cast<double>(rows * threads), [&] {
+                        std::vector<std::thread> workers;
+                        workers.reserve(threads);
+                        for (size_t t = 0; t < threads; ++t)
+                        {
+                            workers.emplace_back([&replicas, &testX, t] {
+                                std::vector<std::vector<float>> output;
+                                replicas[t].Predict(testX, output);
+                            });
+                        }
+                        for (auto &worker : workers)
+                        {
+                            worker.join();
+                        }
+                    });
+                result.m_metrics = {
+                    { "edges_per_second", result.m_itemsPerSecond * edges },
+                    { "peak_rss_bytes", static_cast<double>(peakResidentBytes()) },
+                };
+            }
+            replicas.clear();
+
+            // One read-only model serves every thread, only activations are per thread
+            const auto model = fnn::NModel::Compile(network);
+            double difference = model != nullptr ? 0.0 : std::numeric_limits<double>::infinity();
+            if (model != nullptr)
+            {
+                std::vector<std::vector<float>> expected;
+                std::vector<std::vector<float>> actual;
+                fnn::InferenceContext context;
+                network.Predict(testX, expected);
+                model->Predict(context, testX, actual);
+                for (size_t i = 0; i < expected.size() && i < actual.size(); ++i)
+                {
+                    for (size_t j = 0; j < expected[i].size() && j < actual[i].size(); ++j)
+                    {
+                        difference = std::max(difference, static_cast<double>(std::abs(expected[i][j] - actual[i][j])));
+                    }
+                }
+            }
+            for (size_t threads = 1; threads <= maxThreads && model != nullptr; threads *= 2)
+            {
+                std::vector<fnn::InferenceContext> contexts(threads);
+                auto &result = harness.Measure("scaling", "predict-shared/" + name + "/t" + std::to_string(threads), parameters + ";threads=" + std::to_string(threads),
+                    static_cast<double>(rows * threads), [&] {
+                        std::vector<std::thread> workers;
+                        workers.reserve(threads);
+                        for (size_t t = 0; t < threads; ++t)
+                        {
+                            workers.emplace_back([&model, &contexts, &testX, t] {
+                                std::vector<std::vector<float>> output;
+                                model->Predict(contexts[t], testX, output);
+                            });
+                        }
+                        for (auto &worker : workers)
+                        {
+                            worker.join();
+                        }
+                    });
+                result.m_metrics = {
+                    { "edges_per_second", result.m_itemsPerSecond * edges },
+                    { "model_bytes", static_cast<double>(model->StorageBytes()) },
+                    { "peak_rss_bytes", static_cast<double>(peakResidentBytes()) },
+                };
+                harness.ExpectMetric(result, "max_abs_difference", difference, 0.0);
+            }
+
+            // Consecutive blocks of a stream are evaluated by different stages at the same time
+            if (model != nullptr)
+            {
+                const auto streamX = randomRows(streamRows, inputs, spec.m_seed + 3);
+                std::vector<std::vector<float>> expected;
+                fnn::InferenceContext context;
+                auto &stream = harness.Measure("scaling", "predict-stream/" + name, parameters, static_cast<double>(streamRows), [&] {
+                    model->Predict(context, streamX, expected);
+                });
+                stream.m_metrics = {
+                    { "edges_per_second", stream.m_itemsPerSecond * edges },
+                };
+                const double streamItemsPerSecond = stream.m_itemsPerSecond;
+
+                for (size_t stages = 2; stages <= std::max<size_t>(maxThreads, 2); stages *= 2)
+                {
+                    fnn::InferencePipeline pipeline(model, stages);
+                    std::vector<std::vector<float>> actual;
+                    pipeline.Predict(streamX, actual);
+                    double pipelineDifference = actual.size() == expected.size() ? 0.0 : std::numeric_limits<double>::infinity();
+                    for (size_t i = 0; i < expected.size() && i < actual.size(); ++i)
+                    {
+                        for (size_t j = 0; j < expected[i].size() && j < actual[i].size(); ++j)
+                        {
+                            pipelineDifference = std::max(pipelineDifference, static_cast<double>(std::abs(expected[i][j] - actual[i][j])));
+                        }
+                    }
+
+                    auto &result = harness.Measure("scaling", "predict-pipeline/" + name + "/s" + std::to_string(stages), parameters + ";stages=" + std::to_string(stages),
+                        static_cast<double>(streamRows), [&] {
+                            pipeline.Predict(streamX, actual);
+                        });
+                    result.m_metrics = {
+                        { "edges_per_second", result.m_itemsPerSecond * edges },
+                        { "stages", static_cast<double>(pipeline.StageCount()) },
+                        { "speedup", streamItemsPerSecond > 0.0 ? result.m_itemsPerSecond / streamItemsPerSecond : 0.0 },
+                    };
+                    harness.ExpectMetric(result, "max_abs_difference", pipelineDifference, 0.0);
+                }
+            }
+
+            auto &fit = harness.Measure("scaling", "fit/" + name, parameters, static_cast<double>(rows), [&] {
+                network.Fit(testX, testY, 1);
+            });
+            fit.m_metrics = {
+                { "edges_per_second", fit.m_itemsPerSecond * edges },
+                { "peak_rss_bytes", static_cast<double>(peakResidentBytes()) },
+            };
+        }
+    }
+}
@@ -0,0 +1,258 @@
+#include "TopologyGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_set>
+
+#include "NeuronBuilder.hpp"
+
+using namespace fnn;
+using namespace fnn::bench;
+
+namespace
+{
+    /**
+     * @brief Connects source neuron to destination the same way NNetwork({...}) connects layers
+     * @param graph [in, out] Graph to update
+     * @param source [in] Key of the source neuron
+     * @param destination [in] Key of the destination neuron
+     */
+    void connect(NGraph &graph, const size_t source, const size_t destination)
+    {
+        graph.AddSourceToDestinationHead(source, destination);
+        graph.AddSourceToDestinationTail(destination, source);
+    }
+
+    /**
+     * @brief Connects destination to count distinct neurons chosen uniformly from [0, candidates)
+     *
+     * Uses Floyd's sampling so cost depends only on count, not on number of candidates
+     * @param graph [in, out] Graph to update
+     * @param destination [in] Key of the destination neuron
+     * @param candidates [in] Number of neurons that can be chosen as source
+     * @param count [in] Number of sources
+     * @param engine [in, out] Random generator
+     * @return Number of created connections
+     */
+    size_t connectRandomSources(NGraph &graph, const size_t destination, const size_t candidates, const size_t count, std::mt19937_64 &engine)
+    {
+        const size_t sources = std::min(count, candidates);
+
+        std::unordered_set<size_t> chosen;
+        chosen.reserve(sources);
+        for (size_t j = candidates - sources; j < candidates; ++j)
+        {
+            const size_t pick = static_cast<size_t>(engine() % (j + 1));
+            const size_t source = chosen.insert(pick).second ? pick : j;
+            chosen.insert(source);
+            connect(graph, source, destination);
+        }
+        return sources;
+    }
+
+    /**
+     * @brief Generates RandomDag or PowerLawFanIn graph
+     * @param spec [in] Parameters of generated graph
+     * @return Generated network
+     */
+    NNetwork generateDag(const TopologySpec &spec)
+    {
+        auto network = NNetwork();
+        auto &graph = *network.m_network;
+        graph.m_randomStrategy = std::make_shared<SeededRandomStrategy>(spec.m_seed);
+
+        std::mt19937_64 engine(spec.m_seed ^ 0x9E3779B97F4A7C15ull);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        const size_t minFanIn = std::max<size_t>(spec.m_fanIn, 1);
+        const double exponent = std::max(static_cast<double>(spec.m_exponent), 2.01);
+
+        const auto drawFanIn = [&] ()
+        {
+            if (spec.m_kind != TopologyKind::PowerLawFanIn)
+            {
+                return minFanIn;
+            }
+            // Inverse transform sampling of Pareto distribution
+            const double fanIn = static_cast<double>(minFanIn) * std::pow(1.0 - unit(engine), -1.0 / (exponent - 1.0));
+            return static_cast<size_t>(std::min(fanIn, 1.0e9));
+        };
+
+        size_t neuronID = 0;
+        for (; neuronID < std::max<size_t>(spec.m_inputs, 1); ++neuronID)
+        {
+            graph.AddNeuron(neuronID, NeuronBuilder::CreateAsType(NeuronType::Input).Build());
+        }
+
+        // Output neurons are connected last, keep part of the budget for them
+        const size_t outputs = std::max<size_t>(spec.m_outputs, 1);
+        const size_t outputBudget = outputs * minFanIn;
+
+        size_t edges = 0;
+        while (edges + outputBudget < spec.m_edges)
+        {
+            graph.AddNeuron(neuronID, NeuronBuilder::CreateAsType(NeuronType::Hidden).Build());
+            edges += connectRandomSources(graph, neuronID, neuronID, drawFanIn(), engine);
+            ++neuronID;
+        }
+
+        const size_t candidates = neuronID;
+        for (size_t i = 0; i < outputs; ++i, ++neuronID)
+        {
+            graph.AddNeuron(neuronID, NeuronBuilder::CreateAsType(NeuronType::Output).Build());
+            connectRandomSources(graph, neuronID, candidates, drawFanIn(), engine);
+        }
+
+        return network;
+    }
+}
+
+SeededRandomStrategy::SeededRandomStrategy(const uint64_t seed)
+    : m_engine(seed)
+{
+}
+
+float SeededRandomStrategy::GetWeight(const float min, const float max)
+{
+    return std::uniform_real_distribution<float>(min, max)(m_engine);
+}
+
+std::string fnn::bench::topologyKindToString(const TopologyKind kind)
+{
+    using enum TopologyKind;
+
+    switch (kind)
+    {
+        case DeepLayered:
+            return "deep";
+        case WideLayered:
+            return "wide";
+        case RandomDag:
+            return "dag";
+        case PowerLawFanIn:
+            return "powerlaw";
+        default:
+            return "unknown";
+    }
+}
+
+NNetwork fnn::bench::generateTopology(const TopologySpec &spec)
+{
+    const size_t inputs = std::max<size_t>(spec.m_inputs, 1);
+    const size_t outputs = std::max<size_t>(spec.m_outputs, 1);
+
+    switch (spec.m_kind)
+    {
+        case TopologyKind::DeepLayered:
+        {
+            // inputs * width + (depth - 1) * width^2 + width * outputs edges
+            const size_t width = std::max<size_t>(spec.m_width, 1);
+            const size_t boundary = (inputs + outputs) * width;
+            const size_t depth = spec.m_edges > boundary ? (spec.m_edges - boundary) / (width * width) + 1 : 1;
+
+            std::vector<size_t> layerSizes = { inputs };
+            layerSizes.insert(layerSizes.end(), depth, width);
+            layerSizes.push_back(outputs);
+            return buildLayered(layerSizes, 1.0f, spec.m_seed);
+        }
+        case TopologyKind::WideLayered:
+        {
+            // (inputs + outputs) * width edges
+            const size_t width = std::max<size_t>(spec.m_edges / (inputs + outputs), 1);
+            return buildLayered({ inputs, width, outputs }, 1.0f, spec.m_seed);
+        }
+        default:
+            return generateDag(spec);
+    }
+}
+
+NNetwork fnn::bench::buildLayered(const std::vector<size_t> &layerSizes, const float density, const uint64_t seed)
+{
+    auto network = NNetwork();
+    auto &graph = *network.m_network;
+    graph.m_randomStrategy = std::make_shared<SeededRandomStrategy>(seed);
+
+    std::mt19937_64 engine(seed ^ 0x9E3779B97F4A7C15ull);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+
+    // Create neurons layer by layer, keys are consecutive
+    std::vector<size_t> layerBegin;
+    size_t neuronID = 0;
+    for (size_t layer = 0; layer < layerSizes.size(); ++layer)
+    {
+        const NeuronType type = layer == 0 ? NeuronType::Input : (layer + 1 == layerSizes.size() ? NeuronType::Output : NeuronType::Hidden);
+
+        layerBegin.push_back(neuronID);
+        for (size_t i = 0; i < layerSizes[layer]; ++i, ++neuronID)
+        {
+            graph.AddNeuron(neuronID, NeuronBuilder::CreateAsType(type).Build());
+        }
+    }
+    layerBegin.push_back(neuronID);
+
+    // Connect consecutive layers
+    for (size_t layer = 0; layer + 1 < layerSizes.size(); ++layer)
+    {
+        const size_t sourceBegin = layerBegin[layer];
+        const size_t sourceEnd = layerBegin[layer + 1];
+        const size_t destinationEnd = layerBegin[layer + 2];
+
+        if (sourceBegin == sourceEnd)
+        {
+            continue;
+        }
+
+        for (size_t destination = sourceEnd; destination < destinationEnd; ++destination)
+        {
+            bool connected = false;
+            for (size_t source = sourceBegin; source < sourceEnd; ++source)
+            {
+                if (density >= 1.0f || chance(engine) < density)
+                {
+                    graph.AddSourceToDestinationHead(source, destination);
+                    graph.AddSourceToDestinationTail(destination, source);
+                    connected = true;
+                }
+            }
+
+            if (! connected)
+            {
+                const size_t source = sourceBegin + static_cast<size_t>(engine() % (sourceEnd - sourceBegin));
+                graph.AddSourceToDestinationHead(source, destination);
+                graph.AddSourceToDestinationTail(destination, source);
+            }
+        }
+    }
+
+    return network;
+}
+
+size_t fnn::bench::countEdges(const NNetwork &network)
+{
+    size_t edges = 0;
+    for (const auto &neuron : network.m_network->Neurons())
+    {
+        if (neuron->m_headConnections.has_value())
+        {
+            edges += neuron->m_headConnections->size();
+        }
+    }
+    return edges;
+}
+
+std::vector<std::vector<float>> fnn::bench::randomRows(const size_t rows, const size_t columns, const uint64_t seed)
+{
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<float> value(0.0f, 1.0f);
+
+    std::vector<std::vector<float>> result(rows, std::vector<float>(columns));
+    for (auto &row : result)
+    {
+        for (auto &column : row)
+        {
+            column = value(engine);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NNetwork.hpp"
+#include "RandomStrategyInterface.hpp"
+
+namespace fnn::bench
+{
+    /**
+     * @class SeededRandomStrategy
+     * @brief Reproducible weight initialisation so generated networks are identical between runs
+     */
+    class SeededRandomStrategy final : public IRandomStrategy
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param seed [in] Seed of the generator
+         */
+        explicit SeededRandomStrategy(const uint64_t seed);
+        ~SeededRandomStrategy() override = default;
+
+        /**
+         * @brief Generates a random weight within the specified range
+         * @param min [in] Minimum value for the weight
+         * @param max [in] Maximum value for the weight
+         * @return A random float between min and max
+         */
+        float GetWeight(const float min, const float max) override;
+
+    private:
+        std::mt19937_64 m_engine; ///< Underlying generator
+    };
+
+    /**
+     * @enum TopologyKind
+     * @brief Families of synthetic graphs produced by generateTopology
+     */
+    enum class TopologyKind
+    {
+        DeepLayered,   ///< Many fully connected hidden layers of fixed width
+        WideLayered,   ///< Single fully connected hidden layer as wide as the edge budget allows
+        RandomDag,     ///< Neurons connect to uniformly chosen earlier neurons, producing skip connections
+        PowerLawFanIn, ///< Like RandomDag, but fan-in of neurons follows a power-law distribution
+    };
+
+    /**
+     * @struct TopologySpec
+     * @brief Parameters of a generated graph, equal specs always produce identical networks
+     */
+    struct TopologySpec final
+    {
+    public:
+        TopologyKind m_kind = TopologyKind::DeepLayered; ///< Family of generated graph
+        size_t m_edges = 100000; ///< Approximate number of connections, generated graph stays within a few percent
+        size_t m_inputs = 16; ///< Number of input neurons
+        size_t m_outputs = 4; ///< Number of output neurons
+        size_t m_width = 64; ///< Hidden layer width of DeepLayered graphs
+        size_t m_fanIn = 32; ///< Average fan-in of RandomDag and minimal fan-in of PowerLawFanIn graphs
+        float m_exponent = 2.5f; ///< Exponent of PowerLawFanIn fan-in distribution, must be above 2
+        uint64_t m_seed = 42; ///< Seed used for both structure and weights
+    };
+
+    /**
+     * @brief Converts a TopologyKind to its string representation
+     * @param kind [in] The TopologyKind to convert
+     * @return A string representing the TopologyKind
+     */
+    std::string topologyKindToString(const TopologyKind kind);
+
+    /**
+     * @brief Generates synthetic network described by spec
+     *
+     * Input neurons get keys [0, inputs), hidden neurons follow in topological order and output neurons get the highest keys
+     * @param spec [in] Parameters of generated graph
+     * @return Generated network
+     */
+    NNetwork generateTopology(const TopologySpec &spec);
+
+    /**
+     * @brief Builds layered network where each pair of neurons in consecutive layers is connected with given probability
+     *
+     * Every non input neuron keeps at least one incoming connection so the whole network stays reachable.
+     * Neuron keys are assigned layer by layer, the same way NNetwork({...}) does.
+     * @param layerSizes [in] Number of neurons in each layer, first is input and last is output layer
+     * @param density [in] Probability of connection between neurons of consecutive layers, 1 creates fully connected layers
+     * @param seed [in] Seed used for both connection choice and weights
+     * @return Generated network
+     */
+    NNetwork buildLayered(const std::vector<size_t> &layerSizes, const float density, const uint64_t seed);
+
+    /**
+     * @brief Counts trainable (head) connections of every neuron in the network
+     * @param network [in] Network to inspect
+     * @return Number of head connections
+     */
+    size_t countEdges(const NNetwork &network);
+
+    /**
+     * @brief Generates random rows of values in [0, 1)
+     * @param rows [in] Number of rows
+     * @param columns [in] Number of values in row
+     * @param seed [in] Seed of the generator
+     * @return Generated rows
+     */
+    std::vector<std::vector<float>> randomRows(const size_t rows, const size_t columns, const uint64_t seed);
+}
@@ -1,4 +1,16 @@
 -- premake5.lua
+newoption
+{
+   trigger = "with-statistics",
+   description = "Record training phase statistics in NNetwork (defines FNN_ENABLE_STATISTICS)"
+}
+
+newoption
+{
+   trigger = "with-tracing",
+   description = "Record Chrome trace events of Fit and Predict (defines FNN_ENABLE_TRACING)"
+}
+
 workspace "App"
    architecture "x64"
    configurations { "Debug", "Release", "Dist" }
@@ -8,6 +20,15 @@ workspace "App"
    filter "system:windows"
       buildoptions { "/EHsc", "/Zc:preprocessor", "/Zc:__cplusplus" }
 
+   -- Optional instrumentation, compiled away unless requested
+   filter "options:with-statistics"
+      defines { "FNN_ENABLE_STATISTICS" }
+
+   filter "options:with-tracing"
+      defines { "FNN_ENABLE_TRACING" }
+
+   filter {}
+
 OutputDir = "%{cfg.system}-%{cfg.architecture}/%{cfg.buildcfg}"
 
 group "FNN"
@@ -15,3 +36,4 @@ include "FNN/Build-FNN.lua"
 group ""
 
 include "App/Build-App.lua"
+include "Bench/Build-Bench.lua"
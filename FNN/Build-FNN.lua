@@ -13,7 +13,8 @@ project "FNN"
       "Source/Edge",
       "Source/Neuron",
       "Source/NNetwork",
-      "Source/Random"
+      "Source/Random",
+      "Source/Statistics"
    }
 
    targetdir ("../Binaries/" .. OutputDir .. "/%{prj.name}")
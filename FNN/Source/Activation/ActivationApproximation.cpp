@@ -0,0 +1,22 @@
+#include "ActivationApproximation.hpp"
+
+#include <cmath>
+
+using namespace fnn;
+
+const std::array<float, approximation::TANH_TABLE_SIZE> &fnn::approximation::tanhTable()
+{
+    static const std::array<float, TANH_TABLE_SIZE> table = []
+    {
+        std::array<float, TANH_TABLE_SIZE> samples{};
+        for (size_t i = 0; i < TANH_TABLE_SIZE; ++i)
+        {
+            // Sample in double so table entries are correctly rounded
+            const double x = -TANH_TABLE_RANGE + 2.0 * TANH_TABLE_RANGE * static_cast<double>(i) / static_cast<double>(TANH_TABLE_SIZE - 1);
+            samples[i] = static_cast<float>(std::tanh(x));
+        }
+        return samples;
+    }();
+
+    return table;
+}
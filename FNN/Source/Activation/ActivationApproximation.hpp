@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace fnn
+{
+    /**
+     * @enum ApproximationMode
+     * @brief Selects how approximate activation functions are evaluated
+     */
+    enum class ApproximationMode
+    {
+        Rational,    ///< Clamped odd rational polynomial, close to float precision
+        LookupTable, ///< Linear interpolation in a precomputed table, cheapest but least accurate
+    };
+
+    namespace approximation
+    {
+        // Maximum absolute errors against double precision std::tanh / logistic function,
+        // measured exhaustively over every finite float input and rounded up
+
+        constexpr float TANH_RATIONAL_MAX_ERROR = 5.0e-7f; ///< Upper bound of |TanhRational(x) - tanh(x)|
+        constexpr float TANH_LOOKUP_MAX_ERROR = 1.0e-4f; ///< Upper bound of |TanhLookup(x) - tanh(x)|
+        constexpr float SIGMOID_RATIONAL_MAX_ERROR = 3.0e-7f; ///< Upper bound of |SigmoidRational(x) - sigmoid(x)|
+        constexpr float SIGMOID_LOOKUP_MAX_ERROR = 5.0e-5f; ///< Upper bound of |SigmoidLookup(x) - sigmoid(x)|
+
+        constexpr size_t TANH_TABLE_SIZE = 513; ///< Number of samples in the tanh lookup table
+        constexpr float TANH_TABLE_RANGE = 8.0f; ///< Table covers [-range, range], tanh is saturated outside
+
+        /**
+         * @brief Returns tanh samples evenly spread over [-TANH_TABLE_RANGE, TANH_TABLE_RANGE]
+         * @return Reference to the lookup table, built on first use
+         */
+        const std::array<float, TANH_TABLE_SIZE> &tanhTable();
+
+        /**
+         * @brief Rational approximation of tanh, branch free so loops over it vectorise
+         * @param input [in] Input value
+         * @return Approximated tanh(input)
+         */
+        inline float TanhRational(const float input)
+        {
+            // Beyond this point the approximation would leave [-1, 1] while tanh is already 1 in float
+            constexpr float clamp = 7.90531110763549805f;
+
+            const float x = std::clamp(input, -clamp, clamp);
+            const float x2 = x * x;
+
+            // Odd numerator polynomial
+            float p = -2.76076847742355e-16f;
+            p = p * x2 + 2.00018790482477e-13f;
+            p = p * x2 - 8.60467152213735e-11f;
+            p = p * x2 + 5.12229709037114e-08f;
+            p = p * x2 + 1.48572235717979e-05f;
+            p = p * x2 + 6.37261928875436e-04f;
+            p = p * x2 + 4.89352455891786e-03f;
+            p = p * x;
+
+            // Even denominator polynomial
+            float q = 1.19825839466702e-06f;
+            q = q * x2 + 1.18534705686654e-04f;
+            q = q * x2 + 2.26843463243900e-03f;
+            q = q * x2 + 4.89352518554385e-03f;
+
+            return p / q;
+        }
+
+        /**
+         * @brief Lookup table approximation of tanh with linear interpolation between samples
+         * @param input [in] Input value
+         * @param table [in] Table returned by tanhTable(), pass it in when looping to keep the loop free of the static guard
+         * @return Approximated tanh(input)
+         */
+        inline float TanhLookup(const float input, const std::array<float, TANH_TABLE_SIZE> &table)
+        {
+            constexpr float scale = static_cast<float>(TANH_TABLE_SIZE - 1) / (2.0f * TANH_TABLE_RANGE);
+
+            const float position = (std::clamp(input, -TANH_TABLE_RANGE, TANH_TABLE_RANGE) + TANH_TABLE_RANGE) * scale;
+            const size_t index = std::min(static_cast<size_t>(position), TANH_TABLE_SIZE - 2);
+            const float fraction = position - static_cast<float>(index);
+
+            return table[index] + (table[index + 1] - table[index]) * fraction;
+        }
+
+        /**
+         * @brief Lookup table approximation of tanh with linear interpolation between samples
+         * @param input [in] Input value
+         * @return Approximated tanh(input)
+         */
+        inline float TanhLookup(const float input)
+        {
+            return TanhLookup(input, tanhTable());
+        }
+
+        /**
+         * @brief Rational approximation of the logistic sigmoid, uses sigmoid(x) = (tanh(x / 2) + 1) / 2
+         * @param input [in] Input value
+         * @return Approximated sigmoid(input)
+         */
+        inline float SigmoidRational(const float input)
+        {
+            return 0.5f * TanhRational(0.5f * input) + 0.5f;
+        }
+
+        /**
+         * @brief Lookup table approximation of the logistic sigmoid, uses sigmoid(x) = (tanh(x / 2) + 1) / 2
+         * @param input [in] Input value
+         * @return Approximated sigmoid(input)
+         */
+        inline float SigmoidLookup(const float input)
+        {
+            return 0.5f * TanhLookup(0.5f * input) + 0.5f;
+        }
+    }
+}
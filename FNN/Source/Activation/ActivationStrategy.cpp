@@ -55,6 +55,76 @@ float TanhStrategy::Derivation(const float activationOutput)
 }
 
 
+FastSigmoidStrategy::FastSigmoidStrategy(const ApproximationMode mode)
+    : m_mode(mode)
+{
+}
+
+float FastSigmoidStrategy::Activation(const float input)
+{
+    return m_mode == ApproximationMode::LookupTable ? approximation::SigmoidLookup(input) : approximation::SigmoidRational(input);
+}
+
+float FastSigmoidStrategy::Derivation(const float activationOutput)
+{
+    return activationOutput * (1.0f - activationOutput);
+}
+
+void FastSigmoidStrategy::ActivationBatch(const std::span<const float> inputs, const std::span<float> outputs)
+{
+    // Branch on mode once, keep the loops free of calls so they can be vectorised
+    if (m_mode == ApproximationMode::LookupTable)
+    {
+        const auto &table = approximation::tanhTable();
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            outputs[i] = 0.5f * approximation::TanhLookup(0.5f * inputs[i], table) + 0.5f;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        outputs[i] = approximation::SigmoidRational(inputs[i]);
+    }
+}
+
+
+FastTanhStrategy::FastTanhStrategy(const ApproximationMode mode)
+    : m_mode(mode)
+{
+}
+
+float FastTanhStrategy::Activation(const float input)
+{
+    return m_mode == ApproximationMode::LookupTable ? approximation::TanhLookup(input) : approximation::TanhRational(input);
+}
+
+float FastTanhStrategy::Derivation(const float activationOutput)
+{
+    return 1.0f - activationOutput * activationOutput;
+}
+
+void FastTanhStrategy::ActivationBatch(const std::span<const float> inputs, const std::span<float> outputs)
+{
+    // Branch on mode once, keep the loops free of calls so they can be vectorised
+    if (m_mode == ApproximationMode::LookupTable)
+    {
+        const auto &table = approximation::tanhTable();
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            outputs[i] = approximation::TanhLookup(inputs[i], table);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        outputs[i] = approximation::TanhRational(inputs[i]);
+    }
+}
+
+
 float LinearStrategy::Activation(const float input)
 {
     return input;
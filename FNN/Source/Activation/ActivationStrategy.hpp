@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ActivationApproximation.hpp"
 #include "ActivationStrategyInterface.hpp"
 
 namespace fnn
@@ -117,6 +118,88 @@ namespace fnn
         float Derivation(const float activationOutput) override;
     };
 
+    /**
+     * @class FastSigmoidStrategy
+     * @brief Approximate Sigmoid activation function implementation
+     *
+     * Trades accuracy for speed, maximum absolute error is SIGMOID_RATIONAL_MAX_ERROR or SIGMOID_LOOKUP_MAX_ERROR
+     * depending on selected mode
+     */
+    class FastSigmoidStrategy final : public INeuronFunctionStrategy
+    {
+    public:
+        const ApproximationMode m_mode; ///< Approximation used for evaluation, default is Rational
+
+        /**
+         * @brief Constructor with optional approximation mode
+         * @param mode [in] Approximation used for evaluation, default is Rational
+         */
+        explicit FastSigmoidStrategy(const ApproximationMode mode = ApproximationMode::Rational);
+        ~FastSigmoidStrategy() override = default;
+
+        /**
+         * @brief Activation function
+         * @param input [in] Input value
+         * @return Output value after activation
+         */
+        float Activation(const float input) override;
+
+        /**
+         * @brief Derivative of activation function
+         * @param activationOutput [in] Activation function output
+         * @return Derivative value
+         */
+        float Derivation(const float activationOutput) override;
+
+        /**
+         * @brief Activation function for a contiguous block of inputs
+         * @param inputs [in] Input values
+         * @param outputs [out] Output values after activation
+         */
+        void ActivationBatch(const std::span<const float> inputs, const std::span<float> outputs) override;
+    };
+
+    /**
+     * @class FastTanhStrategy
+     * @brief Approximate hyperbolic tangent (tanh) activation function implementation
+     *
+     * Trades accuracy for speed, maximum absolute error is TANH_RATIONAL_MAX_ERROR or TANH_LOOKUP_MAX_ERROR
+     * depending on selected mode
+     */
+    class FastTanhStrategy final : public INeuronFunctionStrategy
+    {
+    public:
+        const ApproximationMode m_mode; ///< Approximation used for evaluation, default is Rational
+
+        /**
+         * @brief Constructor with optional approximation mode
+         * @param mode [in] Approximation used for evaluation, default is Rational
+         */
+        explicit FastTanhStrategy(const ApproximationMode mode = ApproximationMode::Rational);
+        ~FastTanhStrategy() override = default;
+
+        /**
+         * @brief Activation function
+         * @param input [in] Input value
+         * @return Output value after activation
+         */
+        float Activation(const float input) override;
+
+        /**
+         * @brief Derivative of activation function
+         * @param activationOutput [in] Activation function output
+         * @return Derivative value
+         */
+        float Derivation(const float activationOutput) override;
+
+        /**
+         * @brief Activation function for a contiguous block of inputs
+         * @param inputs [in] Input values
+         * @param outputs [out] Output values after activation
+         */
+        void ActivationBatch(const std::span<const float> inputs, const std::span<float> outputs) override;
+    };
+
     /**
      * @class LinearStrategy
      * @brief Linear activation function implementation
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <span>
+
 namespace fnn
 {
     /**
@@ -30,5 +33,21 @@ namespace fnn
          * @return Derivative at the given output value
          */
         virtual float Derivation(const float activationOutput) = 0;
+
+        /**
+         * @brief Computes neuron activation for a contiguous block of inputs
+         *
+         * Default implementation calls Activation per element, strategies with inline math override it
+         * so the loop can be vectorised
+         * @param inputs [in] Input values
+         * @param outputs [out] Activation function outputs, must be at least as long as inputs
+         */
+        virtual void ActivationBatch(const std::span<const float> inputs, const std::span<float> outputs)
+        {
+            for (size_t i = 0; i < inputs.size(); ++i)
+            {
+                outputs[i] = Activation(inputs[i]);
+            }
+        }
     };
 }
@@ -0,0 +1,206 @@
+#include "AsyncExecutor.hpp"
+
+#include <algorithm>
+
+using namespace fnn;
+
+/**
+ * @struct AsyncExecutor::FitJob
+ * @brief Training data and progress of one Fit or FitMiniBatch call
+ */
+struct AsyncExecutor::FitJob final
+{
+public:
+    FitJob(NNetwork &network, std::vector<std::vector<float>> trainX, std::vector<std::vector<float>> trainY, const size_t epochs,
+           const size_t batchSize, std::stop_token stopToken)
+        : m_network(network)
+        , m_trainX(std::move(trainX))
+        , m_trainY(std::move(trainY))
+        , m_epochs(epochs)
+        , m_batchSize(batchSize)
+        , m_stopToken(std::move(stopToken))
+    {
+    }
+
+    NNetwork &m_network; ///< Trained network
+    std::vector<std::vector<float>> m_trainX; ///< Input features for training
+    std::vector<std::vector<float>> m_trainY; ///< Target values for training
+    size_t m_epochs; ///< Number of training iterations
+    size_t m_batchSize; ///< Samples per weight update, 0 trains sample by sample like Fit
+    std::stop_token m_stopToken; ///< Cancellation requested by the caller
+    std::promise<bool> m_promise; ///< Completed when training ends
+};
+
+AsyncExecutor::AsyncExecutor(const size_t threads, const size_t sliceSamples)
+    : m_sliceSamples(std::max<size_t>(sliceSamples, 1))
+{
+    const size_t count = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_workers.emplace_back(&AsyncExecutor::Work, this);
+    }
+}
+
+AsyncExecutor::~AsyncExecutor()
+{
+    // Training jobs end after their current batch, queued predictions still complete
+    m_stopSource.request_stop();
+    {
+        std::lock_guard lock(m_tasksMutex);
+        m_isClosing = true;
+    }
+    m_tasksReady.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+std::future<std::vector<std::vector<float>>> AsyncExecutor::Predict(std::shared_ptr<const NModel> model, std::vector<std::vector<float>> testX,
+                                                                    std::stop_token stopToken)
+{
+    auto promise = std::make_shared<std::promise<std::vector<std::vector<float>>>>();
+    auto future = promise->get_future();
+    Post([promise, model = std::move(model), testX = std::move(testX), stopToken = std::move(stopToken)](InferenceContext &context)
+    {
+        FNN_TRACE_SCOPE("AsyncPredict");
+
+        std::vector<std::vector<float>> output;
+        if (model == nullptr || stopToken.stop_requested() || ! model->Predict(context, testX, output))
+        {
+            output.clear();
+        }
+        promise->set_value(std::move(output));
+    }, true);
+    return future;
+}
+
+std::future<std::vector<std::vector<float>>> AsyncExecutor::Predict(NNetwork &network, std::vector<std::vector<float>> testX, std::stop_token stopToken)
+{
+    auto promise = std::make_shared<std::promise<std::vector<std::vector<float>>>>();
+    auto future = promise->get_future();
+    Post([promise, &network, testX = std::move(testX), stopToken = std::move(stopToken)](InferenceContext&)
+    {
+        FNN_TRACE_SCOPE("AsyncPredict");
+
+        std::vector<std::vector<float>> output;
+        if (stopToken.stop_requested() || ! network.Predict(testX, output))
+        {
+            output.clear();
+        }
+        promise->set_value(std::move(output));
+    }, true);
+    return future;
+}
+
+std::future<bool> AsyncExecutor::Fit(NNetwork &network, std::vector<std::vector<float>> trainX, std::vector<std::vector<float>> trainY, const size_t epochs,
+                                     std::stop_token stopToken)
+{
+    return Start(std::make_shared<FitJob>(network, std::move(trainX), std::move(trainY), epochs, 0, std::move(stopToken)));
+}
+
+std::future<bool> AsyncExecutor::FitMiniBatch(NNetwork &network, std::vector<std::vector<float>> trainX, std::vector<std::vector<float>> trainY,
+                                              const size_t epochs, const size_t batchSize, std::stop_token stopToken)
+{
+    if (batchSize == 0)
+    {
+        // Empty batches cannot update weights
+        std::promise<bool> promise;
+        promise.set_value(false);
+        return promise.get_future();
+    }
+    return Start(std::make_shared<FitJob>(network, std::move(trainX), std::move(trainY), epochs, batchSize, std::move(stopToken)));
+}
+
+size_t AsyncExecutor::ThreadCount() const
+{
+    return m_workers.size();
+}
+
+void AsyncExecutor::Post(Task task, const bool isInteractive)
+{
+    {
+        std::lock_guard lock(m_tasksMutex);
+        (isInteractive ? m_interactive : m_background).push_back(std::move(task));
+    }
+    m_tasksReady.notify_one();
+}
+
+std::future<bool> AsyncExecutor::Start(std::shared_ptr<FitJob> job)
+{
+    auto future = job->m_promise.get_future();
+    Post([this, job = std::move(job)](InferenceContext &context) { Train(*job, context); }, false);
+    return future;
+}
+
+void AsyncExecutor::Train(FitJob &job, InferenceContext &context)
+{
+    FNN_TRACE_SCOPE("AsyncFit");
+
+    if (job.m_stopToken.stop_requested() || m_stopSource.stop_requested())
+    {
+        job.m_promise.set_value(false);
+        return;
+    }
+
+    // Training loop of NNetwork, every slice of samples runs the predictions queued meanwhile on this worker
+    const size_t samplesPerBatch = std::max<size_t>(job.m_batchSize, 1);
+    size_t samples = 0;
+    const auto onBatch = [this, &job, &context, &samples, samplesPerBatch](const size_t, const size_t)
+    {
+        if (job.m_stopToken.stop_requested() || m_stopSource.stop_requested())
+        {
+            return false;
+        }
+        samples += samplesPerBatch;
+        if (samples >= m_sliceSamples)
+        {
+            samples = 0;
+            RunInteractive(context);
+        }
+        return true;
+    };
+
+    job.m_promise.set_value(job.m_batchSize == 0 ?
+        job.m_network.Fit(job.m_trainX, job.m_trainY, job.m_epochs, onBatch) :
+        job.m_network.FitMiniBatch(job.m_trainX, job.m_trainY, job.m_epochs, job.m_batchSize, onBatch));
+}
+
+void AsyncExecutor::RunInteractive(InferenceContext &context)
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::lock_guard lock(m_tasksMutex);
+            if (m_interactive.empty())
+            {
+                return;
+            }
+            task = std::move(m_interactive.front());
+            m_interactive.pop_front();
+        }
+        task(context);
+    }
+}
+
+void AsyncExecutor::Work()
+{
+    InferenceContext context;
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock lock(m_tasksMutex);
+            m_tasksReady.wait(lock, [this] { return m_isClosing || ! m_interactive.empty() || ! m_background.empty(); });
+            auto &queue = ! m_interactive.empty() ? m_interactive : m_background;
+            if (queue.empty())
+            {
+                return;
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        task(context);
+    }
+}
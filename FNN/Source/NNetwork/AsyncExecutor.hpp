@@ -0,0 +1,145 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "NModel.hpp"
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @class AsyncExecutor
+     * @brief Library managed thread pool running Predict and Fit without blocking the caller
+     *
+     * Predictions are interactive tasks and always start before queued training. Training is a background task
+     * running NNetwork::Fit or FitMiniBatch, so weights are updated exactly like the blocking calls; after every
+     * sliceSamples samples it runs the predictions queued meanwhile on its own worker, so predictions never wait behind
+     * a whole job. Cancellation is cooperative through std::stop_token, checked before a prediction starts and after
+     * every training batch
+     */
+    class AsyncExecutor final
+    {
+    public:
+        /**
+         * @brief Starts worker threads
+         * @param threads [in] Number of workers, 0 uses one per hardware thread
+         * @param sliceSamples [in] Samples trained before a training job runs waiting predictions
+         */
+        explicit AsyncExecutor(const size_t threads = 0, const size_t sliceSamples = 64);
+
+        AsyncExecutor(const AsyncExecutor&) = delete;
+        AsyncExecutor &operator=(const AsyncExecutor&) = delete;
+
+        /**
+         * @brief Cancels training jobs after their current batch, runs queued predictions and stops workers
+         */
+        ~AsyncExecutor();
+
+        /**
+         * @brief Predicts outputs of a compiled model on a worker with its own InferenceContext
+         * @param model [in] Model to predict with
+         * @param testX [in] Input features for prediction
+         * @param stopToken [in] Cancels prediction that did not start yet
+         * @return Future of predicted outputs, empty when model is nullptr, input has wrong size or prediction was cancelled
+         */
+        std::future<std::vector<std::vector<float>>> Predict(std::shared_ptr<const NModel> model, std::vector<std::vector<float>> testX,
+                                                             std::stop_token stopToken = {});
+
+        /**
+         * @brief Predicts outputs of a network on a worker, the network must not be used until the future is ready
+         * @param network [in, out] Network to predict with
+         * @param testX [in] Input features for prediction
+         * @param stopToken [in] Cancels prediction that did not start yet
+         * @return Future of predicted outputs, empty when prediction fails or was cancelled
+         */
+        std::future<std::vector<std::vector<float>>> Predict(NNetwork &network, std::vector<std::vector<float>> testX, std::stop_token stopToken = {});
+
+        /**
+         * @brief Trains network sample by sample like NNetwork::Fit, the network must not be used until the future is ready
+         * @param network [in, out] Network to train
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target values for training
+         * @param epochs [in] Number of training iterations
+         * @param stopToken [in] Cancels training after its current batch, weights keep updates of finished batches
+         * @return Future of true if training is successful, false when training fails or was cancelled
+         */
+        std::future<bool> Fit(NNetwork &network, std::vector<std::vector<float>> trainX, std::vector<std::vector<float>> trainY, const size_t epochs = 10,
+                              std::stop_token stopToken = {});
+
+        /**
+         * @brief Trains network in mini-batches like NNetwork::FitMiniBatch, the network must not be used until the future is ready
+         * @param network [in, out] Network to train
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target values for training
+         * @param epochs [in] Number of training iterations
+         * @param batchSize [in] Number of samples per weight update
+         * @param stopToken [in] Cancels training after its current batch, weights keep updates of finished batches
+         * @return Future of true if training is successful, false when training fails or was cancelled
+         */
+        std::future<bool> FitMiniBatch(NNetwork &network, std::vector<std::vector<float>> trainX, std::vector<std::vector<float>> trainY,
+                                       const size_t epochs, const size_t batchSize, std::stop_token stopToken = {});
+
+        /**
+         * @brief Returns number of workers
+         * @return Worker thread count
+         */
+        size_t ThreadCount() const;
+
+    private:
+        using Task = std::function<void(InferenceContext&)>; ///< Work item, receives the context of the running worker
+
+        struct FitJob;
+
+        size_t m_sliceSamples; ///< Samples trained before a training job runs waiting predictions
+        std::stop_source m_stopSource; ///< Cancels every training job on destruction
+
+        std::mutex m_tasksMutex; ///< Guards both task queues and m_isClosing
+        std::condition_variable m_tasksReady; ///< Signals new tasks or closing
+        std::deque<Task> m_interactive; ///< Predictions, always run first
+        std::deque<Task> m_background; ///< Training jobs
+        bool m_isClosing = false; ///< Workers exit once no task is left
+
+        std::vector<std::thread> m_workers; ///< Run tasks
+
+        /**
+         * @brief Queues a task
+         * @param task [in] Task to run
+         * @param isInteractive [in] Runs before any background task
+         */
+        void Post(Task task, const bool isInteractive);
+
+        /**
+         * @brief Queues a training job
+         * @param job [in] Job to start
+         * @return Future of the job result
+         */
+        std::future<bool> Start(std::shared_ptr<FitJob> job);
+
+        /**
+         * @brief Trains a job until it finishes or is cancelled
+         * @param job [in, out] Job to train
+         * @param context [in, out] Context of the running worker, used by predictions run between slices
+         */
+        void Train(FitJob &job, InferenceContext &context);
+
+        /**
+         * @brief Runs queued predictions on the calling worker until none is left
+         * @param context [in, out] Context of the running worker
+         */
+        void RunInteractive(InferenceContext &context);
+
+        /**
+         * @brief Runs tasks until closing
+         */
+        void Work();
+    };
+}
@@ -0,0 +1,105 @@
+#include "BackwardVisits.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace fnn;
+
+bool utility::countBackwardVisits(const NGraph &graph, BackwardVisits &visits)
+{
+    const auto neurons = graph.Neurons();
+    visits.m_hasOutputError.assign(graph.m_outputs.size(), 0);
+    visits.m_hasOutputWeights.assign(graph.m_outputs.size(), 0);
+    visits.m_errorVisits.assign(neurons.size(), 0);
+    visits.m_weightVisits.assign(neurons.size(), 0);
+    visits.m_isReached.assign(neurons.size(), 0);
+
+    std::unordered_map<const Neuron*, size_t> indices;
+    for (size_t i = 0; i < neurons.size(); ++i)
+    {
+        indices.emplace(neurons[i].get(), i);
+    }
+
+    // Outputs seed both traversals as in SetErrorsAndDiscoverConnections and SetWeightsAndDiscoverConnections
+    std::unordered_set<const Neuron*> errorLayer;
+    std::unordered_set<const Neuron*> weightLayer;
+    for (size_t o = 0; o < graph.m_outputs.size(); ++o)
+    {
+        const auto &neuron = graph.GetNeuron(graph.m_outputs[o]);
+        const auto index = neuron != nullptr ? indices.find(neuron.get()) : indices.end();
+        if (index == indices.end() || visits.m_isReached[index->second])
+        {
+            return false;
+        }
+        visits.m_isReached[index->second] = 1;
+
+        if (neuron->m_neuronType != NeuronType::Output || ! neuron->m_headConnections.has_value())
+        {
+            continue;
+        }
+        if (neuron->m_errorCalculation.has_value() && neuron->m_errorCalculation.value() != nullptr)
+        {
+            visits.m_hasOutputError[o] = 1;
+            for (const auto &headEdge : neuron->m_headConnections.value())
+            {
+                errorLayer.insert(headEdge.m_head.get());
+            }
+        }
+        if (neuron->m_learningRate.has_value() && neuron->m_weightCalculation.has_value() && neuron->m_weightCalculation.value() != nullptr)
+        {
+            visits.m_hasOutputWeights[o] = 1;
+            for (const auto &headEdge : neuron->m_headConnections.value())
+            {
+                weightLayer.insert(headEdge.m_head.get());
+            }
+        }
+    }
+
+    // Replays the traversals of BackwardPropagateError and BackwardPropagateWeights, a neuron reached on several
+    // levels is processed once per level there
+    const auto traverse = [&](std::unordered_set<const Neuron*> &currentLayer, const auto &qualifies, std::vector<uint32_t> &counts)
+    {
+        std::unordered_set<const Neuron*> nextLayer;
+        while (! currentLayer.empty())
+        {
+            nextLayer.clear();
+            for (const Neuron *neuron : currentLayer)
+            {
+                const auto index = indices.find(neuron);
+                if (index == indices.end())
+                {
+                    return false;
+                }
+
+                visits.m_isReached[index->second] = 1;
+                if (! qualifies(*neuron))
+                {
+                    continue;
+                }
+                ++counts[index->second];
+
+                if (neuron->m_neuronType == NeuronType::Input)
+                {
+                    continue;
+                }
+                for (const auto &headEdge : neuron->m_headConnections.value())
+                {
+                    nextLayer.insert(headEdge.m_head.get());
+                }
+            }
+            std::swap(currentLayer, nextLayer);
+        }
+        return true;
+    };
+
+    return traverse(errorLayer, [](const Neuron &neuron)
+    {
+        return neuron.m_tailConnections.has_value() && neuron.m_headConnections.has_value() &&
+               neuron.m_errorCalculation.has_value() && neuron.m_errorCalculation.value() != nullptr;
+    }, visits.m_errorVisits) &&
+    traverse(weightLayer, [](const Neuron &neuron)
+    {
+        return neuron.m_headConnections.has_value() && neuron.m_learningRate.has_value() &&
+               neuron.m_weightCalculation.has_value() && neuron.m_weightCalculation.value() != nullptr;
+    }, visits.m_weightVisits);
+}
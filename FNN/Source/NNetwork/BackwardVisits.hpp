@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "NGraph.hpp"
+
+namespace fnn
+{
+    /**
+     * @struct BackwardVisits
+     * @brief How often BackwardPropagateError and BackwardPropagateWeights of NNetwork process each neuron
+     *
+     * The passes traverse level by level through head connections starting at the outputs, a neuron reached on
+     * several levels is processed once per level. Outputs are indexed by position in NGraph::m_outputs, all other
+     * vectors by dense storage index
+     */
+    struct BackwardVisits final
+    {
+    public:
+        std::vector<uint8_t> m_hasOutputError; ///< Output computes its error from the target and seeds the error traversal
+        std::vector<uint8_t> m_hasOutputWeights; ///< Output updates its head weights once and seeds the weight traversal
+        std::vector<uint32_t> m_errorVisits; ///< Times the error traversal recomputes a neuron's error
+        std::vector<uint32_t> m_weightVisits; ///< Times the weight traversal updates a neuron's head weights
+        std::vector<uint8_t> m_isReached; ///< Neuron is an output or was reached by a traversal, whether it qualified or not
+    };
+
+    namespace utility
+    {
+        /**
+         * @brief Replays the traversals of the backward passes once and counts their visits
+         *
+         * Whether a neuron qualifies depends on its connections, its error and weight strategies and whether it has
+         * a learning rate, so counts are valid until any of them changes
+         * @param graph [in] Graph to traverse
+         * @param visits [out] Counted visits
+         * @return True if counted, false when an output is missing or repeated or an edge leaves the graph
+         */
+        bool countBackwardVisits(const NGraph &graph, BackwardVisits &visits);
+    }
+}
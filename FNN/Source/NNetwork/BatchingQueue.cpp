@@ -0,0 +1,286 @@
+#include "BatchingQueue.hpp"
+
+#include <algorithm>
+#include <bit>
+
+using namespace fnn;
+
+namespace
+{
+    /**
+     * @brief Returns histogram bucket of a value
+     * @param value [in] Counted value
+     * @return 0 for value 0, otherwise i such that value lies in [2^(i-1), 2^i)
+     */
+    size_t histogramBucket(const uint64_t value)
+    {
+        return static_cast<size_t>(std::bit_width(value));
+    }
+
+    /**
+     * @brief Copies a histogram without its trailing empty buckets
+     * @param histogram [in] Atomic buckets
+     * @param result [out] Bucket counts
+     */
+    template<size_t Size>
+    void copyHistogram(const std::array<std::atomic<uint64_t>, Size> &histogram, std::vector<uint64_t> &result)
+    {
+        result.clear();
+        for (const auto &bucket : histogram)
+        {
+            result.push_back(bucket.load(std::memory_order_relaxed));
+        }
+        while (! result.empty() && result.back() == 0)
+        {
+            result.pop_back();
+        }
+    }
+}
+
+BatchingQueue::BatchingQueue(std::shared_ptr<const NModel> model, const BatchingOptions &options)
+    : m_options(options)
+    , m_model(std::move(model))
+{
+    Start();
+}
+
+BatchingQueue::BatchingQueue(const ModelPublisher &publisher, const BatchingOptions &options)
+    : m_options(options)
+    , m_publisher(&publisher)
+{
+    Start();
+}
+
+BatchingQueue::~BatchingQueue()
+{
+    Stop();
+}
+
+std::future<std::vector<float>> BatchingQueue::Submit(std::vector<float> x)
+{
+    auto *request = new Request();
+    request->m_input = std::move(x);
+    request->m_submitted = std::chrono::steady_clock::now();
+    auto future = request->m_promise.get_future();
+
+    // Stop waits for submits past this check, so every accepted request is pushed before the stop marker
+    m_submitting.fetch_add(1, std::memory_order_seq_cst);
+    if (m_isStopped.load(std::memory_order_seq_cst))
+    {
+        m_submitting.fetch_sub(1, std::memory_order_release);
+        request->m_promise.set_value({});
+        delete request;
+        return future;
+    }
+    Push(request);
+    m_submitting.fetch_sub(1, std::memory_order_release);
+    m_available.release();
+    return future;
+}
+
+void BatchingQueue::Stop()
+{
+    if (m_isStopped.exchange(true, std::memory_order_seq_cst))
+    {
+        return;
+    }
+    while (m_submitting.load(std::memory_order_seq_cst) != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    // Dispatcher hands out every request before the marker, workers drain all batches before closing
+    Push(&m_stop);
+    m_available.release();
+    m_dispatcher.join();
+    {
+        std::lock_guard lock(m_batchesMutex);
+        m_isClosing = true;
+    }
+    m_batchesReady.notify_all();
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+BatchingStatistics BatchingQueue::Statistics() const
+{
+    BatchingStatistics statistics;
+    statistics.m_requests = m_requests.load(std::memory_order_relaxed);
+    statistics.m_batches = m_batchCount.load(std::memory_order_relaxed);
+    copyHistogram(m_latencyHistogram, statistics.m_latencyHistogram);
+    copyHistogram(m_batchSizeHistogram, statistics.m_batchSizeHistogram);
+    return statistics;
+}
+
+void BatchingQueue::Start()
+{
+    m_options.m_maxBatchSize = std::max<size_t>(m_options.m_maxBatchSize, 1);
+    m_options.m_workers = std::max<size_t>(m_options.m_workers, 1);
+
+    m_head.store(&m_stub, std::memory_order_relaxed);
+    m_tail = &m_stub;
+
+    m_dispatcher = std::thread(&BatchingQueue::Dispatch, this);
+    for (size_t i = 0; i < m_options.m_workers; ++i)
+    {
+        m_workers.emplace_back(&BatchingQueue::Work, this);
+    }
+}
+
+void BatchingQueue::Push(Request *request)
+{
+    request->m_next.store(nullptr, std::memory_order_relaxed);
+    Request *previous = m_head.exchange(request, std::memory_order_acq_rel);
+    // Between exchange and this store the list is briefly unlinked, Pop reports it as empty
+    previous->m_next.store(request, std::memory_order_release);
+}
+
+BatchingQueue::Request *BatchingQueue::Pop()
+{
+    Request *tail = m_tail;
+    Request *next = tail->m_next.load(std::memory_order_acquire);
+    if (tail == &m_stub)
+    {
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+    if (tail != m_head.load(std::memory_order_acquire))
+    {
+        // Producer has not linked its request yet
+        return nullptr;
+    }
+
+    // Last request can only be taken once the stub is behind it
+    Push(&m_stub);
+    next = tail->m_next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+BatchingQueue::Request *BatchingQueue::PopAcquired()
+{
+    // Permit is released after the push, so the request is at most a single store away
+    Request *request = Pop();
+    while (request == nullptr)
+    {
+        std::this_thread::yield();
+        request = Pop();
+    }
+    return request;
+}
+
+void BatchingQueue::Dispatch()
+{
+    bool isStopping = false;
+    while (! isStopping)
+    {
+        m_available.acquire();
+        Request *first = PopAcquired();
+        if (first == &m_stop)
+        {
+            break;
+        }
+
+        // First request bounds how long the whole batch waits
+        std::vector<Request*> batch;
+        batch.reserve(m_options.m_maxBatchSize);
+        batch.push_back(first);
+        const auto deadline = first->m_submitted + m_options.m_maxWait;
+        while (batch.size() < m_options.m_maxBatchSize && m_available.try_acquire_until(deadline))
+        {
+            Request *request = PopAcquired();
+            if (request == &m_stop)
+            {
+                isStopping = true;
+                break;
+            }
+            batch.push_back(request);
+        }
+
+        {
+            std::lock_guard lock(m_batchesMutex);
+            m_batches.push_back(std::move(batch));
+        }
+        m_batchesReady.notify_one();
+    }
+}
+
+void BatchingQueue::Work()
+{
+    InferenceContext context;
+    while (true)
+    {
+        std::vector<Request*> batch;
+        {
+            std::unique_lock lock(m_batchesMutex);
+            m_batchesReady.wait(lock, [this] { return m_isClosing || ! m_batches.empty(); });
+            if (m_batches.empty())
+            {
+                return;
+            }
+            batch = std::move(m_batches.front());
+            m_batches.pop_front();
+        }
+        Complete(context, batch);
+    }
+}
+
+void BatchingQueue::Complete(InferenceContext &context, std::vector<Request*> &batch)
+{
+    FNN_TRACE_SCOPE("BatchPredict");
+
+    // Publisher snapshot is taken once per batch, every request of a batch sees the same weights
+    const auto model = m_publisher != nullptr ? m_publisher->Snapshot() : m_model;
+
+    // Requests with wrong input size are left out of the prediction and complete with empty outputs
+    std::vector<std::vector<float>> inputs;
+    std::vector<Request*> predicted;
+    inputs.reserve(batch.size());
+    predicted.reserve(batch.size());
+    for (Request *request : batch)
+    {
+        if (model != nullptr && request->m_input.size() == model->InputCount())
+        {
+            inputs.push_back(std::move(request->m_input));
+            predicted.push_back(request);
+        }
+        else
+        {
+            request->m_promise.set_value({});
+        }
+    }
+
+    std::vector<std::vector<float>> outputs;
+    const bool isPredicted = ! predicted.empty() && model->Predict(context, inputs, outputs);
+    for (size_t i = 0; i < predicted.size(); ++i)
+    {
+        predicted[i]->m_promise.set_value(isPredicted ? std::move(outputs[i]) : std::vector<float>());
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    for (Request *request : batch)
+    {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - request->m_submitted).count();
+        m_latencyHistogram[histogramBucket(static_cast<uint64_t>(std::max<int64_t>(latency, 0)))].fetch_add(1, std::memory_order_relaxed);
+        delete request;
+    }
+    m_batchSizeHistogram[histogramBucket(batch.size())].fetch_add(1, std::memory_order_relaxed);
+    m_requests.fetch_add(batch.size(), std::memory_order_relaxed);
+    m_batchCount.fetch_add(1, std::memory_order_relaxed);
+}
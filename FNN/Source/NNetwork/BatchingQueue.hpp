@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "ModelPublisher.hpp"
+#include "NModel.hpp"
+
+namespace fnn
+{
+    /**
+     * @struct BatchingOptions
+     * @brief Limits of request coalescing in BatchingQueue
+     */
+    struct BatchingOptions final
+    {
+    public:
+        size_t m_maxBatchSize = 32; ///< Largest number of requests predicted together
+        std::chrono::microseconds m_maxWait = std::chrono::microseconds(200); ///< Longest time the first request of a batch waits for more
+        size_t m_workers = 1; ///< Threads predicting batches
+    };
+
+    /**
+     * @struct BatchingStatistics
+     * @brief Completed requests and batches of a BatchingQueue
+     *
+     * Histogram bucket 0 counts value 0, bucket i > 0 counts values in [2^(i-1), 2^i)
+     */
+    struct BatchingStatistics final
+    {
+    public:
+        uint64_t m_requests = 0; ///< Completed requests
+        uint64_t m_batches = 0; ///< Predicted batches
+        std::vector<uint64_t> m_latencyHistogram; ///< Requests per bucket of microseconds from Submit to completion
+        std::vector<uint64_t> m_batchSizeHistogram; ///< Batches per bucket of requests in the batch
+    };
+
+    /**
+     * @class BatchingQueue
+     * @brief Coalesces single input requests from many threads into batched predictions
+     *
+     * Producers push requests onto a lock-free multi producer single consumer list. A dispatcher thread collects them
+     * into batches until either the maximum batch size is reached or the first request waited the maximum time, then
+     * hands batches to a pool of workers. Every worker owns an InferenceContext and predicts a batch with one call of
+     * NModel::Predict, completing the future of each request
+     */
+    class BatchingQueue final
+    {
+    public:
+        /**
+         * @brief Starts dispatcher and workers serving a fixed model
+         * @param model [in] Model predicting all requests
+         * @param options [in] Batch limits and number of workers
+         */
+        explicit BatchingQueue(std::shared_ptr<const NModel> model, const BatchingOptions &options = BatchingOptions());
+
+        /**
+         * @brief Starts dispatcher and workers serving the latest snapshot of a publisher
+         * @param publisher [in] Publisher whose snapshot predicts each batch, must outlive the queue
+         * @param options [in] Batch limits and number of workers
+         */
+        explicit BatchingQueue(const ModelPublisher &publisher, const BatchingOptions &options = BatchingOptions());
+
+        BatchingQueue(const BatchingQueue&) = delete;
+        BatchingQueue &operator=(const BatchingQueue&) = delete;
+
+        /**
+         * @brief Completes all submitted requests and stops threads
+         */
+        ~BatchingQueue();
+
+        /**
+         * @brief Queues a single input vector, safe to call from any thread
+         * @param x [in] Input features
+         * @return Future of predicted outputs, empty when input has wrong size, no model is available or queue is stopped
+         */
+        std::future<std::vector<float>> Submit(std::vector<float> x);
+
+        /**
+         * @brief Completes all submitted requests and stops threads, later submits complete with empty outputs
+         */
+        void Stop();
+
+        /**
+         * @brief Returns counts and histograms of completed work, safe to call from any thread
+         * @return Snapshot of statistics
+         */
+        BatchingStatistics Statistics() const;
+
+    private:
+        /**
+         * @struct Request
+         * @brief Single queued input and its completion
+         */
+        struct Request final
+        {
+        public:
+            std::vector<float> m_input; ///< Input features
+            std::promise<std::vector<float>> m_promise; ///< Completed with predicted outputs
+            std::chrono::steady_clock::time_point m_submitted; ///< Time of Submit
+            std::atomic<Request*> m_next = nullptr; ///< Next request in the list
+        };
+
+        static constexpr size_t HISTOGRAM_BUCKETS = 65; ///< Buckets of both histograms, enough for any 64 bit value
+
+        BatchingOptions m_options; ///< Batch limits and number of workers
+        std::shared_ptr<const NModel> m_model; ///< Fixed model, nullptr when serving a publisher
+        const ModelPublisher *m_publisher = nullptr; ///< Publisher of served snapshots, nullptr when serving a fixed model
+
+        // Lock-free list, producers exchange m_head, only the dispatcher touches m_tail
+        std::atomic<Request*> m_head; ///< Most recently pushed request
+        Request *m_tail = nullptr; ///< Oldest request not yet taken by the dispatcher
+        Request m_stub; ///< Placeholder keeping the list non empty
+        Request m_stop; ///< Pushed last by Stop, ends dispatching
+        std::counting_semaphore<> m_available{ 0 }; ///< One permit per pushed request
+        std::atomic<bool> m_isStopped = false; ///< Submit no longer accepts requests
+        std::atomic<size_t> m_submitting = 0; ///< Submits between the stopped check and their push
+
+        // Batches waiting for a worker
+        std::mutex m_batchesMutex; ///< Guards m_batches and m_isClosing
+        std::condition_variable m_batchesReady; ///< Signals new batches or closing
+        std::deque<std::vector<Request*>> m_batches; ///< Batches in dispatch order
+        bool m_isClosing = false; ///< Workers exit once no batch is left
+
+        std::thread m_dispatcher; ///< Collects requests into batches
+        std::vector<std::thread> m_workers; ///< Predict batches
+
+        std::atomic<uint64_t> m_requests = 0; ///< Completed requests
+        std::atomic<uint64_t> m_batchCount = 0; ///< Predicted batches
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> m_latencyHistogram{}; ///< Requests per latency bucket
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> m_batchSizeHistogram{}; ///< Batches per size bucket
+
+        /**
+         * @brief Starts dispatcher and workers
+         */
+        void Start();
+
+        /**
+         * @brief Appends request to the list, safe to call from any thread
+         * @param request [in] Request to append
+         */
+        void Push(Request *request);
+
+        /**
+         * @brief Takes oldest request of the list, called by the dispatcher only
+         * @return Oldest request, nullptr when list is empty or a push is not finished yet
+         */
+        Request *Pop();
+
+        /**
+         * @brief Takes a request after a permit was acquired, waiting for an unfinished push
+         * @return Oldest request
+         */
+        Request *PopAcquired();
+
+        /**
+         * @brief Collects requests into batches until Stop
+         */
+        void Dispatch();
+
+        /**
+         * @brief Predicts batches until closing
+         */
+        void Work();
+
+        /**
+         * @brief Predicts one batch and completes its requests
+         * @param context [in, out] Activations of the worker
+         * @param batch [in] Requests to complete, deleted afterwards
+         */
+        void Complete(InferenceContext &context, std::vector<Request*> &batch);
+    };
+}
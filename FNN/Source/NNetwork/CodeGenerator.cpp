@@ -0,0 +1,428 @@
+#include "CodeGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#include "../Activation/ActivationApproximation.hpp"
+#include "../Activation/ActivationStrategy.hpp"
+#include "../Neuron/NeuronStrategy.hpp"
+
+using namespace fnn;
+
+namespace
+{
+    /**
+     * @brief Formats float as C++ literal that reads back to the same value
+     * @param value [in] Value to format
+     * @return Hexadecimal float literal, or limits expression for infinities and NaN
+     */
+    std::string floatLiteral(const float value)
+    {
+        if (std::isnan(value))
+        {
+            return "std::numeric_limits<float>::quiet_NaN()";
+        }
+        if (std::isinf(value))
+        {
+            return value > 0.0f ? "std::numeric_limits<float>::infinity()" : "-std::numeric_limits<float>::infinity()";
+        }
+
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%af", static_cast<double>(value));
+        return buffer;
+    }
+
+    /**
+     * @brief Appends comma separated literals, eight per line
+     * @param source [in, out] Source to append to
+     * @param values [in] Values to format
+     * @param indent [in] Indentation of every line
+     */
+    void appendValues(std::string &source, const std::vector<float> &values, const std::string &indent)
+    {
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            source += i % 8 == 0 ? indent : " ";
+            source += floatLiteral(values[i]);
+            source += i + 1 < values.size() ? "," : "";
+            source += i % 8 == 7 || i + 1 == values.size() ? "\n" : "";
+        }
+    }
+
+    /**
+     * @struct ActivationSource
+     * @brief Generated body of one activation instance and helpers it calls
+     */
+    struct ActivationSource final
+    {
+    public:
+        std::string m_body; ///< Expression of input returning the activated value
+        bool m_usesRational = false; ///< Body calls generated TanhRational
+        bool m_usesLookup = false; ///< Body calls generated TanhLookup
+    };
+
+    /**
+     * @brief Translates activation strategy into generated expression, mirroring its Activation exactly
+     * @param function [in] Activation strategy of a neuron
+     * @param activation [out] Generated expression
+     * @return True if the strategy is known, false otherwise
+     */
+    bool activationSource(const INeuronFunctionStrategy *function, ActivationSource &activation)
+    {
+        if (dynamic_cast<const EmptyActivationStrategy*>(function) != nullptr ||
+            dynamic_cast<const LinearStrategy*>(function) != nullptr)
+        {
+            activation.m_body = "input";
+            return true;
+        }
+        if (const auto *relu = dynamic_cast<const ReLUStrategy*>(function))
+        {
+            activation.m_body = "input >= " + floatLiteral(relu->m_threshold) + " ? 1.0f : 0.0f";
+            return true;
+        }
+        if (dynamic_cast<const SigmoidStrategy*>(function) != nullptr)
+        {
+            activation.m_body = "1.0f / (1.0f + std::exp(-1.0f * input))";
+            return true;
+        }
+        if (dynamic_cast<const TanhStrategy*>(function) != nullptr)
+        {
+            activation.m_body = "std::tanh(input)";
+            return true;
+        }
+        if (const auto *sigmoid = dynamic_cast<const FastSigmoidStrategy*>(function))
+        {
+            const bool lookup = sigmoid->m_mode == ApproximationMode::LookupTable;
+            activation.m_body = lookup ? "0.5f * TanhLookup(0.5f * input) + 0.5f" : "0.5f * TanhRational(0.5f * input) + 0.5f";
+            activation.m_usesLookup = lookup;
+            activation.m_usesRational = ! lookup;
+            return true;
+        }
+        if (const auto *tanh = dynamic_cast<const FastTanhStrategy*>(function))
+        {
+            const bool lookup = tanh->m_mode == ApproximationMode::LookupTable;
+            activation.m_body = lookup ? "TanhLookup(input)" : "TanhRational(input)";
+            activation.m_usesLookup = lookup;
+            activation.m_usesRational = ! lookup;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns generated copy of approximation::TanhRational
+     * @return Source of the function
+     */
+    std::string tanhRationalSource()
+    {
+        return
+            "    inline float TanhRational(const float input)\n"
+            "    {\n"
+            "        const float x = std::clamp(input, -7.90531110763549805f, 7.90531110763549805f);\n"
+            "        const float x2 = x * x;\n"
+            "\n"
+            "        float p = -2.76076847742355e-16f;\n"
+            "        p = p * x2 + 2.00018790482477e-13f;\n"
+            "        p = p * x2 - 8.60467152213735e-11f;\n"
+            "        p = p * x2 + 5.12229709037114e-08f;\n"
+            "        p = p * x2 + 1.48572235717979e-05f;\n"
+            "        p = p * x2 + 6.37261928875436e-04f;\n"
+            "        p = p * x2 + 4.89352455891786e-03f;\n"
+            "        p = p * x;\n"
+            "\n"
+            "        float q = 1.19825839466702e-06f;\n"
+            "        q = q * x2 + 1.18534705686654e-04f;\n"
+            "        q = q * x2 + 2.26843463243900e-03f;\n"
+            "        q = q * x2 + 4.89352518554385e-03f;\n"
+            "\n"
+            "        return p / q;\n"
+            "    }\n\n";
+    }
+
+    /**
+     * @brief Returns generated copy of approximation::TanhLookup including its table
+     * @return Source of the table and function
+     */
+    std::string tanhLookupSource()
+    {
+        const auto &table = approximation::tanhTable();
+        const std::string range = floatLiteral(approximation::TANH_TABLE_RANGE);
+        const float scale = static_cast<float>(approximation::TANH_TABLE_SIZE - 1) / (2.0f * approximation::TANH_TABLE_RANGE);
+
+        std::string source = "    constexpr float TANH_TABLE[" + std::to_string(table.size()) + "] =\n    {\n";
+        appendValues(source, std::vector<float>(table.begin(), table.end()), "        ");
+        source +=
+            "    };\n\n"
+            "    inline float TanhLookup(const float input)\n"
+            "    {\n"
+            "        const float position = (std::clamp(input, -" + range + ", " + range + ") + " + range + ") * " + floatLiteral(scale) + ";\n"
+            "        const std::size_t index = std::min(static_cast<std::size_t>(position), std::size_t(" + std::to_string(table.size() - 2) + "));\n"
+            "        const float fraction = position - static_cast<float>(index);\n"
+            "\n"
+            "        return TANH_TABLE[index] + (TANH_TABLE[index + 1] - TANH_TABLE[index]) * fraction;\n"
+            "    }\n\n";
+        return source;
+    }
+}
+
+bool utility::generateSource(NNetwork &network, const CodeGenerationOptions &options, std::string &source)
+{
+    FNN_TRACE_SCOPE("GenerateSource");
+
+    const auto &graph = network.m_network;
+    if (graph == nullptr || graph->Size() == 0 || graph->m_inputs.empty() || graph->m_outputs.empty())
+    {
+        return false;
+    }
+
+    // Predict rejects cyclic graphs and provides expected outputs of the self check
+    std::vector<std::vector<float>> expected;
+    if (! network.Predict(options.m_checkInputs, expected))
+    {
+        return false;
+    }
+
+    // Every slot of the generated value array, inputs first
+    std::unordered_map<const Neuron*, size_t> positions;
+    std::vector<size_t> inputPositions;
+    size_t slots = 0;
+    for (const auto inputKey : graph->m_inputs)
+    {
+        const auto &neuron = graph->GetNeuron(inputKey);
+        if (neuron == nullptr)
+        {
+            return false;
+        }
+        const auto inserted = positions.emplace(neuron.get(), slots);
+        slots += inserted.second ? 1 : 0;
+        inputPositions.push_back(inserted.first->second);
+    }
+
+    // Neurons ForwardPropagate evaluates, in the order of the level index
+    std::vector<const Neuron*> evaluated;
+    for (size_t level = 1; level < graph->LevelCount(); ++level)
+    {
+        for (const auto neuronKey : graph->GetLevel(level))
+        {
+            const auto &neuron = graph->GetNeuron(neuronKey);
+            if (neuron->m_neuronType == NeuronType::Input ||
+                ! neuron->m_valueCalculation.has_value() ||
+                ! neuron->m_headConnections.has_value() ||
+                ! neuron->m_activationFunction.has_value() ||
+                neuron->m_activationFunction.value() == nullptr)
+            {
+                continue;
+            }
+            if (positions.emplace(neuron.get(), slots).second)
+            {
+                evaluated.push_back(neuron.get());
+                ++slots;
+            }
+        }
+    }
+
+    // Neurons read but never evaluated keep their current value, so they become constants
+    std::vector<std::pair<size_t, float>> constants;
+    const auto slotOf = [&](const Neuron *neuron)
+    {
+        const auto inserted = positions.emplace(neuron, slots);
+        if (inserted.second)
+        {
+            constants.emplace_back(slots++, neuron->m_value);
+        }
+        return inserted.first->second;
+    };
+
+    std::unordered_map<const INeuronFunctionStrategy*, size_t> activationIndices;
+    std::vector<ActivationSource> activations;
+    std::vector<float> weights;
+    std::string statements;
+    for (const Neuron *neuron : evaluated)
+    {
+        const auto *valueStrategy = neuron->m_valueCalculation.value().get();
+        const bool isSparse = dynamic_cast<const SparseNeuronValueStrategy*>(valueStrategy) != nullptr;
+        if (! isSparse && dynamic_cast<const NeuronValueStrategy*>(valueStrategy) == nullptr)
+        {
+            // Custom value strategies have no known expression
+            return false;
+        }
+
+        const auto *function = neuron->m_activationFunction.value().get();
+        const auto found = activationIndices.emplace(function, activations.size());
+        if (found.second)
+        {
+            ActivationSource activation;
+            if (! activationSource(function, activation))
+            {
+                return false;
+            }
+            activations.push_back(std::move(activation));
+        }
+
+        const size_t position = positions.at(neuron);
+        const auto &headEdges = neuron->m_headConnections.value();
+        if (headEdges.empty())
+        {
+            // Value strategies return zero without head connections
+            statements += "        v[" + std::to_string(position) + "] = 0.0f;\n";
+            continue;
+        }
+
+        std::vector<std::string> terms;
+        terms.reserve(headEdges.size());
+        for (const auto &edge : headEdges)
+        {
+            if (edge.m_head == nullptr)
+            {
+                return false;
+            }
+            terms.push_back("v[" + std::to_string(slotOf(edge.m_head.get())) + "] * W[" + std::to_string(weights.size()) + "]");
+            weights.push_back(edge.m_weight);
+        }
+
+        statements += "        {\n            float s = 0.0f;\n";
+        size_t term = 0;
+        if (! isSparse)
+        {
+            for (; terms.size() - term >= 4; term += 4)
+            {
+                statements += "            s = s + ((" + terms[term] + " + " + terms[term + 1] + ") + (" + terms[term + 2] + " + " + terms[term + 3] + "));\n";
+            }
+        }
+        for (; term < terms.size(); ++term)
+        {
+            statements += "            s = s + " + terms[term] + ";\n";
+        }
+        statements += "            v[" + std::to_string(position) + "] = A" + std::to_string(found.first->second) + "(s);\n        }\n";
+    }
+
+    std::vector<size_t> outputPositions;
+    for (const auto outputKey : graph->m_outputs)
+    {
+        const auto &neuron = graph->GetNeuron(outputKey);
+        if (neuron == nullptr)
+        {
+            return false;
+        }
+        outputPositions.push_back(slotOf(neuron.get()));
+    }
+
+    const std::string inputCount = std::to_string(graph->m_inputs.size());
+    const std::string outputCount = std::to_string(graph->m_outputs.size());
+
+    source =
+        "// Generated by FNN, do not edit\n"
+        "// Network of " + std::to_string(graph->Size()) + " neurons, " + std::to_string(evaluated.size()) + " evaluated and " + std::to_string(weights.size()) + " weights\n"
+        "// Compile with -ffp-contract=off for outputs bit identical to NNetwork::Predict\n"
+        "#include <algorithm>\n"
+        "#include <cmath>\n"
+        "#include <cstddef>\n"
+        "#include <limits>\n"
+        "\n"
+        "namespace " + options.m_namespace + "\n"
+        "{\n"
+        "    constexpr std::size_t INPUTS = " + inputCount + ";\n"
+        "    constexpr std::size_t OUTPUTS = " + outputCount + ";\n\n";
+
+    if (! weights.empty())
+    {
+        source += "    constexpr float W[" + std::to_string(weights.size()) + "] =\n    {\n";
+        appendValues(source, weights, "        ");
+        source += "    };\n\n";
+    }
+
+    const bool usesRational = std::ranges::any_of(activations, [](const ActivationSource &activation) { return activation.m_usesRational; });
+    const bool usesLookup = std::ranges::any_of(activations, [](const ActivationSource &activation) { return activation.m_usesLookup; });
+    source += usesRational ? tanhRationalSource() : "";
+    source += usesLookup ? tanhLookupSource() : "";
+
+    for (size_t i = 0; i < activations.size(); ++i)
+    {
+        source += "    inline float A" + std::to_string(i) + "(const float input)\n    {\n        return " + activations[i].m_body + ";\n    }\n\n";
+    }
+
+    source +=
+        "    inline void " + options.m_functionName + "(const float *input, float *output)\n"
+        "    {\n"
+        "        float v[" + std::to_string(slots) + "];\n";
+    for (size_t i = 0; i < inputPositions.size(); ++i)
+    {
+        source += "        v[" + std::to_string(inputPositions[i]) + "] = input[" + std::to_string(i) + "];\n";
+    }
+    for (const auto &[position, value] : constants)
+    {
+        source += "        v[" + std::to_string(position) + "] = " + floatLiteral(value) + ";\n";
+    }
+    source += statements;
+    for (size_t i = 0; i < outputPositions.size(); ++i)
+    {
+        source += "        output[" + std::to_string(i) + "] = v[" + std::to_string(outputPositions[i]) + "];\n";
+    }
+    source += "    }\n}\n";
+
+    if (options.m_checkInputs.empty())
+    {
+        return true;
+    }
+
+    // Self check compares generated outputs to the ones Predict returned above
+    const std::string rows = std::to_string(options.m_checkInputs.size());
+    source +=
+        "\n#if defined(FNN_GENERATED_SELF_CHECK)\n"
+        "#include <cstdio>\n"
+        "\n"
+        "int main()\n"
+        "{\n"
+        "    constexpr float CHECK_INPUTS[" + rows + "][" + inputCount + "] =\n    {\n";
+    for (const auto &row : options.m_checkInputs)
+    {
+        source += "        {\n";
+        appendValues(source, row, "            ");
+        source += "        },\n";
+    }
+    source += "    };\n    constexpr float CHECK_OUTPUTS[" + rows + "][" + outputCount + "] =\n    {\n";
+    for (const auto &row : expected)
+    {
+        source += "        {\n";
+        appendValues(source, row, "            ");
+        source += "        },\n";
+    }
+    source +=
+        "    };\n"
+        "\n"
+        "    int failures = 0;\n"
+        "    float largest = 0.0f;\n"
+        "    for (std::size_t row = 0; row < " + rows + "; ++row)\n"
+        "    {\n"
+        "        float output[" + options.m_namespace + "::OUTPUTS];\n"
+        "        " + options.m_namespace + "::" + options.m_functionName + "(CHECK_INPUTS[row], output);\n"
+        "        for (std::size_t i = 0; i < " + options.m_namespace + "::OUTPUTS; ++i)\n"
+        "        {\n"
+        "            const float difference = std::fabs(output[i] - CHECK_OUTPUTS[row][i]);\n"
+        "            largest = std::max(largest, difference);\n"
+        "            failures += difference <= " + floatLiteral(options.m_checkTolerance) + " ? 0 : 1;\n"
+        "        }\n"
+        "    }\n"
+        "\n"
+        "    printf(\"%d outputs differ by more than %g, largest difference %g\\n\", failures, " + floatLiteral(options.m_checkTolerance) + ", largest);\n"
+        "    return failures == 0 ? 0 : 1;\n"
+        "}\n"
+        "#endif\n";
+    return true;
+}
+
+bool utility::writeSource(NNetwork &network, const CodeGenerationOptions &options, const std::string &path)
+{
+    std::string source;
+    if (! generateSource(network, options, source))
+    {
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(source.data(), static_cast<std::streamsize>(source.size()));
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @struct CodeGenerationOptions
+     * @brief Settings of generated inference source
+     */
+    struct CodeGenerationOptions final
+    {
+    public:
+        std::string m_namespace = "fnn_generated"; ///< Namespace enclosing generated constants and functions
+        std::string m_functionName = "Predict"; ///< Name of generated inference function
+        std::vector<std::vector<float>> m_checkInputs; ///< Inputs of the self check, no self check is emitted when empty
+        float m_checkTolerance = 1e-5f; ///< Largest absolute difference to Predict the self check accepts
+    };
+
+    namespace utility
+    {
+        /**
+         * @brief Generates standalone C++ source evaluating a network without the library
+         *
+         * Weights become constexpr arrays and the inference function evaluates one block per neuron in level order,
+         * summing head edges in the same association as NeuronValueStrategy. Compiled without floating point
+         * contraction (e.g. -ffp-contract=off) outputs equal NNetwork::Predict exactly, otherwise to rounding.
+         * With check inputs the source contains a main, enabled by defining FNN_GENERATED_SELF_CHECK, comparing
+         * generated outputs to the ones Predict returned during generation
+         *
+         * Supported are default and sparse value strategies and all activation strategies of the library
+         * @param network [in, out] Network to export, Predict of check inputs changes its neuron values
+         * @param options [in] Names and self check settings
+         * @param source [out] Generated source
+         * @return True if source was generated, false for cyclic graphs and unsupported strategies
+         */
+        bool generateSource(NNetwork &network, const CodeGenerationOptions &options, std::string &source);
+
+        /**
+         * @brief Generates source and writes it to file
+         * @param network [in, out] Network to export
+         * @param options [in] Names and self check settings
+         * @param path [in] Path of the written file
+         * @return True if source was generated and written, false otherwise
+         */
+        bool writeSource(NNetwork &network, const CodeGenerationOptions &options, const std::string &path);
+    }
+}
@@ -0,0 +1,375 @@
+#include "DataParallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+using namespace fnn;
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace
+{
+    /**
+     * @struct Worker
+     * @brief Forked worker process watched by the calling process
+     */
+    struct Worker final
+    {
+    public:
+        pid_t m_pid = 0; ///< Process id
+        int m_status = 0; ///< Wait status once reaped
+        bool m_isReaped = false; ///< True once the process was waited for
+    };
+
+    /**
+     * @class SharedRing
+     * @brief Barrier and ring all-reduce of float vectors between forked processes
+     *
+     * Every worker owns one slot of the mapping. The vector is split into one chunk per worker, reduce-scatter passes
+     * partial sums around the ring until each worker holds one complete chunk, all-gather then passes complete chunks
+     * around until every slot holds the whole sum. Each step reads only the left neighbour's slot
+     */
+    class SharedRing final
+    {
+    public:
+        SharedRing() = default;
+        SharedRing(const SharedRing&) = delete;
+        SharedRing &operator=(const SharedRing&) = delete;
+
+        ~SharedRing()
+        {
+            if (m_mapping != nullptr)
+            {
+                munmap(m_mapping, m_bytes);
+            }
+        }
+
+        /**
+         * @brief Creates shared mapping, must be called before forking
+         * @param workers [in] Number of participating processes
+         * @param length [in] Length of reduced vectors
+         * @return True if mapping was created, false otherwise
+         */
+        bool Open(const size_t workers, const size_t length)
+        {
+            static std::atomic<uint32_t> sequence = 0;
+
+            m_workers = workers;
+            m_length = length;
+            m_bytes = HEADER_BYTES + workers * std::max<size_t>(length, 1) * sizeof(float);
+
+            char name[64];
+            snprintf(name, sizeof(name), "/fnn-allreduce-%ld-%u", static_cast<long>(getpid()), sequence.fetch_add(1));
+
+            const int descriptor = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (descriptor < 0)
+            {
+                return false;
+            }
+
+            // Name is only needed to create the object, forked workers inherit the mapping
+            shm_unlink(name);
+            if (ftruncate(descriptor, static_cast<off_t>(m_bytes)) != 0)
+            {
+                close(descriptor);
+                return false;
+            }
+            void *mapping = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+            close(descriptor);
+            if (mapping == MAP_FAILED)
+            {
+                return false;
+            }
+
+            m_mapping = mapping;
+            m_header = new (mapping) Header();
+            m_slots = reinterpret_cast<float*>(static_cast<char*>(mapping) + HEADER_BYTES);
+            return true;
+        }
+
+        /**
+         * @brief Marks the run as failed, waiting workers return instead of blocking forever
+         */
+        void Fail()
+        {
+            m_header->m_failed.store(1, std::memory_order_release);
+        }
+
+        /**
+         * @brief Watches forked workers while waiting, must be called by the forking process only
+         *
+         * A worker killed by a signal or exiting on its own never calls Fail, the other workers would wait for it
+         * forever. The watching process reaps exited workers while it waits and fails the run when one did not finish
+         * @param workers [in] Forked workers, must outlive the ring
+         */
+        void Watch(std::vector<Worker> &workers)
+        {
+            m_watched = &workers;
+        }
+
+        /**
+         * @brief Waits until every worker arrived
+         * @return True if all workers arrived, false when a worker failed
+         */
+        bool Wait()
+        {
+            const uint32_t generation = m_header->m_generation.load(std::memory_order_acquire);
+            if (m_header->m_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_workers)
+            {
+                m_header->m_arrived.store(0, std::memory_order_relaxed);
+                m_header->m_generation.fetch_add(1, std::memory_order_acq_rel);
+            }
+            else
+            {
+                while (m_header->m_generation.load(std::memory_order_acquire) == generation)
+                {
+                    if (m_header->m_failed.load(std::memory_order_acquire) != 0)
+                    {
+                        return false;
+                    }
+                    if (! ReapWorkers())
+                    {
+                        Fail();
+                        return false;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            return m_header->m_failed.load(std::memory_order_acquire) == 0;
+        }
+
+        /**
+         * @brief Replaces values of every worker by the sum over all workers
+         * @param rank [in] Position of the calling worker in the ring
+         * @param values [in, out] Local values, summed values afterwards
+         * @return True if reduction completed, false when a worker failed
+         */
+        bool AllReduce(const size_t rank, std::vector<float> &values)
+        {
+            float *own = Slot(rank);
+            const float *left = Slot((rank + m_workers - 1) % m_workers);
+            std::copy(values.begin(), values.end(), own);
+            if (! Wait())
+            {
+                return false;
+            }
+
+            // Reduce-scatter, after step s the received chunk holds the sum of s + 2 workers
+            for (size_t step = 0; step + 1 < m_workers; ++step)
+            {
+                const size_t chunk = (rank + 2 * m_workers - 1 - step) % m_workers;
+                for (size_t i = ChunkBegin(chunk); i < ChunkBegin(chunk + 1); ++i)
+                {
+                    own[i] += left[i];
+                }
+                if (! Wait())
+                {
+                    return false;
+                }
+            }
+
+            // All-gather, complete chunks travel around the ring
+            for (size_t step = 0; step + 1 < m_workers; ++step)
+            {
+                const size_t chunk = (rank + m_workers - step) % m_workers;
+                std::copy(left + ChunkBegin(chunk), left + ChunkBegin(chunk + 1), own + ChunkBegin(chunk));
+                if (! Wait())
+                {
+                    return false;
+                }
+            }
+
+            std::copy(own, own + m_length, values.begin());
+            return true;
+        }
+
+    private:
+        /**
+         * @struct Header
+         * @brief Barrier state shared by all workers
+         */
+        struct Header final
+        {
+        public:
+            std::atomic<uint32_t> m_arrived = 0; ///< Workers waiting in the current barrier
+            std::atomic<uint32_t> m_generation = 0; ///< Incremented when all workers arrived
+            std::atomic<uint32_t> m_failed = 0; ///< Non zero once any worker failed
+        };
+
+        static_assert(std::atomic<uint32_t>::is_always_lock_free, "Barrier atomics must be lock free to work across processes");
+        static constexpr size_t HEADER_BYTES = 64; ///< Header rounded up to a cache line, slots start after it
+
+        void *m_mapping = nullptr; ///< Shared mapping
+        size_t m_bytes = 0; ///< Size of the mapping
+        Header *m_header = nullptr; ///< Barrier state at the start of the mapping
+        float *m_slots = nullptr; ///< One vector per worker
+        size_t m_workers = 0; ///< Number of workers
+        size_t m_length = 0; ///< Length of reduced vectors
+        std::vector<Worker> *m_watched = nullptr; ///< Forked workers, only set in the forking process
+
+        /**
+         * @brief Reaps exited workers without blocking
+         *
+         * A worker exits successfully only after passing every barrier, so it can never be the one still awaited
+         * @return False if a worker exited unsuccessfully, true otherwise
+         */
+        bool ReapWorkers()
+        {
+            if (m_watched == nullptr)
+            {
+                return true;
+            }
+
+            bool isHealthy = true;
+            for (Worker &worker : *m_watched)
+            {
+                if (! worker.m_isReaped && waitpid(worker.m_pid, &worker.m_status, WNOHANG) == worker.m_pid)
+                {
+                    worker.m_isReaped = true;
+                }
+                if (worker.m_isReaped && (! WIFEXITED(worker.m_status) || WEXITSTATUS(worker.m_status) != 0))
+                {
+                    isHealthy = false;
+                }
+            }
+            return isHealthy;
+        }
+
+        /**
+         * @brief Returns slot of a worker
+         * @param rank [in] Worker position
+         * @return First element of the slot
+         */
+        float *Slot(const size_t rank) const
+        {
+            return m_slots + rank * std::max<size_t>(m_length, 1);
+        }
+
+        /**
+         * @brief Returns first element of a chunk
+         * @param chunk [in] Chunk index, m_workers returns the vector length
+         * @return Element index
+         */
+        size_t ChunkBegin(const size_t chunk) const
+        {
+            return chunk * m_length / m_workers;
+        }
+    };
+
+    /**
+     * @brief Runs mini-batch training of one worker
+     * @param network [in, out] Replica of the worker
+     * @param ring [in] Shared all-reduce
+     * @param rank [in] Worker position
+     * @param workers [in] Number of workers
+     * @return True if training is successful, false otherwise
+     */
+    bool trainWorker(NNetwork &network, SharedRing &ring, const size_t rank, const size_t workers,
+                     const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const size_t batchSize)
+    {
+        std::vector<float> deltas;
+        for (size_t epoch = 0; epoch < epochs; ++epoch)
+        {
+            for (size_t begin = 0; begin < trainX.size(); begin += batchSize)
+            {
+                const size_t end = std::min(begin + batchSize, trainX.size());
+
+                // Shard is every workers-th sample of the batch, starting at rank
+                deltas.assign(network.WeightCount(), 0.0f);
+                for (size_t i = begin + rank; i < end; i += workers)
+                {
+                    if (! network.AccumulateWeightDeltas(trainX[i], trainY[i], deltas))
+                    {
+                        ring.Fail();
+                        return false;
+                    }
+                }
+
+                if (! ring.AllReduce(rank, deltas))
+                {
+                    return false;
+                }
+                network.ApplyWeightDeltas(deltas, 1.0f / static_cast<float>(end - begin));
+            }
+        }
+        return true;
+    }
+}
+#endif
+
+bool utility::dataParallelFit(NNetwork &network, const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY,
+                              const size_t epochs, const size_t batchSize, const size_t workers)
+{
+    FNN_TRACE_SCOPE("DataParallelFit");
+
+    if (workers <= 1)
+    {
+        return network.FitMiniBatch(trainX, trainY, epochs, batchSize);
+    }
+    if (network.m_network == nullptr || network.m_network->Size() == 0 || trainX.size() != trainY.size() || batchSize == 0)
+    {
+        return false;
+    }
+    if (network.HasCycleForward() || network.HasCycleBackward())
+    {
+        return false;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    SharedRing ring;
+    if (! ring.Open(workers, network.WeightCount()))
+    {
+        return false;
+    }
+
+    // The calling process is rank 0, so its replica ends up with the trained weights
+    std::vector<Worker> children;
+    for (size_t rank = 1; rank < workers; ++rank)
+    {
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            const bool trained = trainWorker(network, ring, rank, workers, trainX, trainY, epochs, batchSize);
+            _exit(trained ? 0 : 1);
+        }
+        if (child < 0)
+        {
+            ring.Fail();
+            break;
+        }
+        children.push_back(Worker{ child });
+    }
+    ring.Watch(children);
+
+    bool trained = children.size() + 1 == workers && trainWorker(network, ring, 0, workers, trainX, trainY, epochs, batchSize);
+    if (! trained)
+    {
+        ring.Fail();
+    }
+
+    for (Worker &child : children)
+    {
+        if (! child.m_isReaped)
+        {
+            child.m_isReaped = waitpid(child.m_pid, &child.m_status, 0) == child.m_pid;
+        }
+        if (! child.m_isReaped || ! WIFEXITED(child.m_status) || WEXITSTATUS(child.m_status) != 0)
+        {
+            trained = false;
+        }
+    }
+    return trained;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    namespace utility
+    {
+        /**
+         * @brief Trains network with mini-batches split between forked worker processes
+         *
+         * The calling process and workers - 1 forked processes each hold a replica of the network and process every
+         * workers-th sample of a batch. Weight changes are summed through a ring all-reduce in POSIX shared memory
+         * after every batch, so all replicas apply the same averaged update and stay identical. The result matches
+         * NNetwork::FitMiniBatch up to rounding of the summation order. Only available on POSIX systems.
+         * Workers are forked, which copies only the calling thread: the caller must not have other live threads, e.g.
+         * AsyncExecutor, BatchingQueue or InferencePipeline workers, nor a tracer recording on another thread, or a
+         * worker may deadlock on a mutex that was copied while locked. A worker that dies, e.g. from a signal, fails
+         * the run instead of leaving the others waiting for it
+         * @param network [in, out] Network to train, holds the trained weights afterwards
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations
+         * @param batchSize [in] Samples per weight update
+         * @param workers [in] Number of processes including the calling one
+         * @return True if training is successful in all workers, false otherwise
+         */
+        bool dataParallelFit(NNetwork &network, const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY,
+                             const size_t epochs, const size_t batchSize, const size_t workers);
+    }
+}
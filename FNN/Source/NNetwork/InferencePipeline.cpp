@@ -0,0 +1,168 @@
+#include "InferencePipeline.hpp"
+
+#include <algorithm>
+#include <bit>
+
+using namespace fnn;
+
+InferencePipeline::BlockQueue::BlockQueue(const size_t capacity)
+    : m_ring(std::bit_ceil(capacity), nullptr)
+    , m_mask(m_ring.size() - 1)
+{
+}
+
+void InferencePipeline::BlockQueue::Push(Block *block)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    m_ring[tail & m_mask] = block;
+    m_tail.store(tail + 1, std::memory_order_release);
+    m_tail.notify_one();
+}
+
+InferencePipeline::Block *InferencePipeline::BlockQueue::Pop()
+{
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    while (tail == m_head)
+    {
+        m_tail.wait(tail, std::memory_order_acquire);
+        tail = m_tail.load(std::memory_order_acquire);
+    }
+    return m_ring[m_head++ & m_mask];
+}
+
+InferencePipeline::InferencePipeline(std::shared_ptr<const NModel> model, const size_t stages, const size_t blocks)
+    : m_model(std::move(model))
+{
+    if (m_model == nullptr)
+    {
+        return;
+    }
+
+    // Stages end where the running edge count passes their share, every neuron also counts as one edge
+    const size_t neurons = m_model->m_slots.size();
+    const size_t stageCount = std::clamp<size_t>(stages, 1, std::max<size_t>(neurons, 1));
+    const size_t totalCost = m_model->m_parents.size() + neurons;
+    m_bounds.push_back(0);
+    size_t cost = 0;
+    for (size_t n = 0; n < neurons && m_bounds.size() < stageCount; ++n)
+    {
+        cost += m_model->m_offsets[n + 1] - m_model->m_offsets[n] + 1;
+        if (cost * stageCount >= totalCost * m_bounds.size())
+        {
+            m_bounds.push_back(n + 1);
+        }
+    }
+    while (m_bounds.size() < stageCount)
+    {
+        m_bounds.push_back(neurons);
+    }
+    m_bounds.push_back(neurons);
+
+    // Every queue can hold all blocks and the stopping nullptr at once
+    m_blocks.resize(std::max<size_t>(blocks, 1));
+    for (size_t q = 0; q <= stageCount; ++q)
+    {
+        m_queues.push_back(std::make_unique<BlockQueue>(m_blocks.size() + 1));
+    }
+    for (auto &block : m_blocks)
+    {
+        m_model->InitializeLanes(block.m_lanes);
+        m_free.push_back(&block);
+    }
+
+    for (size_t stage = 0; stage < stageCount; ++stage)
+    {
+        m_stages.emplace_back(&InferencePipeline::RunStage, this, stage);
+    }
+}
+
+InferencePipeline::~InferencePipeline()
+{
+    if (! m_stages.empty())
+    {
+        m_queues.front()->Push(nullptr);
+    }
+    for (auto &stage : m_stages)
+    {
+        stage.join();
+    }
+}
+
+bool InferencePipeline::Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output)
+{
+    FNN_TRACE_SCOPE("PipelinePredict");
+
+    output.clear();
+    if (m_model == nullptr)
+    {
+        return false;
+    }
+    for (const auto &inputVector : testX)
+    {
+        if (inputVector.size() != m_model->InputCount())
+        {
+            // Input layer has different size than inserted inputs
+            return false;
+        }
+    }
+
+    std::lock_guard lock(m_predictMutex);
+    output.resize(testX.size());
+    m_output = &output;
+
+    // Blocks come back from the last stage, which limits how far the first stage runs ahead
+    BlockQueue &returned = *m_queues.back();
+    size_t inFlight = 0;
+    for (size_t begin = 0; begin < testX.size(); begin += NModel::LANES)
+    {
+        Block *block = nullptr;
+        if (m_free.empty())
+        {
+            block = returned.Pop();
+            --inFlight;
+        }
+        else
+        {
+            block = m_free.back();
+            m_free.pop_back();
+        }
+        block->m_begin = begin;
+        block->m_count = std::min(NModel::LANES, testX.size() - begin);
+        m_model->LoadLanes(block->m_lanes.data(), testX, begin, block->m_count);
+        m_queues.front()->Push(block);
+        ++inFlight;
+    }
+
+    // Outputs are complete once every block left the last stage
+    for (; inFlight > 0; --inFlight)
+    {
+        m_free.push_back(returned.Pop());
+    }
+    m_output = nullptr;
+    return true;
+}
+
+size_t InferencePipeline::StageCount() const
+{
+    return m_stages.size();
+}
+
+void InferencePipeline::RunStage(const size_t stage)
+{
+    BlockQueue &input = *m_queues[stage];
+    BlockQueue &next = *m_queues[stage + 1];
+    const bool isLast = stage + 2 == m_bounds.size();
+    while (Block *block = input.Pop())
+    {
+        m_model->EvaluateLanes(block->m_lanes.data(), block->m_count, m_bounds[stage], m_bounds[stage + 1]);
+        if (isLast)
+        {
+            m_model->StoreLanes(block->m_lanes.data(), block->m_count, *m_output, block->m_begin);
+        }
+        next.Push(block);
+    }
+    if (! isLast)
+    {
+        next.Push(nullptr);
+    }
+}
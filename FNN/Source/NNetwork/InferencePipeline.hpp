@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NModel.hpp"
+
+namespace fnn
+{
+    /**
+     * @class InferencePipeline
+     * @brief Streams blocks of input vectors through stages of a compiled model running on separate threads
+     *
+     * Evaluated neurons of the model are split in level order into contiguous stages with about the same number of
+     * edges, every stage runs on its own thread. Blocks of NModel::LANES input vectors travel from stage to stage
+     * through bounded lock-free single producer single consumer queues, so consecutive blocks are evaluated by
+     * different stages at the same time. Each stage only touches its own part of the weights, which suits deep narrow
+     * networks whose batch Predict is bound by per block latency or by weights not fitting into one core's cache.
+     * Results equal NModel::Predict
+     */
+    class InferencePipeline final
+    {
+    public:
+        /**
+         * @brief Splits the model into stages and starts their threads
+         * @param model [in] Model to evaluate
+         * @param stages [in] Requested number of stages, limited to the number of evaluated neurons
+         * @param blocks [in] Blocks in flight, bounds memory and how far the first stage may run ahead
+         */
+        InferencePipeline(std::shared_ptr<const NModel> model, const size_t stages, const size_t blocks = 8);
+
+        InferencePipeline(const InferencePipeline&) = delete;
+        InferencePipeline &operator=(const InferencePipeline&) = delete;
+
+        /**
+         * @brief Stops stage threads
+         */
+        ~InferencePipeline();
+
+        /**
+         * @brief Predicts outputs of every input vector, calls from several threads are served one after another
+         * @param testX [in] Input features for prediction
+         * @param output [out] Predicted outputs
+         * @return True if prediction is successful, false when model is nullptr or an input vector has wrong size
+         */
+        bool Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output);
+
+        /**
+         * @brief Returns number of stages
+         * @return Stage thread count
+         */
+        size_t StageCount() const;
+
+    private:
+        /**
+         * @struct Block
+         * @brief Lane values of up to NModel::LANES input vectors in flight
+         */
+        struct Block final
+        {
+        public:
+            std::vector<float> m_lanes; ///< Values of every slot, element [slot * NModel::LANES + lane]
+            size_t m_begin = 0; ///< Input vector of the first lane
+            size_t m_count = 0; ///< Number of used lanes
+        };
+
+        /**
+         * @class BlockQueue
+         * @brief Bounded lock-free queue between exactly one producer and one consumer thread
+         *
+         * Capacity exceeds the number of blocks in flight, so a push never finds the queue full
+         */
+        class BlockQueue final
+        {
+        public:
+            /**
+             * @brief Creates empty queue
+             * @param capacity [in] Blocks the queue must hold at once
+             */
+            explicit BlockQueue(const size_t capacity);
+
+            /**
+             * @brief Appends block, called by the producer only
+             * @param block [in] Block to append, nullptr stops the consumer
+             */
+            void Push(Block *block);
+
+            /**
+             * @brief Takes oldest block, waiting while the queue is empty, called by the consumer only
+             * @return Oldest block
+             */
+            Block *Pop();
+
+        private:
+            std::vector<Block*> m_ring; ///< Queued blocks, size is a power of two
+            size_t m_mask; ///< Ring size minus one
+            size_t m_head = 0; ///< Next position to read, owned by the consumer
+            alignas(64) std::atomic<size_t> m_tail = 0; ///< Next position to write, published by the producer
+        };
+
+        std::shared_ptr<const NModel> m_model; ///< Evaluated model
+        std::vector<size_t> m_bounds; ///< First evaluated neuron of each stage, followed by the evaluated neuron count
+        std::vector<Block> m_blocks; ///< Blocks in flight, constants are laid out once
+        std::vector<std::unique_ptr<BlockQueue>> m_queues; ///< Input queue of each stage, followed by blocks returned by the last stage
+        std::vector<std::thread> m_stages; ///< Stage threads
+
+        std::mutex m_predictMutex; ///< Serializes Predict calls
+        std::vector<Block*> m_free; ///< Blocks not in flight, owned by the running Predict
+        std::vector<std::vector<float>> *m_output = nullptr; ///< Outputs of the running Predict, written by the last stage
+
+        /**
+         * @brief Evaluates blocks of one stage until a nullptr block arrives
+         * @param stage [in] Stage index
+         */
+        void RunStage(const size_t stage);
+    };
+}
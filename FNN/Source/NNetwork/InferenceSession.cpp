@@ -0,0 +1,282 @@
+#include "InferenceSession.hpp"
+
+#include <unordered_map>
+
+#include "../Neuron/NeuronStrategy.hpp"
+#include "../Statistics/Tracer.hpp"
+
+using namespace fnn;
+
+InferenceSession::InferenceSession(NNetwork &network, const SessionUpdate mode)
+    : m_network(network), m_mode(mode)
+{
+}
+
+bool InferenceSession::Reset(const std::vector<float> &inputX)
+{
+    FNN_TRACE_SCOPE("SessionReset");
+
+    m_isReady = false;
+    const auto &graph = m_network.m_network;
+    if (graph == nullptr || inputX.size() != graph->m_inputs.size())
+    {
+        return false;
+    }
+
+    if (m_structureVersion != graph->StructureVersion() || m_neurons.empty())
+    {
+        if (! BuildPlan())
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < m_inputPositions.size(); ++i)
+    {
+        m_neurons[m_inputPositions[i]]->m_value = inputX[i];
+    }
+
+    // Plan is in level order, every parent is final before its children
+    m_lastRecomputed = 0;
+    for (size_t position = 0; position < m_neurons.size(); ++position)
+    {
+        if (! m_isEvaluable[position])
+        {
+            continue;
+        }
+
+        Neuron *neuron = m_neurons[position];
+        if (m_isLinear[position])
+        {
+            m_sums[position] = HeadSum(*neuron);
+            m_adjustments[position] = 0;
+            neuron->m_value = neuron->m_activationFunction.value()->Activation(m_sums[position]);
+        }
+        else
+        {
+            neuron->m_value = neuron->m_valueCalculation.value()->CalculateValue(
+                neuron->m_headConnections.value(),
+                neuron->m_activationFunction.value()
+            );
+        }
+        ++m_lastRecomputed;
+    }
+
+    CollectOutputs();
+    m_isReady = true;
+    return true;
+}
+
+bool InferenceSession::Update(const std::vector<size_t> &inputIndices, const std::vector<float> &values)
+{
+    FNN_TRACE_SCOPE("SessionUpdate");
+
+    const auto &graph = m_network.m_network;
+    if (! m_isReady || graph == nullptr || m_structureVersion != graph->StructureVersion() ||
+        inputIndices.size() != values.size())
+    {
+        return false;
+    }
+    for (const auto index : inputIndices)
+    {
+        if (index >= m_inputPositions.size())
+        {
+            return false;
+        }
+    }
+
+    m_lastRecomputed = 0;
+    for (size_t i = 0; i < inputIndices.size(); ++i)
+    {
+        const size_t position = m_inputPositions[inputIndices[i]];
+        Neuron *neuron = m_neurons[position];
+        const float previous = neuron->m_value;
+        neuron->m_value = values[i];
+        if (previous != values[i])
+        {
+            Propagate(position, previous);
+        }
+    }
+
+    // Children are always on a higher level than their parents, so levels are drained in ascending order
+    for (size_t level = 1; level < m_pending.size(); ++level)
+    {
+        for (size_t i = 0; i < m_pending[level].size(); ++i)
+        {
+            const size_t position = m_pending[level][i];
+            m_isPending[position] = 0;
+            Recompute(position);
+        }
+        m_pending[level].clear();
+    }
+
+    CollectOutputs();
+    return true;
+}
+
+const std::vector<float> &InferenceSession::Outputs() const
+{
+    return m_outputs;
+}
+
+size_t InferenceSession::LastRecomputed() const
+{
+    return m_lastRecomputed;
+}
+
+bool InferenceSession::BuildPlan()
+{
+    const auto &graph = m_network.m_network;
+    if (m_network.HasCycleForward())
+    {
+        // ForwardPropagate refuses cyclic graphs as well
+        return false;
+    }
+
+    m_neurons.clear();
+    m_levels.clear();
+    m_isEvaluable.clear();
+    m_isLinear.clear();
+    m_children.clear();
+    m_inputPositions.clear();
+
+    std::unordered_map<const Neuron*, size_t> positions;
+    for (const auto inputKey : graph->m_inputs)
+    {
+        const auto &neuron = graph->GetNeuron(inputKey);
+        if (neuron == nullptr)
+        {
+            return false;
+        }
+
+        const auto inserted = positions.emplace(neuron.get(), m_neurons.size());
+        if (inserted.second)
+        {
+            m_neurons.push_back(neuron.get());
+            m_levels.push_back(0);
+            m_isEvaluable.push_back(0);
+            m_isLinear.push_back(0);
+        }
+        m_inputPositions.push_back(inserted.first->second);
+    }
+
+    // Same neurons ForwardPropagate evaluates, in the order of the level index
+    for (size_t level = 1; level < graph->LevelCount(); ++level)
+    {
+        for (const auto neuronKey : graph->GetLevel(level))
+        {
+            const auto &neuron = graph->GetNeuron(neuronKey);
+            if (neuron->m_neuronType == NeuronType::Input ||
+                ! neuron->m_valueCalculation.has_value() ||
+                ! neuron->m_headConnections.has_value() ||
+                ! neuron->m_activationFunction.has_value() ||
+                neuron->m_activationFunction.value() == nullptr)
+            {
+                continue;
+            }
+
+            // Only the default value strategies are a plain weighted sum followed by activation
+            const auto *valueStrategy = neuron->m_valueCalculation.value().get();
+            const bool isLinear = m_mode == SessionUpdate::Delta &&
+                ! neuron->m_headConnections->empty() &&
+                (dynamic_cast<const NeuronValueStrategy*>(valueStrategy) != nullptr ||
+                 dynamic_cast<const SparseNeuronValueStrategy*>(valueStrategy) != nullptr);
+
+            positions.emplace(neuron.get(), m_neurons.size());
+            m_neurons.push_back(neuron.get());
+            m_levels.push_back(level);
+            m_isEvaluable.push_back(1);
+            m_isLinear.push_back(isLinear ? 1 : 0);
+        }
+    }
+
+    // Children are discovered through head edges, the connections CalculateValue actually reads
+    m_children.resize(m_neurons.size());
+    for (size_t position = 0; position < m_neurons.size(); ++position)
+    {
+        if (! m_isEvaluable[position])
+        {
+            continue;
+        }
+        for (const auto &headEdge : m_neurons[position]->m_headConnections.value())
+        {
+            const auto parent = positions.find(headEdge.m_head.get());
+            if (parent != positions.end())
+            {
+                m_children[parent->second].emplace_back(position, &headEdge.m_weight);
+            }
+        }
+    }
+
+    m_sums.assign(m_neurons.size(), 0.0f);
+    m_adjustments.assign(m_neurons.size(), 0);
+    m_isPending.assign(m_neurons.size(), 0);
+    m_pending.assign(graph->LevelCount(), std::vector<size_t>());
+    m_structureVersion = graph->StructureVersion();
+    return true;
+}
+
+float InferenceSession::HeadSum(const Neuron &neuron)
+{
+    // Same summation order as the value strategies, so exact sums match Predict bit for bit
+    return NeuronValueStrategy::WeightedSum(neuron.m_headConnections.value());
+}
+
+void InferenceSession::Recompute(const size_t position)
+{
+    Neuron *neuron = m_neurons[position];
+    const float previous = neuron->m_value;
+
+    if (m_isLinear[position])
+    {
+        if (m_adjustments[position] >= DELTA_REFRESH_INTERVAL)
+        {
+            // Parents are final at this point, so the exact sum discards all accumulated rounding
+            m_sums[position] = HeadSum(*neuron);
+            m_adjustments[position] = 0;
+        }
+        neuron->m_value = neuron->m_activationFunction.value()->Activation(m_sums[position]);
+    }
+    else
+    {
+        neuron->m_value = neuron->m_valueCalculation.value()->CalculateValue(
+            neuron->m_headConnections.value(),
+            neuron->m_activationFunction.value()
+        );
+    }
+    ++m_lastRecomputed;
+
+    // Unchanged value, e.g. a saturated activation, stops propagation into this neuron's children
+    if (neuron->m_value != previous)
+    {
+        Propagate(position, previous);
+    }
+}
+
+void InferenceSession::Propagate(const size_t position, const float previous)
+{
+    const float delta = m_neurons[position]->m_value - previous;
+    for (const auto &[child, weight] : m_children[position])
+    {
+        if (m_isLinear[child])
+        {
+            m_sums[child] += *weight * delta;
+            ++m_adjustments[child];
+        }
+        if (! m_isPending[child])
+        {
+            m_isPending[child] = 1;
+            m_pending[m_levels[child]].push_back(child);
+        }
+    }
+}
+
+void InferenceSession::CollectOutputs()
+{
+    const auto &graph = m_network.m_network;
+    m_outputs.resize(graph->m_outputs.size());
+    for (size_t i = 0; i < graph->m_outputs.size(); ++i)
+    {
+        m_outputs[i] = graph->GetNeuron(graph->m_outputs[i])->m_value;
+    }
+}
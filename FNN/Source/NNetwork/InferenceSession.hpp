@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @enum SessionUpdate
+     * @brief Selects how InferenceSession recomputes neurons affected by changed inputs
+     */
+    enum class SessionUpdate
+    {
+        Exact, ///< Affected neurons are recomputed from all head edges, outputs are identical to Predict
+        Delta, ///< Pre-activation sums of default value strategies are adjusted by weight * value change, sums are recomputed exactly every DELTA_REFRESH_INTERVAL adjustments to bound rounding drift. Reset and recomputed sums match Predict bit for bit, adjusted ones up to rounding
+    };
+
+    /**
+     * @class InferenceSession
+     * @brief Stateful forward pass for inputs that change partially between calls
+     *
+     * Reset evaluates the whole network and remembers the result, Update then only recomputes neurons downstream of
+     * changed inputs and stops at neurons whose value did not change. The session writes neuron values of the
+     * network like ForwardPropagate does, so Fit, Predict or weight changes between calls require Reset.
+     * Structural changes are detected and make Update fail until Reset is called.
+     */
+    class InferenceSession final
+    {
+    public:
+        static constexpr uint32_t DELTA_REFRESH_INTERVAL = 32; ///< Delta adjustments of a sum before it is recomputed exactly
+
+
+        /**
+         * @brief Creates session for a network, the network must outlive the session
+         * @param network [in, out] Network evaluated by the session
+         * @param mode [in] How affected neurons are recomputed, default is Exact
+         */
+        explicit InferenceSession(NNetwork &network, const SessionUpdate mode = SessionUpdate::Exact);
+
+        /**
+         * @brief Evaluates the whole network for a complete input vector
+         * @param inputX [in] Values of all inputs in order of NGraph::m_inputs
+         * @return True if evaluation is successful, false otherwise
+         */
+        bool Reset(const std::vector<float> &inputX);
+
+        /**
+         * @brief Changes some inputs and recomputes only neurons affected by them
+         * @param inputIndices [in] Positions of changed inputs in the input vector
+         * @param values [in] New values of changed inputs
+         * @return True if evaluation is successful, false if session was not reset, structure changed or arguments are invalid
+         */
+        bool Update(const std::vector<size_t> &inputIndices, const std::vector<float> &values);
+
+        /**
+         * @brief Returns output values of the last evaluation
+         * @return Values in order of NGraph::m_outputs
+         */
+        const std::vector<float> &Outputs() const;
+
+        /**
+         * @brief Returns number of neurons recomputed by the last Reset or Update
+         * @return Recomputed neurons
+         */
+        size_t LastRecomputed() const;
+
+    private:
+        NNetwork &m_network; ///< Evaluated network
+        const SessionUpdate m_mode; ///< Recomputation mode
+        bool m_isReady = false; ///< True after successful Reset
+        uint64_t m_structureVersion = 0; ///< Structure the plan was built for
+
+        std::vector<Neuron*> m_neurons; ///< Inputs followed by evaluable neurons in level order
+        std::vector<size_t> m_levels; ///< Level of each neuron in m_neurons
+        std::vector<uint8_t> m_isEvaluable; ///< Neuron has everything ForwardPropagate needs to evaluate it
+        std::vector<uint8_t> m_isLinear; ///< Neuron uses a default value strategy, its sum can be updated by deltas
+        std::vector<std::vector<std::pair<size_t, const float*>>> m_children; ///< Evaluable children and weight of the connecting head edge
+        std::vector<size_t> m_inputPositions; ///< Position of each input in m_neurons
+        std::vector<float> m_sums; ///< Pre-activation sums of linear neurons, Delta mode only
+        std::vector<uint32_t> m_adjustments; ///< Delta adjustments of each sum since it was last recomputed exactly
+        std::vector<uint8_t> m_isPending; ///< Neuron is scheduled for recomputation
+        std::vector<std::vector<size_t>> m_pending; ///< Scheduled neurons by level
+        std::vector<float> m_outputs; ///< Output values of the last evaluation
+        size_t m_lastRecomputed = 0; ///< Neurons recomputed by the last call
+
+        /**
+         * @brief Builds evaluation plan for the current structure
+         * @return True if plan was built, false for cyclic graphs
+         */
+        bool BuildPlan();
+
+        /**
+         * @brief Computes sum of head values times weights of a neuron in the order of NeuronValueStrategy
+         * @param neuron [in] Neuron to sum
+         * @return Pre-activation sum
+         */
+        static float HeadSum(const Neuron &neuron);
+
+        /**
+         * @brief Recomputes a neuron and schedules its children when its value changed
+         * @param position [in] Position of the neuron in m_neurons
+         */
+        void Recompute(const size_t position);
+
+        /**
+         * @brief Schedules children of a neuron whose value changed, adjusting their sums in Delta mode
+         * @param position [in] Position of the changed neuron
+         * @param previous [in] Value of the neuron before the change
+         */
+        void Propagate(const size_t position, const float previous);
+
+        /**
+         * @brief Copies output neuron values to m_outputs
+         */
+        void CollectOutputs();
+    };
+}
@@ -0,0 +1,81 @@
+#include "ModelPublisher.hpp"
+
+#include <algorithm>
+
+using namespace fnn;
+
+ModelPublisher::ModelPublisher(NNetwork &network)
+    : m_network(network)
+{
+    Publish();
+}
+
+bool ModelPublisher::Publish()
+{
+    FNN_TRACE_SCOPE("Publish");
+
+    const auto &graph = m_network.m_network;
+    if (graph == nullptr)
+    {
+        return false;
+    }
+
+    // Nothing to publish, readers already see these weights
+    if (m_generation.load(std::memory_order_relaxed) != 0 &&
+        m_structureVersion == graph->StructureVersion() && m_parameterVersion == graph->ParameterVersion())
+    {
+        return true;
+    }
+
+    // Snapshot is complete before it becomes visible, readers never see a partial update
+    auto snapshot = NModel::Compile(m_network);
+    if (snapshot == nullptr)
+    {
+        return false;
+    }
+    m_snapshot.store(std::move(snapshot), std::memory_order_release);
+    m_structureVersion = graph->StructureVersion();
+    m_parameterVersion = graph->ParameterVersion();
+    m_generation.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+std::shared_ptr<const NModel> ModelPublisher::Snapshot() const
+{
+    return m_snapshot.load(std::memory_order_acquire);
+}
+
+uint64_t ModelPublisher::Generation() const
+{
+    return m_generation.load(std::memory_order_acquire);
+}
+
+bool ModelPublisher::Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const size_t publishInterval)
+{
+    FNN_TRACE_SCOPE("PublisherFit");
+
+    // Every sample is a batch of Fit
+    return m_network.Fit(trainX, trainY, epochs, PublishingCallback(trainX.size(), publishInterval)) && Publish();
+}
+
+bool ModelPublisher::FitMiniBatch(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs,
+                                  const size_t batchSize, const size_t publishInterval)
+{
+    FNN_TRACE_SCOPE("PublisherFitMiniBatch");
+
+    const size_t batches = batchSize == 0 ? 0 : (trainX.size() + batchSize - 1) / batchSize;
+    return m_network.FitMiniBatch(trainX, trainY, epochs, batchSize, PublishingCallback(batches, publishInterval)) && Publish();
+}
+
+NNetwork::BatchCallback ModelPublisher::PublishingCallback(const size_t batchesPerEpoch, const size_t publishInterval)
+{
+    return [this, batchesPerEpoch, publishInterval, batches = size_t(0)](const size_t, const size_t batch) mutable
+    {
+        const bool isIntervalEnd = publishInterval != 0 && ++batches % publishInterval == 0;
+        if (isIntervalEnd || batch + 1 == batchesPerEpoch)
+        {
+            return Publish();
+        }
+        return true;
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "NModel.hpp"
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @class ModelPublisher
+     * @brief Serves predictions from published snapshots while the network keeps training
+     *
+     * The network is the private weight buffer, only the training thread touches it. Publish compiles it into an
+     * immutable NModel and swaps that in atomically, readers load the current snapshot and predict on it without ever
+     * waiting for training or seeing partially updated weights. A replaced snapshot is freed when its last reader
+     * releases it
+     */
+    class ModelPublisher final
+    {
+    public:
+        /**
+         * @brief Publishes the initial snapshot of a network
+         * @param network [in, out] Network trained through this publisher, must outlive it
+         */
+        explicit ModelPublisher(NNetwork &network);
+
+        ModelPublisher(const ModelPublisher&) = delete;
+        ModelPublisher &operator=(const ModelPublisher&) = delete;
+
+        /**
+         * @brief Compiles current weights and makes them visible to readers, called by the training thread
+         *
+         * Does nothing when structure and parameters did not change since the last publish
+         * @return True if the current weights are published, false when the network cannot be compiled
+         */
+        bool Publish();
+
+        /**
+         * @brief Returns the latest published snapshot, safe to call from any thread
+         * @return Snapshot kept alive by the returned pointer, nullptr before the first successful publish
+         */
+        std::shared_ptr<const NModel> Snapshot() const;
+
+        /**
+         * @brief Returns number of published snapshots, safe to call from any thread
+         * @return Publish count including the initial snapshot
+         */
+        uint64_t Generation() const;
+
+        /**
+         * @brief Trains network with NNetwork::Fit and publishes while training
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations
+         * @param publishInterval [in] Samples between publishes, zero publishes after every epoch only
+         * @return True if training and all publishes are successful, false otherwise
+         */
+        bool Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const size_t publishInterval = 0);
+
+        /**
+         * @brief Trains network with NNetwork::FitMiniBatch and publishes while training
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations
+         * @param batchSize [in] Samples per weight update
+         * @param publishInterval [in] Batches between publishes, zero publishes after every epoch only
+         * @return True if training and all publishes are successful, false otherwise
+         */
+        bool FitMiniBatch(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs,
+                          const size_t batchSize, const size_t publishInterval = 0);
+
+    private:
+        NNetwork &m_network; ///< Training copy, only touched by the training thread
+        std::atomic<std::shared_ptr<const NModel>> m_snapshot; ///< Snapshot readers predict on
+        std::atomic<uint64_t> m_generation = 0; ///< Number of published snapshots
+        uint64_t m_structureVersion = 0; ///< Structure version of the published snapshot
+        uint64_t m_parameterVersion = 0; ///< Parameter version of the published snapshot
+
+        /**
+         * @brief Creates batch callback of NNetwork training that publishes every interval and after every epoch
+         * @param batchesPerEpoch [in] Number of batches in one epoch
+         * @param publishInterval [in] Batches between publishes, zero publishes after every epoch only
+         * @return Callback returning false when a publish fails
+         */
+        NNetwork::BatchCallback PublishingCallback(const size_t batchesPerEpoch, const size_t publishInterval);
+    };
+}
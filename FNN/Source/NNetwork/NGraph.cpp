@@ -1,5 +1,7 @@
 #include "NGraph.hpp"
 
+#include <algorithm>
+#include <queue>
 #include <ranges>
 
 #include "../Neuron/Neuron.hpp"
@@ -32,13 +34,11 @@ NGraph::NGraph(const std::initializer_list<size_t> &layerSizes, const std::share
             if (isInputLayer)
             {
                 AddNeuron(neuronID, NeuronBuilder::CreateAsType(NeuronType::Input).Build());
-                m_inputs.insert(neuronID);
             }
             else if (isOutputLayer)
             {
                 AddNeuron(neuronID,NeuronBuilder::CreateAsType(NeuronType::Output).Build()
                 );
-                m_outputs.insert(neuronID);
             }
             else
             {
@@ -54,20 +54,47 @@ NGraph::NGraph(const std::initializer_list<size_t> &layerSizes, const std::share
 
 size_t NGraph::Size() const
 {
-    return m_matrix.size();
+    return m_neurons.size();
 }
 
-std::shared_ptr<Neuron> NGraph::GetNeuron(const size_t neuronKey) const
+const std::shared_ptr<Neuron> &NGraph::GetNeuron(const size_t neuronKey) const
 {
-    const auto it = m_matrix.find(neuronKey);
-    if (it != m_matrix.end())
+    static const std::shared_ptr<Neuron> missing;
+
+    const size_t index = GetIndex(neuronKey);
+    return index == INVALID_INDEX ? missing : m_neurons[index];
+}
+
+size_t NGraph::GetIndex(const size_t neuronKey) const
+{
+    if (m_isIdentity)
     {
-        return it->second;
+        return neuronKey < m_neurons.size() ? neuronKey : INVALID_INDEX;
     }
-    else
+
+    const auto it = m_keyIndices.find(neuronKey);
+    return it == m_keyIndices.end() ? INVALID_INDEX : it->second;
+}
+
+std::span<const std::shared_ptr<Neuron>> NGraph::Neurons() const
+{
+    return m_neurons;
+}
+
+std::span<const size_t> NGraph::Keys() const
+{
+    return m_keys;
+}
+
+size_t NGraph::StorageBytes() const
+{
+    size_t bytes = m_neurons.capacity() * sizeof(std::shared_ptr<Neuron>) + m_keys.capacity() * sizeof(size_t);
+    if (! m_isIdentity)
     {
-        return nullptr;
+        // Bucket array plus node with next pointer, key and index per entry
+        bytes += m_keyIndices.bucket_count() * sizeof(void*) + m_keyIndices.size() * (sizeof(void*) + 2 * sizeof(size_t));
     }
+    return bytes;
 }
 
 void NGraph::AddNeuron(const size_t neuronKey, const std::shared_ptr<Neuron> neuron)
@@ -78,21 +105,49 @@ void NGraph::AddNeuron(const size_t neuronKey, const std::shared_ptr<Neuron> neu
         return;
     }
 
-    m_matrix[neuronKey] = neuron;
+    const size_t index = GetIndex(neuronKey);
+    if (index != INVALID_INDEX)
+    {
+        // Replaced neuron may have had other role than the new one
+        std::erase(m_inputs, neuronKey);
+        std::erase(m_outputs, neuronKey);
+        m_neurons[index] = neuron;
+    }
+    else
+    {
+        if (m_isIdentity && neuronKey != m_neurons.size())
+        {
+            // First key out of sequence, from now on keys are resolved through the remap
+            m_isIdentity = false;
+            m_keyIndices.reserve(m_neurons.size() + 1);
+            for (size_t i = 0; i < m_keys.size(); ++i)
+            {
+                m_keyIndices.emplace(m_keys[i], i);
+            }
+        }
+        if (! m_isIdentity)
+        {
+            m_keyIndices.emplace(neuronKey, m_neurons.size());
+        }
+        m_neurons.push_back(neuron);
+        m_keys.push_back(neuronKey);
+    }
+
+    InvalidateStructure();
     if (neuron->m_neuronType == NeuronType::Input)
     {
-        m_inputs.insert(neuronKey);
+        m_inputs.push_back(neuronKey);
     }
     else if (neuron->m_neuronType == NeuronType::Output)
     {
-        m_outputs.insert(neuronKey);
+        m_outputs.push_back(neuronKey);
     }
 }
 
 bool NGraph::AddSourceToDestinationHead(const size_t sourceKey, const size_t destinationKey)
 {
-    const auto sourceNeuron = GetNeuron(sourceKey);
-    const auto destinationNeuron = GetNeuron(destinationKey);
+    const auto &sourceNeuron = GetNeuron(sourceKey);
+    const auto &destinationNeuron = GetNeuron(destinationKey);
 
     if (sourceNeuron == nullptr || destinationNeuron == nullptr)
     {
@@ -111,6 +166,7 @@ bool NGraph::AddSourceToDestinationHead(const size_t sourceKey, const size_t des
     {
         // If the edge doesn't exist, add it
         headConnections.push_back(newEdge);
+        InvalidateStructure();
     }
     else
     {
@@ -123,8 +179,8 @@ bool NGraph::AddSourceToDestinationHead(const size_t sourceKey, const size_t des
 
 bool NGraph::AddSourceToDestinationTail(const size_t sourceKey, const size_t destinationKey)
 {
-    const auto sourceNeuron = GetNeuron(sourceKey);
-    const auto destinationNeuron = GetNeuron(destinationKey);
+    const auto &sourceNeuron = GetNeuron(sourceKey);
+    const auto &destinationNeuron = GetNeuron(destinationKey);
 
     if (sourceNeuron == nullptr || destinationNeuron == nullptr)
     {
@@ -143,6 +199,7 @@ bool NGraph::AddSourceToDestinationTail(const size_t sourceKey, const size_t des
     {
         // If the edge doesn't exist, add it
         tailConnections.push_back(newEdge);
+        InvalidateStructure();
     }
     else
     {
@@ -161,13 +218,14 @@ void NGraph::MapFunction(const std::shared_ptr<INeuronFunctionStrategy> activati
         return;
     }
 
-    for (const auto &[neuronID, neuron] : m_matrix)
+    for (const auto &neuron : m_neurons)
     {
         if (neuron->m_activationFunction.has_value())
         {
             neuron->m_activationFunction = activationFunction;
         }
     }
+    InvalidateParameters();
 }
 
 void NGraph::MapFunction(const std::shared_ptr<INeuronFunctionStrategy> activationFunction, const size_t layer)
@@ -178,155 +236,235 @@ void NGraph::MapFunction(const std::shared_ptr<INeuronFunctionStrategy> activati
         return;
     }
 
-    // Using unordered set to skip already included neurons
-    std::unordered_set<std::shared_ptr<Neuron>> currentLayer;
-    std::unordered_set<std::shared_ptr<Neuron>> nextLayer;
+    for (const auto neuronKey : GetLevel(layer))
+    {
+        GetNeuron(neuronKey)->m_activationFunction = activationFunction;
+    }
+    InvalidateParameters();
+}
 
-    for (const auto neuronKey : m_inputs)
+void NGraph::MapLearningRate(const float learningRate)
+{
+    for (const auto &neuron : m_neurons)
     {
-        const auto &neuron = GetNeuron(neuronKey);
-        if (neuron == nullptr)
-        {
-            continue;
-        }
-        // When first layer update neurons directly and exit
-        if (layer == 0)
-        {
-            neuron->m_activationFunction = activationFunction;
-        }
-        else
+        if (neuron->m_learningRate.has_value())
         {
-            currentLayer.insert(neuron);
+            neuron->m_learningRate = learningRate;
         }
     }
+}
 
-    // Iterate over until correct layer was found or it is possible to do so
-    for (size_t i = 0; ! currentLayer.empty(); ++i)
+void NGraph::MapLearningRate(const float learningRate, const size_t layer)
+{
+    for (const auto neuronKey : GetLevel(layer))
     {
-        nextLayer.clear();
+        GetNeuron(neuronKey)->m_learningRate = learningRate;
+    }
+}
 
-        for (const auto &neuron : currentLayer)
-        {
-            if (neuron == nullptr)
-            {
-                continue;
-            }
+size_t NGraph::LevelCount() const
+{
+    UpdateLevelIndex();
+    return m_levelOffsets.size() - 1;
+}
 
-            // Found correct layer
-            if (i == layer)
-            {
-                neuron->m_activationFunction = activationFunction;
-                continue;
-            }
+std::span<const size_t> NGraph::GetLevel(const size_t level) const
+{
+    UpdateLevelIndex();
+    if (level + 1 >= m_levelOffsets.size())
+    {
+        return {};
+    }
+    return std::span<const size_t>(m_levelKeys).subspan(m_levelOffsets[level], m_levelOffsets[level + 1] - m_levelOffsets[level]);
+}
 
-            // Add tail neuron's connections to nextLayer
-            for (const auto &tailEdge : neuron->m_tailConnections.value())
-            {
-                nextLayer.insert(tailEdge.m_tail);
-            }
+uint64_t NGraph::StructureVersion() const
+{
+    return m_structureVersion;
+}
 
-        }
-        std::swap(currentLayer, nextLayer);
-    }
+void NGraph::InvalidateStructure()
+{
+    ++m_structureVersion;
 }
 
+uint64_t NGraph::ParameterVersion() const
+{
+    return m_parameterVersion;
+}
 
-void NGraph::MapLearningRate(const float learningRate)
+void NGraph::InvalidateParameters()
 {
-    for (const auto &[neuronID, neuron] : m_matrix)
-    {
-        if (neuron->m_learningRate.has_value())
-        {
-            neuron->m_learningRate = learningRate;
-        }
-    }
+    ++m_parameterVersion;
 }
 
-void NGraph::MapLearningRate(const float learningRate, const size_t layer)
+void NGraph::UpdateLevelIndex() const
 {
-    // Using unordered set to skip already included neurons
-    std::unordered_set<std::shared_ptr<Neuron>> currentLayer;
-    std::unordered_set<std::shared_ptr<Neuron>> nextLayer;
+    if (m_levelVersion == m_structureVersion)
+    {
+        return;
+    }
 
-    for (const auto neuronKey : m_inputs)
+    std::unordered_map<const Neuron*, size_t> keys;
+    keys.reserve(m_neurons.size());
+    for (size_t i = 0; i < m_neurons.size(); ++i)
+    {
+        keys.emplace(m_neurons[i].get(), m_keys[i]);
+    }
+
+    // Children of a neuron through its tail connections, limited to neurons of this graph
+    const auto forEachChild = [&](const std::shared_ptr<Neuron> &neuron, const auto &function)
     {
-        const auto& neuron = GetNeuron(neuronKey);
-        if (neuron == nullptr)
+        if (! neuron->m_tailConnections.has_value())
         {
-            continue;
+            return;
         }
-        // When first layer update neurons directly and exit
-        if (layer == 0)
+        for (const auto &tailEdge : neuron->m_tailConnections.value())
         {
-            neuron->m_learningRate = learningRate;
+            if (tailEdge.m_tail != nullptr && keys.contains(tailEdge.m_tail.get()))
+            {
+                function(tailEdge.m_tail);
+            }
         }
-        else
+    };
+
+    // Count parents reachable from inputs, so Kahn's algorithm only waits for edges it can actually release
+    std::unordered_map<const Neuron*, size_t> parentCounts;
+    std::vector<std::shared_ptr<Neuron>> stack;
+    for (const auto neuronKey : m_inputs)
+    {
+        const auto &neuron = GetNeuron(neuronKey);
+        if (neuron != nullptr && parentCounts.emplace(neuron.get(), 0).second)
         {
-            currentLayer.insert(neuron);
+            stack.push_back(neuron);
         }
     }
-
-    // Iterate over until correct layer was found or it is possible to do so
-    for (size_t i = 0; !currentLayer.empty(); ++i)
+    while (! stack.empty())
     {
-        nextLayer.clear();
+        const auto neuron = std::move(stack.back());
+        stack.pop_back();
 
-        for (const auto& neuron : currentLayer)
+        forEachChild(neuron, [&](const std::shared_ptr<Neuron> &child)
         {
-            if (neuron == nullptr)
+            const auto [it, inserted] = parentCounts.emplace(child.get(), 0);
+            ++it->second;
+            if (inserted)
             {
-                continue;
+                stack.push_back(child);
             }
+        });
+    }
 
-            // Found correct layer
-            if (i == layer)
-            {
-                neuron->m_learningRate = learningRate;
-                continue;
-            }
+    // Longest path depth, inputs start at level 0 even when they have parents
+    std::unordered_map<const Neuron*, size_t> levels;
+    std::queue<std::shared_ptr<Neuron>> ready;
+    for (const auto neuronKey : m_inputs)
+    {
+        const auto &neuron = GetNeuron(neuronKey);
+        if (neuron != nullptr && levels.emplace(neuron.get(), 0).second)
+        {
+            ready.push(neuron);
+        }
+    }
 
-            // Add tail neuron's connections to nextLayer
-            for (const auto& tailEdge : neuron->m_tailConnections.value())
+    std::vector<std::vector<size_t>> levelKeys;
+    while (! ready.empty())
+    {
+        const auto neuron = std::move(ready.front());
+        ready.pop();
+
+        const size_t level = levels[neuron.get()];
+        if (levelKeys.size() <= level)
+        {
+            levelKeys.resize(level + 1);
+        }
+        levelKeys[level].push_back(keys.at(neuron.get()));
+
+        forEachChild(neuron, [&](const std::shared_ptr<Neuron> &child)
+        {
+            auto &childLevel = levels[child.get()];
+            childLevel = std::max(childLevel, level + 1);
+            if (--parentCounts[child.get()] == 0 && child->m_neuronType != NeuronType::Input)
             {
-                nextLayer.insert(tailEdge.m_tail);
+                ready.push(child);
             }
+        });
+    }
 
-        }
-        std::swap(currentLayer, nextLayer);
+    m_levelKeys.clear();
+    m_levelOffsets.clear();
+    for (auto &level : levelKeys)
+    {
+        // Sorted keys keep per level iteration order deterministic
+        std::ranges::sort(level);
+        m_levelOffsets.push_back(m_levelKeys.size());
+        m_levelKeys.insert(m_levelKeys.end(), level.begin(), level.end());
     }
+    m_levelOffsets.push_back(m_levelKeys.size());
+    m_levelVersion = m_structureVersion;
 }
 
 void NGraph::ConnectLayers(const std::initializer_list<size_t> &layerSizes)
 {
-    size_t neuronID = 0;
-
-    for (auto layerIt = layerSizes.begin(); layerIt != layerSizes.end() && std::next(layerIt) != layerSizes.end(); ++layerIt)
+    // Calls visit for every connected pair in connection order
+    const auto forEachPair = [this, &layerSizes](const auto &visit)
     {
-        // Skip layers with zero neurons
-        if (*layerIt == 0)
+        size_t neuronID = 0;
+
+        for (auto layerIt = layerSizes.begin(); layerIt != layerSizes.end() && std::next(layerIt) != layerSizes.end(); ++layerIt)
         {
-            continue;
-        }
+            // Skip layers with zero neurons
+            if (*layerIt == 0)
+            {
+                continue;
+            }
 
-        const size_t nextLayerSize = *std::next(layerIt);
+            const size_t nextLayerSize = *std::next(layerIt);
 
-        // Skip connections to next layer if it has zero neurons
-        if (nextLayerSize == 0)
-        {
-            continue;
-        }
+            // Skip connections to next layer if it has zero neurons
+            if (nextLayerSize == 0)
+            {
+                continue;
+            }
 
-        const size_t currentLayerEnd = neuronID + *layerIt;
-        const size_t nextLayerEnd = currentLayerEnd + nextLayerSize;
+            const size_t currentLayerEnd = neuronID + *layerIt;
+            const size_t nextLayerEnd = currentLayerEnd + nextLayerSize;
 
-        for (; neuronID < currentLayerEnd; ++neuronID)
-        {
-            for (size_t connectedNeuronID = currentLayerEnd; connectedNeuronID < nextLayerEnd; ++connectedNeuronID)
+            for (; neuronID < currentLayerEnd; ++neuronID)
             {
-                // Create mutual connection between neurons
-                AddSourceToDestinationHead(neuronID, connectedNeuronID);
-                AddSourceToDestinationTail(connectedNeuronID, neuronID);
+                for (size_t connectedNeuronID = currentLayerEnd; connectedNeuronID < nextLayerEnd; ++connectedNeuronID)
+                {
+                    visit(m_neurons[neuronID], m_neurons[connectedNeuronID]);
+                }
             }
         }
+    };
+
+    // All weights are drawn in one call, head weight and then tail weight for each pair that can hold them
+    size_t count = 0;
+    forEachPair([&count](const std::shared_ptr<Neuron> &neuron, const std::shared_ptr<Neuron> &connectedNeuron)
+    {
+        count += (connectedNeuron->m_headConnections.has_value() ? 1 : 0) + (neuron->m_tailConnections.has_value() ? 1 : 0);
+    });
+    if (count == 0)
+    {
+        return;
     }
+    std::vector<float> weights(count);
+    m_randomStrategy->Fill(weights, 0.0f, 1.0f);
+
+    // Create mutual connection between neurons, layers are fresh so no edge can already exist
+    size_t weight = 0;
+    forEachPair([&weights, &weight](const std::shared_ptr<Neuron> &neuron, const std::shared_ptr<Neuron> &connectedNeuron)
+    {
+        if (connectedNeuron->m_headConnections.has_value())
+        {
+            connectedNeuron->m_headConnections->push_back(Edge(weights[weight++], neuron, connectedNeuron));
+        }
+        if (neuron->m_tailConnections.has_value())
+        {
+            neuron->m_tailConnections->push_back(Edge(weights[weight++], neuron, connectedNeuron));
+        }
+    });
+    InvalidateStructure();
 }
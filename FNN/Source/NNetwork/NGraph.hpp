@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <span>
 #include <unordered_map>
-#include <unordered_set>
 #include <initializer_list>
+#include <vector>
 
 #include "../Neuron/Neuron.hpp"
 #include "../Neuron/NeuronStrategyInterface.hpp"
+#include "../Neuron/StrategyRegistry.hpp"
 #include "../Random/RandomStrategyInterface.hpp"
 #include "../Random/RandomStrategy.hpp"
 
@@ -17,13 +20,17 @@ namespace fnn
      * @brief Represents a neural network graph
      *
      * Manages neurons and their connections, facilitating operations like adding neurons, connecting them, and applying functions across the network
+     *
+     * Neurons are stored densely in order of insertion. While every key equals its insertion index, as with graphs
+     * built from layer sizes, keys index the storage directly; other keys are resolved through a remap table
      */
     class NGraph final
     {
     public:
-        std::unordered_map<size_t, std::shared_ptr<Neuron>> m_matrix; ///< Adjacency list representing neuron connections
-        std::unordered_set<size_t> m_inputs; ///< Keys of input neurons
-        std::unordered_set<size_t> m_outputs; ///< Keys of output neurons
+        static constexpr size_t INVALID_INDEX = SIZE_MAX; ///< Index returned for keys not present in the graph
+
+        std::vector<size_t> m_inputs; ///< Keys of input neurons in order of insertion, the order of input vectors
+        std::vector<size_t> m_outputs; ///< Keys of output neurons in order of insertion, the order of target and output vectors
         std::shared_ptr<IRandomStrategy> m_randomStrategy; ///< Strategy for random number generation used in the graph
 
 
@@ -44,12 +51,37 @@ namespace fnn
         /**
          * @brief Retrieves a neuron by its key
          * @param neuronKey [in] Key of the neuron to retrieve
-         * @return Shared pointer to the requested neuron
+         * @return Shared pointer to the requested neuron, nullptr when key is not present
+         */
+        const std::shared_ptr<Neuron> &GetNeuron(const size_t neuronKey) const;
+
+        /**
+         * @brief Returns dense index of a key
+         * @param neuronKey [in] Key of the neuron
+         * @return Index into Neurons() and Keys(), INVALID_INDEX when key is not present
+         */
+        size_t GetIndex(const size_t neuronKey) const;
+
+        /**
+         * @brief Returns all neurons in dense storage order
+         * @return Neurons indexed by GetIndex, valid until the next AddNeuron
+         */
+        std::span<const std::shared_ptr<Neuron>> Neurons() const;
+
+        /**
+         * @brief Returns keys of all neurons in dense storage order
+         * @return Keys indexed like Neurons(), valid until the next AddNeuron
          */
-        std::shared_ptr<Neuron> GetNeuron(const size_t neuronKey) const;
+        std::span<const size_t> Keys() const;
 
         /**
-         * @brief Adds a neuron to the graph
+         * @brief Returns estimated bytes of dense neuron storage and key remap, excluding neuron objects
+         * @return Estimated bytes
+         */
+        size_t StorageBytes() const;
+
+        /**
+         * @brief Adds a neuron to the graph, replacing neuron stored under the same key
          * @param neuronKey [in] Key to assign to the neuron
          * @param neuron [in] Shared pointer to the neuron to add
          */
@@ -86,6 +118,17 @@ namespace fnn
          */
         void MapFunction(const std::shared_ptr<INeuronFunctionStrategy> activationFunction, const size_t layer);
 
+        /**
+         * @brief Applies an interned activation function to all neurons in the graph
+         *
+         * The instance is shared with every other neuron and graph using the same strategy and parameters,
+         * see StrategyRegistry
+         * @tparam Strategy Activation function strategy type
+         * @param parameters [in] Constructor parameters of the strategy
+         */
+        template <typename Strategy, typename... Parameters>
+        void MapFunction(const Parameters&... parameters);
+
         /**
          * @brief Sets a learning rate for all neurons in the graph
          * @param learningRate [in] Learning rate to set
@@ -99,11 +142,79 @@ namespace fnn
          */
         void MapLearningRate(const float learningRate, const size_t layer);
 
+
+        /**
+         * @brief Returns number of levels of the level index
+         *
+         * Level of a neuron is the length of the longest path of tail connections from any input neuron, inputs are
+         * level 0. Neurons unreachable from inputs or lying on a cycle belong to no level. The index is built on first
+         * use and kept until the structure changes, building it is not thread safe
+         * @return Number of levels
+         */
+        size_t LevelCount() const;
+
+        /**
+         * @brief Returns keys of neurons on a level
+         * @param level [in] Level to return
+         * @return Keys of the level's neurons, empty when level does not exist, valid until the structure changes
+         */
+        std::span<const size_t> GetLevel(const size_t level) const;
+
+        /**
+         * @brief Returns counter incremented by every structural change
+         * @return Current structure version
+         */
+        uint64_t StructureVersion() const;
+
+        /**
+         * @brief Marks structure as changed, invalidating the level index and other structure caches
+         *
+         * Called by AddNeuron and connection methods, must be called after modifying m_inputs, m_outputs or neuron
+         * connections directly
+         */
+        void InvalidateStructure();
+
+        /**
+         * @brief Returns counter incremented by every change of weights or activation functions
+         * @return Current parameter version
+         */
+        uint64_t ParameterVersion() const;
+
+        /**
+         * @brief Marks weights or activation functions as changed, invalidating cached predictions
+         *
+         * Called by MapFunction, NNetwork::BackwardPropagateWeights and NNetwork::SetPropagationMode, must be called
+         * after modifying edge weights or neuron strategies directly
+         */
+        void InvalidateParameters();
+
     private:
+        std::vector<std::shared_ptr<Neuron>> m_neurons; ///< Neurons in order of insertion
+        std::vector<size_t> m_keys; ///< Key of each neuron in m_neurons
+        std::unordered_map<size_t, size_t> m_keyIndices; ///< Key to index remap, only used when m_isIdentity is false
+        bool m_isIdentity = true; ///< True while every key equals its index
+
+        uint64_t m_structureVersion = 0; ///< Incremented by every structural change
+        uint64_t m_parameterVersion = 0; ///< Incremented by every change of weights or activation functions
+        mutable uint64_t m_levelVersion = UINT64_MAX; ///< Structure version the level index was built for
+        mutable std::vector<size_t> m_levelKeys; ///< Neuron keys ordered by level
+        mutable std::vector<size_t> m_levelOffsets; ///< Start of each level in m_levelKeys, followed by m_levelKeys size
+
+        /**
+         * @brief Builds level index when structure changed since last build
+         */
+        void UpdateLevelIndex() const;
+
         /**
          * @brief Connects neurons across specified layers
          * @param layerSizes [in] Sizes of the layers to connect
          */
         void ConnectLayers(const std::initializer_list<size_t> &layerSizes);
     };
+
+    template <typename Strategy, typename... Parameters>
+    void NGraph::MapFunction(const Parameters&... parameters)
+    {
+        MapFunction(std::static_pointer_cast<INeuronFunctionStrategy>(StrategyRegistry::Get<Strategy>(parameters...)));
+    }
 }
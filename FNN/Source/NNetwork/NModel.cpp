@@ -0,0 +1,330 @@
+#include "NModel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <unordered_map>
+
+#include "../Neuron/NeuronStrategy.hpp"
+
+using namespace fnn;
+
+std::shared_ptr<const NModel> NModel::Compile(const NNetwork &network)
+{
+    FNN_TRACE_SCOPE("CompileModel");
+
+    static std::atomic<uint64_t> nextId = 1;
+
+    const auto &graph = network.m_network;
+    if (graph == nullptr || graph->Size() == 0 || network.HasCycleForward())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<NModel> model(new NModel());
+    model->m_id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+    std::unordered_map<const Neuron*, uint32_t> slots;
+    const auto slotOf = [&](const Neuron *neuron)
+    {
+        const auto inserted = slots.emplace(neuron, static_cast<uint32_t>(model->m_initialValues.size()));
+        if (inserted.second)
+        {
+            // Neurons ForwardPropagate never evaluates keep their current value
+            model->m_initialValues.push_back(neuron->m_value);
+        }
+        return inserted.first->second;
+    };
+
+    for (const auto inputKey : graph->m_inputs)
+    {
+        const auto &neuron = graph->GetNeuron(inputKey);
+        if (neuron == nullptr)
+        {
+            return nullptr;
+        }
+        model->m_inputSlots.push_back(slotOf(neuron.get()));
+    }
+
+    // Same neurons in the same order as ForwardPropagate, slots are assigned before any head edge reads them
+    std::vector<const Neuron*> evaluated;
+    for (size_t level = 1; level < graph->LevelCount(); ++level)
+    {
+        for (const auto neuronKey : graph->GetLevel(level))
+        {
+            const auto &neuron = graph->GetNeuron(neuronKey);
+            if (neuron->m_neuronType == NeuronType::Input ||
+                ! neuron->m_valueCalculation.has_value() ||
+                ! neuron->m_headConnections.has_value() ||
+                ! neuron->m_activationFunction.has_value() ||
+                neuron->m_activationFunction.value() == nullptr ||
+                slots.contains(neuron.get()))
+            {
+                continue;
+            }
+            model->m_slots.push_back(slotOf(neuron.get()));
+            evaluated.push_back(neuron.get());
+        }
+    }
+
+    model->m_offsets.push_back(0);
+    for (const Neuron *neuron : evaluated)
+    {
+        const auto *valueStrategy = neuron->m_valueCalculation.value().get();
+        const bool isSparse = dynamic_cast<const SparseNeuronValueStrategy*>(valueStrategy) != nullptr;
+        if (! isSparse && dynamic_cast<const NeuronValueStrategy*>(valueStrategy) == nullptr)
+        {
+            // Custom value strategies cannot be expressed as a weighted sum
+            return nullptr;
+        }
+
+        for (const auto &headEdge : neuron->m_headConnections.value())
+        {
+            if (headEdge.m_head == nullptr)
+            {
+                return nullptr;
+            }
+            model->m_parents.push_back(slotOf(headEdge.m_head.get()));
+            model->m_weights.push_back(headEdge.m_weight);
+        }
+        model->m_offsets.push_back(static_cast<uint32_t>(model->m_parents.size()));
+        model->m_isSparse.push_back(isSparse ? 1 : 0);
+        model->m_activations.push_back(neuron->m_activationFunction.value());
+    }
+
+    for (const auto outputKey : graph->m_outputs)
+    {
+        const auto &neuron = graph->GetNeuron(outputKey);
+        if (neuron == nullptr)
+        {
+            return nullptr;
+        }
+        model->m_outputSlots.push_back(slotOf(neuron.get()));
+    }
+    return model;
+}
+
+bool NModel::Predict(InferenceContext &context, const std::vector<float> &x, std::vector<float> &output) const
+{
+    if (x.size() != m_inputSlots.size())
+    {
+        // Input layer has different size than inserted inputs
+        return false;
+    }
+
+    // Constants are written once per context and model, evaluated slots are overwritten by every prediction
+    if (context.m_modelId != m_id)
+    {
+        context.m_values = m_initialValues;
+        context.m_modelId = m_id;
+    }
+
+    float *values = context.m_values.data();
+    for (size_t i = 0; i < x.size(); ++i)
+    {
+        values[m_inputSlots[i]] = x[i];
+    }
+    Evaluate(values);
+
+    output.resize(m_outputSlots.size());
+    for (size_t o = 0; o < m_outputSlots.size(); ++o)
+    {
+        output[o] = values[m_outputSlots[o]];
+    }
+    return true;
+}
+
+bool NModel::Predict(InferenceContext &context, const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output) const
+{
+    FNN_TRACE_SCOPE("ModelPredict");
+
+    output.clear();
+    output.reserve(testX.size());
+
+    // Constants are written into every lane once per context and model
+    if (context.m_lanesModelId != m_id)
+    {
+        InitializeLanes(context.m_lanes);
+        context.m_lanesModelId = m_id;
+    }
+
+    float *values = context.m_lanes.data();
+    for (size_t begin = 0; begin < testX.size(); begin += LANES)
+    {
+        const size_t count = std::min(LANES, testX.size() - begin);
+        if (! LoadLanes(values, testX, begin, count))
+        {
+            // Input layer has different size than inserted inputs
+            return false;
+        }
+        EvaluateLanes(values, count, 0, m_slots.size());
+        output.resize(begin + count);
+        StoreLanes(values, count, output, begin);
+    }
+    return true;
+}
+
+size_t NModel::InputCount() const
+{
+    return m_inputSlots.size();
+}
+
+size_t NModel::OutputCount() const
+{
+    return m_outputSlots.size();
+}
+
+size_t NModel::StorageBytes() const
+{
+    return m_initialValues.capacity() * sizeof(float) +
+           (m_inputSlots.capacity() + m_outputSlots.capacity() + m_slots.capacity() + m_offsets.capacity() + m_parents.capacity()) * sizeof(uint32_t) +
+           m_weights.capacity() * sizeof(float) +
+           m_isSparse.capacity() * sizeof(uint8_t) +
+           m_activations.capacity() * sizeof(std::shared_ptr<INeuronFunctionStrategy>);
+}
+
+void NModel::Evaluate(float *values) const
+{
+    for (size_t n = 0; n < m_slots.size(); ++n)
+    {
+        const uint32_t begin = m_offsets[n];
+        const uint32_t end = m_offsets[n + 1];
+        if (begin == end)
+        {
+            // Value strategies return zero without head connections
+            values[m_slots[n]] = 0.0f;
+            continue;
+        }
+
+        float sum = 0.0f;
+        uint32_t e = begin;
+        if (m_isSparse[n])
+        {
+            // SparseNeuronValueStrategy adds sequentially and skips zero parents
+            for (; e < end; ++e)
+            {
+                const float value = values[m_parents[e]];
+                if (value != 0.0f)
+                {
+                    sum += value * m_weights[e];
+                }
+            }
+        }
+        else
+        {
+            for (; end - e >= 4; e += 4)
+            {
+                sum = sum + ((values[m_parents[e]] * m_weights[e] + values[m_parents[e + 1]] * m_weights[e + 1]) +
+                             (values[m_parents[e + 2]] * m_weights[e + 2] + values[m_parents[e + 3]] * m_weights[e + 3]));
+            }
+            for (; e < end; ++e)
+            {
+                sum = sum + values[m_parents[e]] * m_weights[e];
+            }
+        }
+        values[m_slots[n]] = m_activations[n]->Activation(sum);
+    }
+}
+
+void NModel::InitializeLanes(std::vector<float> &lanes) const
+{
+    lanes.resize(m_initialValues.size() * LANES);
+    for (size_t slot = 0; slot < m_initialValues.size(); ++slot)
+    {
+        std::fill_n(lanes.begin() + slot * LANES, LANES, m_initialValues[slot]);
+    }
+}
+
+bool NModel::LoadLanes(float *values, const std::vector<std::vector<float>> &testX, const size_t begin, const size_t count) const
+{
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        const auto &inputVector = testX[begin + lane];
+        if (inputVector.size() != m_inputSlots.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < inputVector.size(); ++i)
+        {
+            values[m_inputSlots[i] * LANES + lane] = inputVector[i];
+        }
+    }
+    return true;
+}
+
+void NModel::StoreLanes(const float *values, const size_t count, std::vector<std::vector<float>> &output, const size_t begin) const
+{
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        auto &currentOutput = output[begin + lane];
+        currentOutput.resize(m_outputSlots.size());
+        for (size_t o = 0; o < m_outputSlots.size(); ++o)
+        {
+            currentOutput[o] = values[m_outputSlots[o] * LANES + lane];
+        }
+    }
+}
+
+void NModel::EvaluateLanes(float *values, const size_t count, const size_t first, const size_t last) const
+{
+    float sums[LANES];
+    for (size_t n = first; n < last; ++n)
+    {
+        float *result = values + m_slots[n] * LANES;
+        const uint32_t begin = m_offsets[n];
+        const uint32_t end = m_offsets[n + 1];
+        if (begin == end)
+        {
+            // Value strategies return zero without head connections
+            std::fill_n(result, count, 0.0f);
+            continue;
+        }
+
+        // Every lane is summed in the same order as Evaluate, so lanes equal single vector results
+        std::fill_n(sums, count, 0.0f);
+        uint32_t e = begin;
+        if (m_isSparse[n])
+        {
+            for (; e < end; ++e)
+            {
+                const float *parent = values + m_parents[e] * LANES;
+                const float weight = m_weights[e];
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    if (parent[lane] != 0.0f)
+                    {
+                        sums[lane] += parent[lane] * weight;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (; end - e >= 4; e += 4)
+            {
+                const float *v0 = values + m_parents[e] * LANES;
+                const float *v1 = values + m_parents[e + 1] * LANES;
+                const float *v2 = values + m_parents[e + 2] * LANES;
+                const float *v3 = values + m_parents[e + 3] * LANES;
+                const float w0 = m_weights[e];
+                const float w1 = m_weights[e + 1];
+                const float w2 = m_weights[e + 2];
+                const float w3 = m_weights[e + 3];
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    sums[lane] = sums[lane] + ((v0[lane] * w0 + v1[lane] * w1) + (v2[lane] * w2 + v3[lane] * w3));
+                }
+            }
+            for (; e < end; ++e)
+            {
+                const float *parent = values + m_parents[e] * LANES;
+                const float weight = m_weights[e];
+                for (size_t lane = 0; lane < count; ++lane)
+                {
+                    sums[lane] = sums[lane] + parent[lane] * weight;
+                }
+            }
+        }
+        m_activations[n]->ActivationBatch(std::span<const float>(sums, count), std::span<float>(result, count));
+    }
+}
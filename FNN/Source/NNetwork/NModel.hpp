@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @class InferenceContext
+     * @brief Activations of one prediction in flight, owned by a single thread
+     *
+     * Holds the only state NModel::Predict writes, so every thread calling Predict concurrently needs its own context.
+     * A context adapts to whichever model it is passed to
+     */
+    class InferenceContext final
+    {
+    private:
+        friend class NModel;
+
+        uint64_t m_modelId = 0; ///< Model the values were laid out for, zero before first use
+        std::vector<float> m_values; ///< Value of every slot of the model
+        uint64_t m_lanesModelId = 0; ///< Model the lanes were laid out for, zero before first use
+        std::vector<float> m_lanes; ///< Values of every slot for a block of input vectors, element [slot * NModel::LANES + lane]
+    };
+
+    /**
+     * @class NModel
+     * @brief Immutable compiled form of a network for concurrent inference
+     *
+     * Topology and weights are copied once into compressed sparse rows in evaluation order, so the model never refers
+     * back to the network and all methods are const. Any number of threads may call Predict at the same time, each
+     * with its own InferenceContext. Results equal NNetwork::Predict at the time of compilation, later training does
+     * not change the model. Activation strategies are shared with the network and must be stateless, as all library
+     * strategies are
+     */
+    class NModel final
+    {
+    public:
+        /**
+         * @brief Compiles current topology and weights of a network
+         * @param network [in] Network to compile
+         * @return Compiled model, nullptr for empty or cyclic networks and unsupported value strategies
+         */
+        static std::shared_ptr<const NModel> Compile(const NNetwork &network);
+
+        /**
+         * @brief Predicts outputs of a single input vector
+         * @param context [in, out] Activations of the calling thread
+         * @param x [in] Input features
+         * @param output [out] Predicted outputs
+         * @return True if prediction is successful, false when input has wrong size
+         */
+        bool Predict(InferenceContext &context, const std::vector<float> &x, std::vector<float> &output) const;
+
+        /**
+         * @brief Predicts outputs of every input vector
+         *
+         * Input vectors are evaluated in blocks of LANES, each neuron is computed for the whole block at once, which
+         * reads every weight once per block and calls activation once per neuron. Results equal single vector Predict
+         * @param context [in, out] Activations of the calling thread
+         * @param testX [in] Input features for prediction
+         * @param output [out] Predicted outputs
+         * @return True if prediction is successful, false when an input vector has wrong size
+         */
+        bool Predict(InferenceContext &context, const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output) const;
+
+        /**
+         * @brief Returns length of input vectors
+         * @return Number of inputs
+         */
+        size_t InputCount() const;
+
+        /**
+         * @brief Returns length of output vectors
+         * @return Number of outputs
+         */
+        size_t OutputCount() const;
+
+        /**
+         * @brief Returns bytes held by the model, shared by all contexts
+         * @return Size of topology and weight arrays
+         */
+        size_t StorageBytes() const;
+
+        static constexpr size_t LANES = 16; ///< Input vectors evaluated together by batch Predict
+
+    private:
+        friend class InferencePipeline;
+
+        NModel() = default;
+
+        uint64_t m_id = 0; ///< Unique identifier, lets contexts detect a different model
+        std::vector<float> m_initialValues; ///< Value of every slot before evaluation, constants of neurons that are read but never evaluated
+        std::vector<uint32_t> m_inputSlots; ///< Slot of each input in input vector order
+        std::vector<uint32_t> m_outputSlots; ///< Slot of each output in output vector order
+
+        // Evaluated neurons in level order, head edges stored as compressed sparse rows
+        std::vector<uint32_t> m_slots; ///< Slot written by each evaluated neuron
+        std::vector<uint32_t> m_offsets; ///< First head edge of each evaluated neuron, followed by edge count
+        std::vector<uint32_t> m_parents; ///< Slot of the head of each edge
+        std::vector<float> m_weights; ///< Weight of each edge
+        std::vector<uint8_t> m_isSparse; ///< Neuron sums like SparseNeuronValueStrategy instead of NeuronValueStrategy
+        std::vector<std::shared_ptr<INeuronFunctionStrategy>> m_activations; ///< Activation of each evaluated neuron
+
+        /**
+         * @brief Evaluates all neurons for input already stored in values
+         * @param values [in, out] Slot values of a context
+         */
+        void Evaluate(float *values) const;
+
+        /**
+         * @brief Lays out constants of every slot for all lanes
+         * @param lanes [out] Lane values, element [slot * LANES + lane]
+         */
+        void InitializeLanes(std::vector<float> &lanes) const;
+
+        /**
+         * @brief Writes a block of input vectors into lanes
+         * @param values [in, out] Lane values
+         * @param testX [in] Input features
+         * @param begin [in] First input vector of the block
+         * @param count [in] Number of input vectors in the block, at most LANES
+         * @return True if all input vectors have the right size
+         */
+        bool LoadLanes(float *values, const std::vector<std::vector<float>> &testX, const size_t begin, const size_t count) const;
+
+        /**
+         * @brief Copies outputs of a block from lanes
+         * @param values [in] Lane values
+         * @param count [in] Number of input vectors in the block
+         * @param output [in, out] Predicted outputs, must hold at least begin + count vectors
+         * @param begin [in] Output vector of the first lane
+         */
+        void StoreLanes(const float *values, const size_t count, std::vector<std::vector<float>> &output, const size_t begin) const;
+
+        /**
+         * @brief Evaluates a range of neurons for a block of inputs already stored in lanes
+         * @param values [in, out] Lane values
+         * @param count [in] Number of used lanes
+         * @param first [in] First evaluated neuron
+         * @param last [in] One past the last evaluated neuron
+         */
+        void EvaluateLanes(float *values, const size_t count, const size_t first, const size_t last) const;
+    };
+}
@@ -1,8 +1,11 @@
 #include "NNetwork.hpp"
 
+#include <algorithm>
 #include <stack>
 #include <ranges>
 
+#include "BackwardVisits.hpp"
+
 using namespace fnn;
 
 NNetwork::NNetwork() : m_network(std::make_shared<NGraph>(std::initializer_list<size_t>()))
@@ -14,33 +17,104 @@ NNetwork::NNetwork(const std::initializer_list<size_t> &layerSizes, const std::s
 {
 }
 
-bool NNetwork::Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs)
+bool NNetwork::Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const BatchCallback &onBatch)
 {
+    FNN_TRACE_SCOPE("Fit");
+
     if (m_network == nullptr || m_network->Size() == 0 || trainX.size() != trainY.size())
     {
         // Cannot fit empty network or invalid training data size
         return false;
     }
 
+    bool hasCycle = false;
+    {
+        FNN_TRACE_SCOPE("Validation");
+        FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::Validation);
+        hasCycle = HasCycleForward() || HasCycleBackward();
+    }
+
     // Detected cyclic routes using DFS
-    if (HasCycleForward() || HasCycleBackward())
+    if (hasCycle)
     {
         return false;
     }
 
     for (size_t epoch = 0; epoch < epochs; ++epoch)
     {
+        FNN_TRACE_SCOPE("Epoch");
+
         for (size_t i = 0; i < trainX.size(); ++i)
         {
+            // Samples are trained one by one, so a batch is a single sample
+            FNN_TRACE_SCOPE("Batch");
+            FNN_STATISTICS_SAMPLES(m_statistics, 1);
+
             if (! ForwardPropagate(trainX[i]))
             {
                 return false;
             }
-            if (! BackwardPropagateError(trainY[i]))
+            if (! BackwardPropagate(trainY[i]))
             {
                 return false;
             }
-            if (! BackwardPropagateWeights())
+            if (onBatch && ! onBatch(epoch, i))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool NNetwork::FitMiniBatch(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const size_t batchSize,
+                            const BatchCallback &onBatch)
+{
+    FNN_TRACE_SCOPE("FitMiniBatch");
+
+    if (m_network == nullptr || m_network->Size() == 0 || trainX.size() != trainY.size() || batchSize == 0)
+    {
+        // Cannot fit empty network, invalid training data size or empty batches
+        return false;
+    }
+
+    bool hasCycle = false;
+    {
+        FNN_TRACE_SCOPE("Validation");
+        FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::Validation);
+        hasCycle = HasCycleForward() || HasCycleBackward();
+    }
+
+    // Detected cyclic routes using DFS
+    if (hasCycle)
+    {
+        return false;
+    }
+
+    std::vector<float> deltas;
+    for (size_t epoch = 0; epoch < epochs; ++epoch)
+    {
+        FNN_TRACE_SCOPE("Epoch");
+
+        for (size_t begin = 0; begin < trainX.size(); begin += batchSize)
+        {
+            FNN_TRACE_SCOPE("Batch");
+
+            const size_t end = std::min(begin + batchSize, trainX.size());
+            deltas.assign(WeightCount(), 0.0f);
+            for (size_t i = begin; i < end; ++i)
+            {
+                FNN_STATISTICS_SAMPLES(m_statistics, 1);
+                if (! AccumulateWeightDeltas(trainX[i], trainY[i], deltas))
+                {
+                    return false;
+                }
+            }
+            if (! ApplyWeightDeltas(deltas, 1.0f / static_cast<float>(end - begin)))
+            {
+                return false;
+            }
+            if (onBatch && ! onBatch(epoch, begin / batchSize))
             {
                 return false;
             }
@@ -51,14 +125,23 @@ bool NNetwork::Fit(const std::vector<std::vector<float>> &trainX, const std::vec
 
 bool NNetwork::Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output)
 {
+    FNN_TRACE_SCOPE("Predict");
+
     if (m_network == nullptr)
     {
         // Cannot continue with non existing network
         return false;
     }
 
+    bool hasCycle = false;
+    {
+        FNN_TRACE_SCOPE("Validation");
+        FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::Validation);
+        hasCycle = HasCycleForward();
+    }
+
     // Detected cyclic routes using DFS
-    if (HasCycleForward())
+    if (hasCycle)
     {
         return false;
     }
@@ -66,8 +149,26 @@ bool NNetwork::Predict(const std::vector<std::vector<float>> &testX, std::vector
     output.clear();
     output.reserve(testX.size());
 
+    if (m_predictionCache.has_value())
+    {
+        m_predictionCache->Validate(m_network->StructureVersion(), m_network->ParameterVersion());
+    }
+
     for (const auto &inputVector : testX) 
     {
+        FNN_TRACE_SCOPE("Batch");
+        FNN_STATISTICS_SAMPLES(m_statistics, 1);
+
+        if (m_predictionCache.has_value())
+        {
+            const auto *cached = m_predictionCache->Find(inputVector);
+            if (cached != nullptr)
+            {
+                output.push_back(*cached);
+                continue;
+            }
+        }
+
         if (! ForwardPropagate(inputVector))
         {
             return false;
@@ -78,7 +179,7 @@ bool NNetwork::Predict(const std::vector<std::vector<float>> &testX, std::vector
 
         for (const auto &neuronID : m_network->m_outputs)
         {
-            const auto neuron = m_network->GetNeuron(neuronID);
+            const auto &neuron = m_network->GetNeuron(neuronID);
             if (neuron == nullptr)
             {
                 // neuron cannot be nullptr, something went terribly wrong
@@ -88,11 +189,202 @@ bool NNetwork::Predict(const std::vector<std::vector<float>> &testX, std::vector
             currentOutput.push_back(neuron->m_value);
         }
 
+        if (m_predictionCache.has_value())
+        {
+            m_predictionCache->Insert(inputVector, currentOutput);
+        }
         output.push_back(std::move(currentOutput));
     }
     return true;
 }
 
+bool NNetwork::Predict(const std::vector<std::vector<float>> &testX, const std::vector<size_t> &outputKeys, std::vector<std::vector<float>> &output)
+{
+    FNN_TRACE_SCOPE("PredictCone");
+
+    if (m_network == nullptr)
+    {
+        // Cannot continue with non existing network
+        return false;
+    }
+
+    const OutputCone *cone = nullptr;
+    {
+        FNN_TRACE_SCOPE("Validation");
+        FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::Validation);
+        cone = GetOutputCone(outputKeys);
+    }
+
+    // Unknown output or detected cyclic routes
+    if (cone == nullptr || cone->m_hasCycle)
+    {
+        return false;
+    }
+
+    output.clear();
+    output.reserve(testX.size());
+
+    for (const auto &inputVector : testX)
+    {
+        FNN_TRACE_SCOPE("Batch");
+        FNN_STATISTICS_SAMPLES(m_statistics, 1);
+
+        if (! SetInputs(inputVector))
+        {
+            return false;
+        }
+        m_sparsePlan.m_isCurrent = false;
+
+        {
+            FNN_TRACE_SCOPE("ForwardPropagate");
+            FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::ForwardPropagation);
+
+            // Level order guarantees every parent is final before its children, as in the last visit of ForwardPropagate
+            for (Neuron *neuron : cone->m_neurons)
+            {
+                neuron->m_value = neuron->m_valueCalculation.value()->CalculateValue(
+                    neuron->m_headConnections.value(),
+                    neuron->m_activationFunction.value()
+                );
+                FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::ForwardPropagation, 1, neuron->m_headConnections->size());
+            }
+        }
+
+        std::vector<float> currentOutput;
+        currentOutput.reserve(cone->m_outputs.size());
+        for (const Neuron *neuron : cone->m_outputs)
+        {
+            currentOutput.push_back(neuron->m_value);
+        }
+        output.push_back(std::move(currentOutput));
+    }
+    return true;
+}
+
+const TrainingStatistics &NNetwork::GetStatistics() const
+{
+    return m_statistics;
+}
+
+void NNetwork::ResetStatistics()
+{
+    m_statistics.Reset();
+}
+
+GraphReport NNetwork::Report() const
+{
+    if (m_network == nullptr)
+    {
+        return GraphReport();
+    }
+    return utility::graphReport(*m_network);
+}
+
+void NNetwork::SetPropagationMode(const PropagationMode mode)
+{
+    m_propagationMode = mode;
+    if (m_network == nullptr)
+    {
+        return;
+    }
+
+    const bool sparse = mode == PropagationMode::Sparse;
+    if (sparse && m_sparseError == nullptr)
+    {
+        // Strategies count skipped work, so they are owned by the network instead of being interned
+        m_sparseError = std::make_shared<SparseNeuronErrorStrategy>();
+        m_sparseValue = std::make_shared<SparseNeuronValueStrategy>();
+        m_sparseWeight = std::make_shared<SparseNeuronWeightStrategy>();
+    }
+
+    const std::shared_ptr<INeuronErrorStrategy> error = sparse ? std::static_pointer_cast<INeuronErrorStrategy>(m_sparseError) : StrategyRegistry::Get<NeuronErrorStrategy>();
+    const std::shared_ptr<INeuronValueStrategy> value = sparse ? std::static_pointer_cast<INeuronValueStrategy>(m_sparseValue) : StrategyRegistry::Get<NeuronValueStrategy>();
+    const std::shared_ptr<INeuronWeightStrategy> weight = sparse ? std::static_pointer_cast<INeuronWeightStrategy>(m_sparseWeight) : StrategyRegistry::Get<NeuronWeightStrategy>();
+
+    // Only default strategies and their sparse variants are replaced, custom ones are left untouched
+    bool isReplaced = false;
+    for (const auto &neuron : m_network->Neurons())
+    {
+        if (neuron->m_errorCalculation.has_value() && neuron->m_errorCalculation.value() != error &&
+            (dynamic_cast<NeuronErrorStrategy*>(neuron->m_errorCalculation->get()) != nullptr ||
+             dynamic_cast<SparseNeuronErrorStrategy*>(neuron->m_errorCalculation->get()) != nullptr))
+        {
+            neuron->m_errorCalculation = error;
+            isReplaced = true;
+        }
+        if (neuron->m_valueCalculation.has_value() && neuron->m_valueCalculation.value() != value &&
+            (dynamic_cast<NeuronValueStrategy*>(neuron->m_valueCalculation->get()) != nullptr ||
+             dynamic_cast<SparseNeuronValueStrategy*>(neuron->m_valueCalculation->get()) != nullptr))
+        {
+            neuron->m_valueCalculation = value;
+            isReplaced = true;
+        }
+        if (neuron->m_weightCalculation.has_value() && neuron->m_weightCalculation.value() != weight &&
+            (dynamic_cast<NeuronWeightStrategy*>(neuron->m_weightCalculation->get()) != nullptr ||
+             dynamic_cast<SparseNeuronWeightStrategy*>(neuron->m_weightCalculation->get()) != nullptr))
+        {
+            neuron->m_weightCalculation = weight;
+            isReplaced = true;
+        }
+    }
+
+    // Changed strategies require it, cached predictions were computed by the replaced ones
+    if (isReplaced)
+    {
+        m_network->InvalidateParameters();
+    }
+}
+
+PropagationMode NNetwork::GetPropagationMode() const
+{
+    return m_propagationMode;
+}
+
+SparsityCounters NNetwork::GetSparsityCounters() const
+{
+    SparsityCounters counters;
+    if (m_sparseError != nullptr)
+    {
+        counters += m_sparseError->Counters();
+        counters += m_sparseValue->Counters();
+        counters += m_sparseWeight->Counters();
+    }
+    return counters;
+}
+
+void NNetwork::ResetSparsityCounters()
+{
+    if (m_sparseError != nullptr)
+    {
+        m_sparseError->ResetCounters();
+        m_sparseValue->ResetCounters();
+        m_sparseWeight->ResetCounters();
+    }
+}
+
+void NNetwork::SetPredictionCache(const size_t capacity)
+{
+    if (capacity == 0)
+    {
+        m_predictionCache.reset();
+        return;
+    }
+    m_predictionCache.emplace(capacity);
+}
+
+PredictionCacheCounters NNetwork::GetPredictionCacheCounters() const
+{
+    return m_predictionCache.has_value() ? m_predictionCache->Counters() : PredictionCacheCounters();
+}
+
+void NNetwork::ResetPredictionCacheCounters()
+{
+    if (m_predictionCache.has_value())
+    {
+        m_predictionCache->ResetCounters();
+    }
+}
+
 bool NNetwork::HasCycleForward() const
 {
     // Using DFS to detect cycles
@@ -106,7 +398,7 @@ bool NNetwork::HasCycleForward() const
     for (const auto &inputId : m_network->m_inputs)
     {
         // Skip if already visited or in progress
-        const auto neruon = m_network->GetNeuron(inputId);
+        const auto &neruon = m_network->GetNeuron(inputId);
         if (state[neruon] != NOT_VISITED)
         { 
             continue;
@@ -181,7 +473,7 @@ bool NNetwork::HasCycleBackward() const
     for (const auto& oututId : m_network->m_outputs)
     {
         // Skip if already visited or in progress
-        const auto neruon = m_network->GetNeuron(oututId);
+        const auto &neruon = m_network->GetNeuron(oututId);
         if (state[neruon] != NOT_VISITED)
         {
             continue;
@@ -245,6 +537,15 @@ bool NNetwork::HasCycleBackward() const
 
 bool NNetwork::ForwardPropagate(const std::vector<float> &x)
 {
+    FNN_TRACE_SCOPE("ForwardPropagate");
+    FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::ForwardPropagation);
+
+    if (m_propagationMode == PropagationMode::Sparse && UpdateSparsePlan())
+    {
+        return SparseForwardPropagate(x);
+    }
+    m_sparsePlan.m_isCurrent = false;
+
     // Using unordered set to skip already included neurons
     std::unordered_set<std::shared_ptr<Neuron>> currentLayer;
     if (! SetInputsAndDiscoverConnections(x, currentLayer))
@@ -283,6 +584,7 @@ bool NNetwork::ForwardPropagate(const std::vector<float> &x)
                 neuron->m_headConnections.value(),
                 neuron->m_activationFunction.value()
             );
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::ForwardPropagation, 1, neuron->m_headConnections->size());
 
             // When neuron is output or does not have tail connections, do not include it
             if (neuron->m_neuronType == NeuronType::Output || ! neuron->m_tailConnections.has_value())
@@ -303,6 +605,9 @@ bool NNetwork::ForwardPropagate(const std::vector<float> &x)
 
 bool NNetwork::BackwardPropagateError(const std::vector<float> &y)
 {
+    FNN_TRACE_SCOPE("BackwardPropagateError");
+    FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::ErrorPropagation);
+
     // Using unordered set to skip already included neurons
     std::unordered_set<std::shared_ptr<Neuron>> currentLayer;
     if (! SetErrorsAndDiscoverConnections(y, currentLayer))
@@ -341,6 +646,7 @@ bool NNetwork::BackwardPropagateError(const std::vector<float> &y)
                 neuron->m_tailConnections.value(),
                 neuron->m_headConnections.value(),
                 neuron->m_error);
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::ErrorPropagation, 1, neuron->m_tailConnections->size() + neuron->m_headConnections->size());
 
             // When neuron is input, do not include it
             if (neuron->m_neuronType == NeuronType::Input)
@@ -361,6 +667,12 @@ bool NNetwork::BackwardPropagateError(const std::vector<float> &y)
 
 bool NNetwork::BackwardPropagateWeights()
 {
+    FNN_TRACE_SCOPE("BackwardPropagateWeights");
+    FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::WeightUpdate);
+
+    // Weights change from here on, cached predictions are outdated even if the pass fails midway
+    m_network->InvalidateParameters();
+
     // Using unordered set to skip already included neurons
     std::unordered_set<std::shared_ptr<Neuron>> currentLayer;
     if (! SetWeightsAndDiscoverConnections(currentLayer))
@@ -398,6 +710,7 @@ bool NNetwork::BackwardPropagateWeights()
                 neuron->m_headConnections.value(),
                 neuron->m_learningRate.value(),
                 neuron->m_error);
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::WeightUpdate, 1, neuron->m_headConnections->size());
 
             // When neuron is input, do not include it
             if (neuron->m_neuronType == NeuronType::Input)
@@ -416,6 +729,540 @@ bool NNetwork::BackwardPropagateWeights()
     return true;
 }
 
+bool NNetwork::BackwardPropagate(const std::vector<float> &y)
+{
+    FNN_TRACE_SCOPE("BackwardPropagate");
+
+    UpdateBackwardSteps();
+    if (! m_isBackwardFused)
+    {
+        // Custom strategies may read other neurons, which needs every error before the first weight update
+        return BackwardPropagateError(y) && BackwardPropagateWeights();
+    }
+
+    FNN_STATISTICS_SCOPE(m_statistics, TrainingPhase::BackwardPropagation);
+
+    if (m_network->m_outputs.size() != y.size())
+    {
+        // Output layer has different size than inserted target
+        return false;
+    }
+
+    // Weights change from here on, cached predictions are outdated
+    m_network->InvalidateParameters();
+
+    for (size_t o = 0; o < y.size(); ++o)
+    {
+        m_network->GetNeuron(m_network->m_outputs[o])->m_target = y[o];
+    }
+
+    const bool hasNonZeroHeads = m_sparseWeight != nullptr && m_sparsePlan.m_isCurrent && m_sparsePlan.m_version == m_backwardStepsVersion;
+
+    // Each neuron reads only its own edges, its own error and forward values, so it finishes all its work in one visit
+    for (const auto &step : m_backwardSteps)
+    {
+        Neuron &neuron = *step.m_neuron;
+        if (step.m_hasOutputError)
+        {
+            neuron.m_error = neuron.m_errorCalculation.value()->CalculateError(neuron.m_target.value(), neuron.m_error);
+        }
+        for (uint32_t visit = 0; visit < step.m_errorVisits; ++visit)
+        {
+            neuron.m_error = neuron.m_errorCalculation.value()->CalculateError(
+                neuron.m_tailConnections.value(),
+                neuron.m_headConnections.value(),
+                neuron.m_error);
+        }
+
+        const uint32_t updates = step.m_weightVisits + (step.m_hasOutputWeights ? 1 : 0);
+        if (hasNonZeroHeads && step.m_weightStrategy == m_sparseWeight.get() && step.m_index < m_sparsePlan.m_isPlanned.size() &&
+            m_sparsePlan.m_isPlanned[step.m_index])
+        {
+            // Forward values are unchanged since the sparse pass listed the non zero heads
+            for (uint32_t update = 0; update < updates; ++update)
+            {
+                m_sparseWeight->UpdateConectedWeights(
+                    neuron.m_headConnections.value(),
+                    m_sparsePlan.m_nonZeroHeads[step.m_index],
+                    neuron.m_learningRate.value(),
+                    neuron.m_error);
+            }
+        }
+        else
+        {
+            for (uint32_t update = 0; update < updates; ++update)
+            {
+                neuron.m_weightCalculation.value()->UpdateConectedWeights(
+                    neuron.m_headConnections.value(),
+                    neuron.m_learningRate.value(),
+                    neuron.m_error);
+            }
+        }
+        FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::BackwardPropagation, 1,
+            step.m_errorVisits * (neuron.m_tailConnections.has_value() ? neuron.m_tailConnections->size() : 0) +
+            (step.m_errorVisits + updates) * (neuron.m_headConnections.has_value() ? neuron.m_headConnections->size() : 0));
+    }
+    return true;
+}
+
+size_t NNetwork::WeightCount() const
+{
+    size_t count = 0;
+    for (const auto &neuron : m_network->Neurons())
+    {
+        count += neuron->m_headConnections.has_value() ? neuron->m_headConnections->size() : 0;
+    }
+    return count;
+}
+
+void NNetwork::GetWeights(std::vector<float> &weights) const
+{
+    weights.clear();
+    for (const auto &neuron : m_network->Neurons())
+    {
+        if (neuron->m_headConnections.has_value())
+        {
+            for (const auto &headEdge : neuron->m_headConnections.value())
+            {
+                weights.push_back(headEdge.m_weight);
+            }
+        }
+    }
+}
+
+bool NNetwork::SetWeights(const std::vector<float> &weights)
+{
+    if (weights.size() != WeightCount())
+    {
+        return false;
+    }
+
+    auto it = weights.begin();
+    for (const auto &neuron : m_network->Neurons())
+    {
+        if (neuron->m_headConnections.has_value())
+        {
+            for (auto &headEdge : neuron->m_headConnections.value())
+            {
+                headEdge.m_weight = *it;
+                ++it;
+            }
+        }
+    }
+    m_network->InvalidateParameters();
+    return true;
+}
+
+bool NNetwork::AccumulateWeightDeltas(const std::vector<float> &x, const std::vector<float> &y, std::vector<float> &deltas)
+{
+    if (deltas.empty())
+    {
+        deltas.assign(WeightCount(), 0.0f);
+    }
+    if (deltas.size() != WeightCount() || ! ForwardPropagate(x))
+    {
+        return false;
+    }
+
+    // Errors carried over from the previous sample would make samples depend on their order
+    for (const auto &neuron : m_network->Neurons())
+    {
+        neuron->m_error = 0.0f;
+    }
+
+    // Weight strategies update in place, so the change is read back and the weights restored
+    GetWeights(m_weightsBefore);
+    if (! BackwardPropagate(y))
+    {
+        SetWeights(m_weightsBefore);
+        return false;
+    }
+
+    auto before = m_weightsBefore.begin();
+    auto delta = deltas.begin();
+    for (const auto &neuron : m_network->Neurons())
+    {
+        if (neuron->m_headConnections.has_value())
+        {
+            for (auto &headEdge : neuron->m_headConnections.value())
+            {
+                *delta += headEdge.m_weight - *before;
+                headEdge.m_weight = *before;
+                ++before;
+                ++delta;
+            }
+        }
+    }
+    return true;
+}
+
+bool NNetwork::ApplyWeightDeltas(const std::vector<float> &deltas, const float scale)
+{
+    if (deltas.size() != WeightCount())
+    {
+        return false;
+    }
+
+    auto delta = deltas.begin();
+    for (const auto &neuron : m_network->Neurons())
+    {
+        if (neuron->m_headConnections.has_value())
+        {
+            for (auto &headEdge : neuron->m_headConnections.value())
+            {
+                headEdge.m_weight += *delta * scale;
+                ++delta;
+            }
+        }
+    }
+    m_network->InvalidateParameters();
+    return true;
+}
+
+const NNetwork::OutputCone *NNetwork::GetOutputCone(const std::vector<size_t> &outputKeys)
+{
+    // Any structural change invalidates all cones
+    if (m_outputConesVersion != m_network->StructureVersion())
+    {
+        m_outputCones.clear();
+        m_outputConesVersion = m_network->StructureVersion();
+    }
+
+    const auto cached = m_outputCones.find(outputKeys);
+    if (cached != m_outputCones.end())
+    {
+        return &cached->second;
+    }
+
+    OutputCone cone;
+
+    // Collect every neuron the requested outputs depend on through head connections
+    std::unordered_set<const Neuron*> members;
+    std::vector<const Neuron*> stack;
+    for (const auto outputKey : outputKeys)
+    {
+        const auto &neuron = m_network->GetNeuron(outputKey);
+        if (neuron == nullptr || neuron->m_neuronType != NeuronType::Output)
+        {
+            return nullptr;
+        }
+
+        cone.m_outputs.push_back(neuron.get());
+        if (members.insert(neuron.get()).second)
+        {
+            stack.push_back(neuron.get());
+        }
+    }
+    while (! stack.empty())
+    {
+        const Neuron *neuron = stack.back();
+        stack.pop_back();
+
+        if (! neuron->m_headConnections.has_value())
+        {
+            continue;
+        }
+        for (const auto &headEdge : neuron->m_headConnections.value())
+        {
+            if (headEdge.m_head != nullptr && members.insert(headEdge.m_head.get()).second)
+            {
+                stack.push_back(headEdge.m_head.get());
+            }
+        }
+    }
+
+    // Evaluation order comes from the level index, neurons ForwardPropagate cannot evaluate are left out the same way
+    for (size_t level = 1; level < m_network->LevelCount(); ++level)
+    {
+        for (const auto neuronKey : m_network->GetLevel(level))
+        {
+            const auto &neuron = m_network->GetNeuron(neuronKey);
+            if (! members.contains(neuron.get()) ||
+                neuron->m_neuronType == NeuronType::Input ||
+                ! neuron->m_valueCalculation.has_value() ||
+                ! neuron->m_headConnections.has_value() ||
+                ! neuron->m_activationFunction.has_value() ||
+                neuron->m_activationFunction.value() == nullptr)
+            {
+                continue;
+            }
+            cone.m_neurons.push_back(neuron.get());
+        }
+    }
+
+    // Cycle detection is part of the cached structure, repeated calls skip it
+    cone.m_hasCycle = HasCycleForward();
+
+    auto &stored = m_outputCones[outputKeys];
+    stored = std::move(cone);
+    return &stored;
+}
+
+void NNetwork::UpdateBackwardSteps()
+{
+    const auto errorStrategyOf = [](const Neuron &neuron) -> const INeuronErrorStrategy*
+    {
+        return neuron.m_errorCalculation.has_value() ? neuron.m_errorCalculation.value().get() : nullptr;
+    };
+    const auto weightStrategyOf = [](const Neuron &neuron) -> const INeuronWeightStrategy*
+    {
+        return neuron.m_weightCalculation.has_value() ? neuron.m_weightCalculation.value().get() : nullptr;
+    };
+
+    // Replaced strategies, e.g. by SetPropagationMode, or learning rates added or removed, e.g. by MapLearningRate of
+    // a single layer, can change which neurons the passes reach
+    if (m_backwardStepsVersion == m_network->StructureVersion() &&
+        std::ranges::all_of(m_backwardSteps, [&](const BackwardStep &step)
+        {
+            return errorStrategyOf(*step.m_neuron) == step.m_errorStrategy && weightStrategyOf(*step.m_neuron) == step.m_weightStrategy &&
+                   step.m_neuron->m_learningRate.has_value() == step.m_hasLearningRate;
+        }))
+    {
+        return;
+    }
+
+    m_backwardSteps.clear();
+    m_backwardStepsVersion = m_network->StructureVersion();
+    m_isBackwardFused = false;
+
+    BackwardVisits visits;
+    if (! utility::countBackwardVisits(*m_network, visits))
+    {
+        // Missing or repeated outputs and edges leaving the graph are left to the separate passes
+        return;
+    }
+
+    std::vector<uint8_t> hasOutputError(visits.m_isReached.size(), 0);
+    std::vector<uint8_t> hasOutputWeights(visits.m_isReached.size(), 0);
+    for (size_t o = 0; o < m_network->m_outputs.size(); ++o)
+    {
+        const size_t index = m_network->GetIndex(m_network->m_outputs[o]);
+        hasOutputError[index] = visits.m_hasOutputError[o];
+        hasOutputWeights[index] = visits.m_hasOutputWeights[o];
+    }
+
+    // Every reached neuron gets a step, even one that does not qualify, so changes that would make it qualify are seen
+    const auto neurons = m_network->Neurons();
+    for (size_t index = 0; index < neurons.size(); ++index)
+    {
+        if (! visits.m_isReached[index])
+        {
+            continue;
+        }
+
+        BackwardStep step;
+        step.m_neuron = neurons[index].get();
+        step.m_index = static_cast<uint32_t>(index);
+        step.m_errorStrategy = errorStrategyOf(*step.m_neuron);
+        step.m_weightStrategy = weightStrategyOf(*step.m_neuron);
+        step.m_hasLearningRate = step.m_neuron->m_learningRate.has_value();
+        step.m_hasOutputError = hasOutputError[index] != 0;
+        step.m_hasOutputWeights = hasOutputWeights[index] != 0;
+        step.m_errorVisits = visits.m_errorVisits[index];
+        step.m_weightVisits = visits.m_weightVisits[index];
+        m_backwardSteps.push_back(step);
+    }
+
+    // Only library strategies are known to read nothing but the neuron's own edges and error
+    m_isBackwardFused = std::ranges::all_of(m_backwardSteps, [](const BackwardStep &step)
+    {
+        const bool hasError = step.m_hasOutputError || step.m_errorVisits != 0;
+        const bool hasWeights = step.m_hasOutputWeights || step.m_weightVisits != 0;
+        return (! hasError || dynamic_cast<const NeuronErrorStrategy*>(step.m_errorStrategy) != nullptr ||
+                              dynamic_cast<const SparseNeuronErrorStrategy*>(step.m_errorStrategy) != nullptr) &&
+               (! hasWeights || dynamic_cast<const NeuronWeightStrategy*>(step.m_weightStrategy) != nullptr ||
+                                dynamic_cast<const SparseNeuronWeightStrategy*>(step.m_weightStrategy) != nullptr);
+    });
+}
+
+bool NNetwork::UpdateSparsePlan()
+{
+    auto &plan = m_sparsePlan;
+    if (plan.m_version == m_network->StructureVersion())
+    {
+        return plan.m_isValid;
+    }
+
+    plan.m_version = m_network->StructureVersion();
+    plan.m_isValid = false;
+    plan.m_isCurrent = false;
+    plan.m_neurons.clear();
+    plan.m_sources.clear();
+    plan.m_order.clear();
+    plan.m_children.clear();
+
+    std::unordered_map<const Neuron*, uint32_t> indices;
+    for (const auto &neuron : m_network->Neurons())
+    {
+        indices.emplace(neuron.get(), static_cast<uint32_t>(plan.m_neurons.size()));
+        plan.m_neurons.push_back(neuron.get());
+    }
+
+    // Same neurons and order GetOutputCone and InferenceSession evaluate
+    plan.m_isPlanned.assign(plan.m_neurons.size(), 0);
+    for (size_t level = 1; level < m_network->LevelCount(); ++level)
+    {
+        for (const auto neuronKey : m_network->GetLevel(level))
+        {
+            const uint32_t index = static_cast<uint32_t>(m_network->GetIndex(neuronKey));
+            if (plan.m_neurons[index]->m_neuronType != NeuronType::Input)
+            {
+                plan.m_order.push_back(index);
+                plan.m_isPlanned[index] = 1;
+            }
+        }
+    }
+
+    // Children are found through head edges, the connections the value calculation actually reads
+    std::vector<uint32_t> childCounts(plan.m_neurons.size() + 1, 0);
+    for (const uint32_t index : plan.m_order)
+    {
+        const Neuron *neuron = plan.m_neurons[index];
+        if (! neuron->m_headConnections.has_value())
+        {
+            continue;
+        }
+        for (const auto &headEdge : neuron->m_headConnections.value())
+        {
+            const auto head = indices.find(headEdge.m_head.get());
+            if (head == indices.end())
+            {
+                // A head outside of the graph could never push its value
+                return false;
+            }
+            ++childCounts[head->second];
+        }
+    }
+
+    plan.m_childOffsets.assign(plan.m_neurons.size() + 1, 0);
+    for (size_t index = 0; index < plan.m_neurons.size(); ++index)
+    {
+        plan.m_childOffsets[index + 1] = plan.m_childOffsets[index] + childCounts[index];
+        if (childCounts[index] != 0 && ! plan.m_isPlanned[index])
+        {
+            plan.m_sources.push_back(static_cast<uint32_t>(index));
+        }
+    }
+
+    plan.m_children.resize(plan.m_childOffsets.back());
+    std::vector<uint32_t> filled(plan.m_childOffsets.begin(), plan.m_childOffsets.end() - 1);
+    for (const uint32_t index : plan.m_order)
+    {
+        const Neuron *neuron = plan.m_neurons[index];
+        if (! neuron->m_headConnections.has_value())
+        {
+            continue;
+        }
+        const auto &headEdges = neuron->m_headConnections.value();
+        for (uint32_t position = 0; position < headEdges.size(); ++position)
+        {
+            const uint32_t head = indices.at(headEdges[position].m_head.get());
+            plan.m_children[filled[head]++] = { index, position };
+        }
+    }
+
+    plan.m_nonZeroHeads.resize(plan.m_neurons.size());
+    plan.m_isUnordered.assign(plan.m_neurons.size(), 0);
+    plan.m_isValid = true;
+    return true;
+}
+
+bool NNetwork::SparseForwardPropagate(const std::vector<float> &x)
+{
+    auto &plan = m_sparsePlan;
+    plan.m_isCurrent = false;
+    if (! SetInputs(x))
+    {
+        return false;
+    }
+
+    for (const uint32_t index : plan.m_order)
+    {
+        plan.m_nonZeroHeads[index].clear();
+        plan.m_isUnordered[index] = 0;
+    }
+
+    // Zero values list nothing, so their edges are neither summed nor updated
+    const auto push = [&plan](const uint32_t index)
+    {
+        if (plan.m_neurons[index]->m_value == 0.0f)
+        {
+            return;
+        }
+        for (uint32_t c = plan.m_childOffsets[index]; c < plan.m_childOffsets[index + 1]; ++c)
+        {
+            const auto [child, position] = plan.m_children[c];
+            auto &heads = plan.m_nonZeroHeads[child];
+            if (! heads.empty() && heads.back() > position)
+            {
+                plan.m_isUnordered[child] = 1;
+            }
+            heads.push_back(position);
+        }
+    };
+
+    for (const uint32_t index : plan.m_sources)
+    {
+        push(index);
+    }
+
+    // Level order guarantees every head pushed its final value before a neuron is evaluated
+    for (const uint32_t index : plan.m_order)
+    {
+        Neuron *neuron = plan.m_neurons[index];
+        auto &heads = plan.m_nonZeroHeads[index];
+        if (plan.m_isUnordered[index])
+        {
+            // Ascending positions keep the summation order of the dense strategies
+            std::ranges::sort(heads);
+        }
+
+        if (neuron->m_valueCalculation.has_value() &&
+            neuron->m_headConnections.has_value() &&
+            neuron->m_activationFunction.has_value() &&
+            neuron->m_activationFunction.value() != nullptr)
+        {
+            if (neuron->m_valueCalculation.value().get() == m_sparseValue.get())
+            {
+                neuron->m_value = m_sparseValue->CalculateValue(neuron->m_headConnections.value(), heads, neuron->m_activationFunction.value());
+            }
+            else
+            {
+                neuron->m_value = neuron->m_valueCalculation.value()->CalculateValue(
+                    neuron->m_headConnections.value(),
+                    neuron->m_activationFunction.value()
+                );
+            }
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::ForwardPropagation, 1, heads.size());
+        }
+        push(index);
+    }
+
+    plan.m_isCurrent = true;
+    return true;
+}
+
+bool NNetwork::SetInputs(const std::vector<float> &inputX)
+{
+    if (inputX.size() != m_network->m_inputs.size())
+    {
+        // Input layer has different size than inserted inputs
+        return false;
+    }
+
+    for (size_t i = 0; i < inputX.size(); ++i)
+    {
+        const auto &inputNeuron = m_network->GetNeuron(m_network->m_inputs[i]);
+        if (inputNeuron == nullptr)
+        {
+            // Neuron cannot be nullptr, something went terribly wrong
+            return false;
+        }
+        inputNeuron->m_value = inputX[i];
+    }
+    return true;
+}
+
 bool NNetwork::SetInputsAndDiscoverConnections(const std::vector<float> &inputX, std::unordered_set<std::shared_ptr<Neuron>> &nextLayer)
 {
     if (inputX.size() != m_network->m_inputs.size())
@@ -427,7 +1274,7 @@ bool NNetwork::SetInputsAndDiscoverConnections(const std::vector<float> &inputX,
     auto it = inputX.begin();
     for (const auto &inputNeuronKey : m_network->m_inputs)
     {
-        const auto inputNeuron = m_network->GetNeuron(inputNeuronKey);
+        const auto &inputNeuron = m_network->GetNeuron(inputNeuronKey);
         if (inputNeuron == nullptr)
         {
             // Neuron cannot be nullptr, something went terribly wrong
@@ -461,7 +1308,7 @@ bool NNetwork::SetErrorsAndDiscoverConnections(const std::vector<float> &target,
     auto it = target.begin();
     for (const auto &outputNeuronKey : m_network->m_outputs)
     {
-        auto outputNeuron = m_network->GetNeuron(outputNeuronKey);
+        const auto &outputNeuron = m_network->GetNeuron(outputNeuronKey);
         if (outputNeuron == nullptr)
         {
             // Neuron cannot be nullptr, something went terribly wrong
@@ -480,6 +1327,7 @@ bool NNetwork::SetErrorsAndDiscoverConnections(const std::vector<float> &target,
         {
             // Calculate error for output layer
             outputNeuron->m_error = outputNeuron->m_errorCalculation.value()->CalculateError(outputNeuron->m_target.value(), outputNeuron->m_error);
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::ErrorPropagation, 1, 0);
 
             for (const auto &headEdges : outputNeuron->m_headConnections.value())
             {
@@ -494,7 +1342,7 @@ bool NNetwork::SetWeightsAndDiscoverConnections(std::unordered_set<std::shared_p
 {
     for (const auto& inputNeuronKey : m_network->m_outputs)
     {
-        auto outputNeuron = m_network->GetNeuron(inputNeuronKey);
+        const auto &outputNeuron = m_network->GetNeuron(inputNeuronKey);
         if (outputNeuron == nullptr)
         {
             // Neuron cannot be nullptr, something went terribly wrong
@@ -513,6 +1361,7 @@ bool NNetwork::SetWeightsAndDiscoverConnections(std::unordered_set<std::shared_p
                 outputNeuron->m_headConnections.value(),
                 outputNeuron->m_learningRate.value(),
                 outputNeuron->m_error);
+            FNN_STATISTICS_VISIT(m_statistics, TrainingPhase::WeightUpdate, 1, outputNeuron->m_headConnections->size());
 
             for (const auto &headEdge : outputNeuron->m_headConnections.value())
             {
@@ -1,17 +1,49 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 #include <initializer_list>
+#include <map>
+#include <optional>
 
 #include "NGraph.hpp"
+#include "PredictionCache.hpp"
 #include "../Edge/Edge.hpp"
+#include "../Neuron/NeuronStrategy.hpp"
 #include "../Random/RandomStrategyInterface.hpp"
 #include "../Random/RandomStrategyInterface.hpp"
 #include "../Random/RandomStrategy.hpp"
+#include "../Statistics/TrainingStatistics.hpp"
+#include "../Statistics/GraphReport.hpp"
+#include "../Statistics/Tracer.hpp"
 
 namespace fnn
 {
+    /**
+     * @enum PropagationMode
+     * @brief Selects how value, error and weight strategies treat zero activations and errors
+     */
+    enum class PropagationMode
+    {
+        Dense,  ///< Every edge is evaluated and updated
+        Sparse, ///< Contributions and updates that are provably zero are skipped and counted
+    };
+
+    class NNetwork;
+
+    namespace bench
+    {
+        class NetworkPasses;
+    }
+
+    namespace utility
+    {
+        bool dataParallelFit(NNetwork &network, const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY,
+                             const size_t epochs, const size_t batchSize, const size_t workers);
+    }
+
     /**
      * @class NNetwork
      * @brief Represents a neural network encapsulating a graph of neurons
@@ -25,6 +57,14 @@ namespace fnn
         std::shared_ptr<NGraph> m_network; ///< Graph structure representing the neural network
 
 
+        /**
+         * @brief Called by Fit and FitMiniBatch after the weights of every batch were updated
+         *
+         * Receives the epoch and the batch within the epoch, both counted from zero, returning false stops training
+         */
+        using BatchCallback = std::function<bool(const size_t epoch, const size_t batch)>;
+
+
         NNetwork();
         /**
          * @brief Initializes the neural network with specified layer sizes and random strategy
@@ -39,19 +79,172 @@ namespace fnn
          * @param trainX [in] Input features for training
          * @param trainY [in] Target outputs for training
          * @param epochs [in] Number of training iterations, default is 10
-         * @return True if training is successful, false otherwise
+         * @param onBatch [in] Called after every sample, which is a batch of Fit, may be empty
+         * @return True if training is successful, false otherwise or when onBatch returned false
          */
-        bool Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs = 10);
+        bool Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs = 10, const BatchCallback &onBatch = nullptr);
+
+        /**
+         * @brief Trains the neural network with averaged weight updates of mini-batches
+         *
+         * Every sample of a batch starts from zero errors and the weights of the batch start, so samples are independent
+         * and a batch can be split between workers, see utility::dataParallelFit. Weight changes of the samples are
+         * averaged and applied once per batch
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations
+         * @param batchSize [in] Samples per weight update, the last batch of an epoch may be smaller
+         * @param onBatch [in] Called after the update of every batch, may be empty
+         * @return True if training is successful, false otherwise or when onBatch returned false
+         */
+        bool FitMiniBatch(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs, const size_t batchSize,
+                          const BatchCallback &onBatch = nullptr);
 
         /**
          * @brief Predicts the output for given input data
+         *
+         * With a prediction cache enabled, rows predicted before are answered from the cache and leave neuron values
+         * untouched
          * @param testX [in] Input features for prediction
          * @param output [out] Predicted outputs
          * @return True if prediction is successful, false otherwise
          */
         bool Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output);
 
+        /**
+         * @brief Predicts only requested outputs, evaluating just the neurons they depend on
+         *
+         * The backward reachable cone of the requested outputs is computed on first use of an output list and cached
+         * until the graph structure changes. Requested values equal the ones Predict returns
+         * @param testX [in] Input features for prediction
+         * @param outputKeys [in] Keys of requested output neurons, order of returned values
+         * @param output [out] Predicted values of requested outputs for each input vector
+         * @return True if prediction is successful, false otherwise
+         */
+        bool Predict(const std::vector<std::vector<float>> &testX, const std::vector<size_t> &outputKeys, std::vector<std::vector<float>> &output);
+
+
+        /**
+         * @brief Returns statistics accumulated by Fit and Predict since construction or last reset
+         *
+         * Counters stay zero unless the library is built with FNN_ENABLE_STATISTICS
+         * @return Accumulated statistics
+         */
+        const TrainingStatistics &GetStatistics() const;
+
+        /**
+         * @brief Sets all accumulated statistics to zero
+         */
+        void ResetStatistics();
+
+        /**
+         * @brief Computes estimated memory footprint and shape statistics of the network
+         * @return Report of the graph, empty report when there is no graph
+         */
+        GraphReport Report() const;
+
+
+        /**
+         * @brief Switches default value, error and weight strategies of all neurons between dense and sparse variants
+         *
+         * Sparse mode pays off when most activations or errors are zero, e.g. with ReLUStrategy. Its forward pass lists
+         * the non zero heads of every neuron per sample, value calculation and weight update then skip edges of zero
+         * heads without visiting them, and neurons with zero error skip their error and weight work. Results are bit
+         * identical to dense mode for finite weights. Neurons with custom strategies keep them. Neurons added later get
+         * the strategies they are built with, call again to convert them. Replacing a strategy drops cached predictions
+         * @param mode [in] Mode to apply
+         */
+        void SetPropagationMode(const PropagationMode mode);
+
+        /**
+         * @brief Returns mode applied by the last SetPropagationMode call
+         * @return Current propagation mode, Dense by default
+         */
+        PropagationMode GetPropagationMode() const;
+
+        /**
+         * @brief Returns work done and skipped by sparse strategies since they were created or last reset
+         * @return Sparsity counters, all zero in dense mode
+         */
+        SparsityCounters GetSparsityCounters() const;
+
+        /**
+         * @brief Sets sparsity counters to zero
+         */
+        void ResetSparsityCounters();
+
+
+        /**
+         * @brief Enables least recently used cache of Predict results or disables it
+         *
+         * Cached results are dropped whenever Fit, BackwardPropagateWeights, MapFunction, SetPropagationMode or any
+         * structural change of the graph modifies what the network computes. Weights or strategies changed directly
+         * require NGraph::InvalidateParameters. Predict of selected outputs is not cached
+         * @param capacity [in] Maximum number of cached rows, 0 disables and drops the cache
+         */
+        void SetPredictionCache(const size_t capacity);
+
+        /**
+         * @brief Returns hits, misses, evictions and invalidations of the prediction cache
+         * @return Counters since the cache was enabled or last reset, all zero when disabled
+         */
+        PredictionCacheCounters GetPredictionCacheCounters() const;
+
+        /**
+         * @brief Sets prediction cache counters to zero
+         */
+        void ResetPredictionCacheCounters();
+
+
+        // Flat weight access used by mini-batch and data parallel training, weights are head edge weights of neurons
+        // in dense storage order
+
+        /**
+         * @brief Returns number of head edge weights
+         * @return Length of flat weight vectors
+         */
+        size_t WeightCount() const;
+
+        /**
+         * @brief Copies all head edge weights into a flat vector
+         * @param weights [out] Weights in dense storage order
+         */
+        void GetWeights(std::vector<float> &weights) const;
+
+        /**
+         * @brief Overwrites all head edge weights from a flat vector
+         * @param weights [in] Weights in dense storage order
+         * @return True if weights were set, false when length differs from WeightCount
+         */
+        bool SetWeights(const std::vector<float> &weights);
+
+        /**
+         * @brief Adds weight changes one sample would cause to a flat vector, leaving weights unchanged
+         *
+         * Errors of all neurons are reset before the error pass, so the result depends only on weights and the sample
+         * @param x [in] Single set of input features
+         * @param y [in] Single set of target outputs
+         * @param deltas [in, out] Accumulated weight changes, resized to WeightCount when empty
+         * @return True if passes were successful, false otherwise
+         */
+        bool AccumulateWeightDeltas(const std::vector<float> &x, const std::vector<float> &y, std::vector<float> &deltas);
+
+        /**
+         * @brief Adds scaled weight changes to all head edge weights
+         * @param deltas [in] Weight changes in dense storage order
+         * @param scale [in] Factor applied to every change
+         * @return True if weights were changed, false when length differs from WeightCount
+         */
+        bool ApplyWeightDeltas(const std::vector<float> &deltas, const float scale);
+
     private:
+        friend class InferenceSession;
+        friend class NModel;
+        friend class PopulationTrainer;
+        friend class bench::NetworkPasses;
+        friend bool utility::dataParallelFit(NNetwork &network, const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY,
+                                             const size_t epochs, const size_t batchSize, const size_t workers);
+
         // Methods for internal use in the training and prediction processes
 
         // TODO: When I start hating my self, implement option to allow maximum number of allowed cycles
@@ -88,8 +281,128 @@ namespace fnn
          */
         bool BackwardPropagateWeights();
 
+        /**
+         * @brief Propagates errors and updates weights in a single sweep, used by Fit
+         *
+         * A neuron's error depends only on its own edges and previous error and its weight update only on its final
+         * error and forward values, so every neuron computes its error and then updates its head weights in one
+         * visit, as often as the separate passes would reach it. Visit counts are cached until the graph structure,
+         * a neuron's error or weight strategy or whether it has a learning rate changes. Result equals
+         * BackwardPropagateError followed by BackwardPropagateWeights, which are used instead when a neuron has a
+         * custom error or weight strategy
+         * @param y [in] Single set of target outputs
+         * @return True if propagation is successful, false otherwise
+         */
+        bool BackwardPropagate(const std::vector<float> &y);
+
+        /**
+         * @struct OutputCone
+         * @brief Neurons a list of outputs depends on, in evaluation order
+         */
+        struct OutputCone final
+        {
+        public:
+            bool m_hasCycle = false; ///< Result of forward cycle detection for that structure
+            std::vector<Neuron*> m_neurons; ///< Non input neurons of the cone ordered by level
+            std::vector<Neuron*> m_outputs; ///< Requested output neurons in requested order
+        };
+
+        std::map<std::vector<size_t>, OutputCone> m_outputCones; ///< Cones by requested output keys
+        uint64_t m_outputConesVersion = UINT64_MAX; ///< Graph structure version the cached cones were computed for
+
+        /**
+         * @struct BackwardStep
+         * @brief Work of one neuron in the fused backward pass
+         */
+        struct BackwardStep final
+        {
+        public:
+            Neuron *m_neuron = nullptr; ///< Visited neuron
+            uint32_t m_index = 0; ///< Dense storage index of the neuron
+            const INeuronErrorStrategy *m_errorStrategy = nullptr; ///< Error strategy the visit counts were made for
+            const INeuronWeightStrategy *m_weightStrategy = nullptr; ///< Weight strategy the visit counts were made for
+            bool m_hasLearningRate = false; ///< Learning rate presence the visit counts were made for
+            bool m_hasOutputError = false; ///< Error is computed once from the target as an output
+            bool m_hasOutputWeights = false; ///< Head weights are updated once as an output
+            uint32_t m_errorVisits = 0; ///< Times the error pass recomputes the error after the output error
+            uint32_t m_weightVisits = 0; ///< Times the weight pass updates head weights after the output update
+        };
+
+        std::vector<BackwardStep> m_backwardSteps; ///< Neurons reached by the backward passes in dense storage order
+        uint64_t m_backwardStepsVersion = UINT64_MAX; ///< Graph structure version the steps were counted for
+        bool m_isBackwardFused = false; ///< All steps use library strategies, so neurons can be processed independently
+
+        /**
+         * @struct SparsePlan
+         * @brief Evaluation order and edge lists of the sparse forward pass with the non zero heads of its last sample
+         *
+         * Neurons are identified by their dense storage index
+         */
+        struct SparsePlan final
+        {
+        public:
+            uint64_t m_version = UINT64_MAX; ///< Graph structure version the plan was built for
+            bool m_isValid = false; ///< Every head of a planned neuron belongs to the graph
+            bool m_isCurrent = false; ///< Lists describe neuron values of the last forward pass
+            std::vector<Neuron*> m_neurons; ///< Neurons in dense storage order
+            std::vector<uint32_t> m_sources; ///< Neurons read by planned neurons but not evaluated, pushed first
+            std::vector<uint32_t> m_order; ///< Neurons above the input level in level order
+            std::vector<uint32_t> m_childOffsets; ///< Start of each neuron's children in m_children, followed by its size
+            std::vector<std::pair<uint32_t, uint32_t>> m_children; ///< Planned child and position of the connecting edge among its head edges
+            std::vector<uint8_t> m_isPlanned; ///< Neuron is in m_order, so its non zero heads are listed
+            std::vector<std::vector<uint32_t>> m_nonZeroHeads; ///< Positions of head edges whose head value is non zero
+            std::vector<uint8_t> m_isUnordered; ///< Positions were listed out of order and need sorting
+        };
+
+        SparsePlan m_sparsePlan; ///< Plan of the sparse forward pass, built on first use in sparse mode
+
+        std::vector<float> m_weightsBefore; ///< Weights saved by AccumulateWeightDeltas before the backward pass
+        std::optional<PredictionCache> m_predictionCache; ///< Cache of Predict results, empty when disabled
+
+        TrainingStatistics m_statistics; ///< Statistics of Fit and Predict, recorded only with FNN_ENABLE_STATISTICS
+        PropagationMode m_propagationMode = PropagationMode::Dense; ///< Mode applied by SetPropagationMode
+        std::shared_ptr<SparseNeuronErrorStrategy> m_sparseError; ///< Error strategy shared by all neurons in sparse mode
+        std::shared_ptr<SparseNeuronValueStrategy> m_sparseValue; ///< Value strategy shared by all neurons in sparse mode
+        std::shared_ptr<SparseNeuronWeightStrategy> m_sparseWeight; ///< Weight strategy shared by all neurons in sparse mode
+
         // Helper functions for setting up and traversing the network
 
+        /**
+         * @brief Returns cone of requested outputs, computing it when missing or outdated
+         * @param outputKeys [in] Keys of requested output neurons
+         * @return Pointer to cached cone, nullptr when a key is not an output of the network
+         */
+        const OutputCone *GetOutputCone(const std::vector<size_t> &outputKeys);
+
+        /**
+         * @brief Counts visits of the backward passes when structure, strategies or learning rate presence changed since
+         * the last count
+         */
+        void UpdateBackwardSteps();
+
+        /**
+         * @brief Builds plan of the sparse forward pass when the structure changed since the last build
+         * @return True if the plan can be used, false when a planned neuron reads a neuron outside of the graph
+         */
+        bool UpdateSparsePlan();
+
+        /**
+         * @brief Evaluates neurons in level order, pushing non zero values along the edges of their children
+         *
+         * A child sums and later updates only the edges listed by its non zero heads, edges of zero heads cost nothing.
+         * Values equal ForwardPropagate of sparse strategies
+         * @param x [in] Single set of input features
+         * @return True if propagation is successful, false otherwise
+         */
+        bool SparseForwardPropagate(const std::vector<float> &x);
+
+        /**
+         * @brief Sets values of input neurons
+         * @param inputX [in] Values in order of m_inputs
+         * @return True if inputs were set, false otherwise
+         */
+        bool SetInputs(const std::vector<float> &inputX);
+
         /**
          * @brief Sets inputs to the network and discovers connections for forward propagation
          * @param inputX [in] Single set of input features
@@ -0,0 +1,526 @@
+#include "PopulationTrainer.hpp"
+
+#include <algorithm>
+
+#include "../Neuron/NeuronStrategy.hpp"
+#include "../Statistics/Tracer.hpp"
+
+using namespace fnn;
+
+namespace
+{
+    /**
+     * @brief Maps neuron objects of a graph to their dense storage index
+     * @param graph [in] Graph to map
+     * @return Index of every neuron object
+     */
+    std::unordered_map<const Neuron*, size_t> neuronIndices(const NGraph &graph)
+    {
+        std::unordered_map<const Neuron*, size_t> indices;
+        const auto neurons = graph.Neurons();
+        for (size_t i = 0; i < neurons.size(); ++i)
+        {
+            indices.emplace(neurons[i].get(), i);
+        }
+        return indices;
+    }
+
+    /**
+     * @brief Checks neuron uses strategies the population can reproduce
+     * @param neuron [in] Neuron to check
+     * @return True if every present value, error and weight strategy is the default one
+     */
+    bool isSupported(const Neuron &neuron)
+    {
+        return (! neuron.m_valueCalculation.has_value() || dynamic_cast<const NeuronValueStrategy*>(neuron.m_valueCalculation->get()) != nullptr) &&
+               (! neuron.m_errorCalculation.has_value() || dynamic_cast<const NeuronErrorStrategy*>(neuron.m_errorCalculation->get()) != nullptr) &&
+               (! neuron.m_weightCalculation.has_value() || dynamic_cast<const NeuronWeightStrategy*>(neuron.m_weightCalculation->get()) != nullptr);
+    }
+
+    /**
+     * @brief Compares target neurons of two edge lists by their dense index
+     * @param first [in] Edges of the first member
+     * @param firstIndices [in] Neuron indices of the first member
+     * @param member [in] Edges of another member
+     * @param memberIndices [in] Neuron indices of that member
+     * @param head [in] Compare heads when true, tails otherwise
+     * @return True if both lists connect the same neurons in the same order
+     */
+    bool isSameEdges(const std::optional<std::vector<Edge>> &first, const std::unordered_map<const Neuron*, size_t> &firstIndices,
+                     const std::optional<std::vector<Edge>> &member, const std::unordered_map<const Neuron*, size_t> &memberIndices, const bool head)
+    {
+        if (first.has_value() != member.has_value())
+        {
+            return false;
+        }
+        if (! first.has_value())
+        {
+            return true;
+        }
+        if (first->size() != member->size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < first->size(); ++i)
+        {
+            const auto firstTarget = firstIndices.find(head ? (*first)[i].m_head.get() : (*first)[i].m_tail.get());
+            const auto memberTarget = memberIndices.find(head ? (*member)[i].m_head.get() : (*member)[i].m_tail.get());
+            if (firstTarget == firstIndices.end() || memberTarget == memberIndices.end() || firstTarget->second != memberTarget->second)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool PopulationTrainer::Load(const std::span<NNetwork> members)
+{
+    FNN_TRACE_SCOPE("PopulationLoad");
+
+    m_members = 0;
+    if (members.empty() || members.front().m_network == nullptr)
+    {
+        return false;
+    }
+
+    const NGraph &first = *members.front().m_network;
+    for (const auto &member : members)
+    {
+        if (member.m_network == nullptr || ! IsSameTopology(first, *member.m_network))
+        {
+            return false;
+        }
+    }
+    if (members.front().HasCycleForward() || members.front().HasCycleBackward())
+    {
+        // Fit refuses cyclic graphs as well
+        return false;
+    }
+
+    const size_t count = members.size();
+    const auto neurons = first.Neurons();
+    const auto indices = neuronIndices(first);
+
+    m_neurons = neurons.size();
+    m_inputs.clear();
+    m_outputs.clear();
+    for (const auto inputKey : first.m_inputs)
+    {
+        m_inputs.push_back(first.GetIndex(inputKey));
+    }
+    for (const auto outputKey : first.m_outputs)
+    {
+        m_outputs.push_back(first.GetIndex(outputKey));
+    }
+
+    // Connections as index arrays, edges of a neuron are contiguous
+    m_activations.assign(m_neurons, nullptr);
+    m_headOffsets.assign(1, 0);
+    m_headParents.clear();
+    m_tailOffsets.assign(1, 0);
+    for (size_t i = 0; i < m_neurons; ++i)
+    {
+        const Neuron &neuron = *neurons[i];
+        if (neuron.m_activationFunction.has_value())
+        {
+            m_activations[i] = neuron.m_activationFunction->get();
+        }
+        if (neuron.m_headConnections.has_value())
+        {
+            for (const auto &headEdge : neuron.m_headConnections.value())
+            {
+                m_headParents.push_back(indices.at(headEdge.m_head.get()));
+            }
+        }
+        m_headOffsets.push_back(m_headParents.size());
+        m_tailOffsets.push_back(m_tailOffsets.back() + (neuron.m_tailConnections.has_value() ? neuron.m_tailConnections->size() : 0));
+    }
+
+    // Same neurons and order ForwardPropagate ends up with, see NNetwork::Predict of selected outputs
+    m_forward.clear();
+    for (size_t level = 1; level < first.LevelCount(); ++level)
+    {
+        for (const auto neuronKey : first.GetLevel(level))
+        {
+            const size_t index = first.GetIndex(neuronKey);
+            const Neuron &neuron = *neurons[index];
+            if (neuron.m_neuronType == NeuronType::Input ||
+                ! neuron.m_valueCalculation.has_value() ||
+                ! neuron.m_headConnections.has_value() ||
+                m_activations[index] == nullptr)
+            {
+                continue;
+            }
+            m_forward.push_back(index);
+        }
+    }
+
+    if (! utility::countBackwardVisits(first, m_visits))
+    {
+        return false;
+    }
+
+    // Interleave member state, lane of a member is its position in members
+    m_members = count;
+    m_headWeights.assign(m_headParents.size() * count, 0.0f);
+    m_tailWeights.assign(m_tailOffsets.back() * count, 0.0f);
+    m_values.assign(m_neurons * count, 0.0f);
+    m_errors.assign(m_neurons * count, 0.0f);
+    m_targets.assign(m_outputs.size() * count, 0.0f);
+    m_learningRates.assign(m_neurons * count, 0.0f);
+    m_sums.assign(count, 0.0f);
+    m_partials.assign(count, 0.0f);
+
+    for (size_t member = 0; member < count; ++member)
+    {
+        const auto memberNeurons = members[member].m_network->Neurons();
+        for (size_t i = 0; i < m_neurons; ++i)
+        {
+            const Neuron &neuron = *memberNeurons[i];
+            m_values[i * count + member] = neuron.m_value;
+            m_errors[i * count + member] = neuron.m_error;
+            m_learningRates[i * count + member] = neuron.m_learningRate.value_or(0.0f);
+
+            for (size_t e = m_headOffsets[i]; e < m_headOffsets[i + 1]; ++e)
+            {
+                m_headWeights[e * count + member] = (*neuron.m_headConnections)[e - m_headOffsets[i]].m_weight;
+            }
+            for (size_t e = m_tailOffsets[i]; e < m_tailOffsets[i + 1]; ++e)
+            {
+                m_tailWeights[e * count + member] = (*neuron.m_tailConnections)[e - m_tailOffsets[i]].m_weight;
+            }
+        }
+        for (size_t o = 0; o < m_outputs.size(); ++o)
+        {
+            m_targets[o * count + member] = memberNeurons[m_outputs[o]]->m_target.value_or(0.0f);
+        }
+    }
+    return true;
+}
+
+bool PopulationTrainer::Store(const std::span<NNetwork> members) const
+{
+    if (members.size() != m_members)
+    {
+        return false;
+    }
+    for (const auto &member : members)
+    {
+        if (member.m_network == nullptr || member.m_network->Size() != m_neurons)
+        {
+            return false;
+        }
+    }
+
+    for (size_t member = 0; member < m_members; ++member)
+    {
+        const auto memberNeurons = members[member].m_network->Neurons();
+        for (size_t i = 0; i < m_neurons; ++i)
+        {
+            Neuron &neuron = *memberNeurons[i];
+            neuron.m_value = m_values[i * m_members + member];
+            neuron.m_error = m_errors[i * m_members + member];
+
+            for (size_t e = m_headOffsets[i]; e < m_headOffsets[i + 1]; ++e)
+            {
+                (*neuron.m_headConnections)[e - m_headOffsets[i]].m_weight = m_headWeights[e * m_members + member];
+            }
+        }
+        for (size_t o = 0; o < m_outputs.size(); ++o)
+        {
+            memberNeurons[m_outputs[o]]->m_target = m_targets[o * m_members + member];
+        }
+        members[member].m_network->InvalidateParameters();
+    }
+    return true;
+}
+
+bool PopulationTrainer::Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs)
+{
+    FNN_TRACE_SCOPE("PopulationFit");
+
+    if (m_members == 0 || m_neurons == 0 || trainX.size() != trainY.size())
+    {
+        // Cannot fit empty population or invalid training data size
+        return false;
+    }
+
+    for (size_t epoch = 0; epoch < epochs; ++epoch)
+    {
+        FNN_TRACE_SCOPE("Epoch");
+
+        for (size_t i = 0; i < trainX.size(); ++i)
+        {
+            if (! ForwardPropagate(trainX[i]) || ! BackwardPropagateError(trainY[i]))
+            {
+                return false;
+            }
+            BackwardPropagateWeights();
+        }
+    }
+    return true;
+}
+
+bool PopulationTrainer::Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<std::vector<float>>> &output)
+{
+    FNN_TRACE_SCOPE("PopulationPredict");
+
+    output.assign(m_members, std::vector<std::vector<float>>());
+    for (auto &memberOutput : output)
+    {
+        memberOutput.reserve(testX.size());
+    }
+
+    for (const auto &inputVector : testX)
+    {
+        if (! ForwardPropagate(inputVector))
+        {
+            return false;
+        }
+
+        for (size_t member = 0; member < m_members; ++member)
+        {
+            std::vector<float> currentOutput;
+            currentOutput.reserve(m_outputs.size());
+            for (const auto outputIndex : m_outputs)
+            {
+                currentOutput.push_back(m_values[outputIndex * m_members + member]);
+            }
+            output[member].push_back(std::move(currentOutput));
+        }
+    }
+    return true;
+}
+
+bool PopulationTrainer::Evaluate(const std::vector<std::vector<float>> &testX, const std::vector<std::vector<float>> &testY, std::vector<float> &meanSquaredErrors)
+{
+    FNN_TRACE_SCOPE("PopulationEvaluate");
+
+    meanSquaredErrors.assign(m_members, 0.0f);
+    if (testX.size() != testY.size())
+    {
+        return false;
+    }
+
+    std::vector<double> squaredErrors(m_members, 0.0);
+    for (size_t row = 0; row < testX.size(); ++row)
+    {
+        if (! ForwardPropagate(testX[row]) || testY[row].size() != m_outputs.size())
+        {
+            return false;
+        }
+
+        for (size_t o = 0; o < m_outputs.size(); ++o)
+        {
+            const float *values = &m_values[m_outputs[o] * m_members];
+            for (size_t member = 0; member < m_members; ++member)
+            {
+                const double difference = static_cast<double>(values[member]) - static_cast<double>(testY[row][o]);
+                squaredErrors[member] += difference * difference;
+            }
+        }
+    }
+
+    const double samples = static_cast<double>(testX.size() * m_outputs.size());
+    for (size_t member = 0; member < m_members && samples > 0.0; ++member)
+    {
+        meanSquaredErrors[member] = static_cast<float>(squaredErrors[member] / samples);
+    }
+    return true;
+}
+
+size_t PopulationTrainer::Members() const
+{
+    return m_members;
+}
+
+bool PopulationTrainer::IsSameTopology(const NGraph &first, const NGraph &member)
+{
+    if (first.Size() != member.Size() || first.m_inputs != member.m_inputs || first.m_outputs != member.m_outputs ||
+        ! std::ranges::equal(first.Keys(), member.Keys()))
+    {
+        return false;
+    }
+
+    const auto firstIndices = neuronIndices(first);
+    const auto memberIndices = neuronIndices(member);
+    const auto firstNeurons = first.Neurons();
+    const auto memberNeurons = member.Neurons();
+    for (size_t i = 0; i < firstNeurons.size(); ++i)
+    {
+        const Neuron &a = *firstNeurons[i];
+        const Neuron &b = *memberNeurons[i];
+        if (a.m_neuronType != b.m_neuronType ||
+            ! isSupported(a) || ! isSupported(b) ||
+            a.m_valueCalculation.has_value() != b.m_valueCalculation.has_value() ||
+            a.m_errorCalculation.has_value() != b.m_errorCalculation.has_value() ||
+            a.m_weightCalculation.has_value() != b.m_weightCalculation.has_value() ||
+            a.m_learningRate.has_value() != b.m_learningRate.has_value() ||
+            a.m_activationFunction.value_or(nullptr) != b.m_activationFunction.value_or(nullptr) ||
+            ! isSameEdges(a.m_headConnections, firstIndices, b.m_headConnections, memberIndices, true) ||
+            ! isSameEdges(a.m_tailConnections, firstIndices, b.m_tailConnections, memberIndices, false))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PopulationTrainer::ForwardPropagate(const std::vector<float> &x)
+{
+    if (x.size() != m_inputs.size())
+    {
+        // Input layer has different size than inserted inputs
+        return false;
+    }
+
+    const size_t lanes = m_members;
+    for (size_t i = 0; i < m_inputs.size(); ++i)
+    {
+        std::fill_n(&m_values[m_inputs[i] * lanes], lanes, x[i]);
+    }
+
+    float *sums = m_sums.data();
+    for (const auto neuron : m_forward)
+    {
+        float *values = &m_values[neuron * lanes];
+        const size_t begin = m_headOffsets[neuron];
+        const size_t end = m_headOffsets[neuron + 1];
+        if (begin == end)
+        {
+            // NeuronValueStrategy skips activation without head edges
+            std::fill_n(values, lanes, 0.0f);
+            continue;
+        }
+
+        std::fill_n(sums, lanes, 0.0f);
+        size_t e = begin;
+        for (; end - e >= 4; e += 4)
+        {
+            const float *v0 = &m_values[m_headParents[e] * lanes];
+            const float *v1 = &m_values[m_headParents[e + 1] * lanes];
+            const float *v2 = &m_values[m_headParents[e + 2] * lanes];
+            const float *v3 = &m_values[m_headParents[e + 3] * lanes];
+            const float *w0 = &m_headWeights[e * lanes];
+            const float *w1 = w0 + lanes;
+            const float *w2 = w1 + lanes;
+            const float *w3 = w2 + lanes;
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                sums[lane] = sums[lane] + ((v0[lane] * w0[lane] + v1[lane] * w1[lane]) + (v2[lane] * w2[lane] + v3[lane] * w3[lane]));
+            }
+        }
+        for (; e < end; ++e)
+        {
+            const float *v = &m_values[m_headParents[e] * lanes];
+            const float *w = &m_headWeights[e * lanes];
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                sums[lane] = sums[lane] + v[lane] * w[lane];
+            }
+        }
+
+        m_activations[neuron]->ActivationBatch(std::span<const float>(sums, lanes), std::span<float>(values, lanes));
+    }
+    return true;
+}
+
+bool PopulationTrainer::BackwardPropagateError(const std::vector<float> &y)
+{
+    if (y.size() != m_outputs.size())
+    {
+        // Output layer has different size than inserted target
+        return false;
+    }
+
+    const size_t lanes = m_members;
+    for (size_t o = 0; o < m_outputs.size(); ++o)
+    {
+        std::fill_n(&m_targets[o * lanes], lanes, y[o]);
+        if (! m_visits.m_hasOutputError[o])
+        {
+            continue;
+        }
+
+        // NeuronErrorStrategy::CalculateError(target, actual) with the arguments SetErrorsAndDiscoverConnections passes
+        float *errors = &m_errors[m_outputs[o] * lanes];
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            errors[lane] = y[o] - errors[lane];
+        }
+    }
+
+    float *weightSums = m_sums.data();
+    float *partials = m_partials.data();
+    for (size_t neuron = 0; neuron < m_neurons; ++neuron)
+    {
+        if (m_visits.m_errorVisits[neuron] == 0)
+        {
+            continue;
+        }
+
+        std::fill_n(weightSums, lanes, 0.0f);
+        for (size_t e = m_headOffsets[neuron]; e < m_headOffsets[neuron + 1]; ++e)
+        {
+            const float *w = &m_headWeights[e * lanes];
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                weightSums[lane] = weightSums[lane] + w[lane];
+            }
+        }
+
+        float *errors = &m_errors[neuron * lanes];
+        for (uint32_t visit = 0; visit < m_visits.m_errorVisits[neuron]; ++visit)
+        {
+            std::fill_n(partials, lanes, 0.0f);
+            for (size_t e = m_tailOffsets[neuron]; e < m_tailOffsets[neuron + 1]; ++e)
+            {
+                const float *w = &m_tailWeights[e * lanes];
+                for (size_t lane = 0; lane < lanes; ++lane)
+                {
+                    partials[lane] = partials[lane] + (weightSums[lane] == 0.0f ? 0.0f : w[lane] / weightSums[lane] * errors[lane]);
+                }
+            }
+            std::copy_n(partials, lanes, errors);
+        }
+    }
+    return true;
+}
+
+void PopulationTrainer::BackwardPropagateWeights()
+{
+    for (size_t o = 0; o < m_outputs.size(); ++o)
+    {
+        if (m_visits.m_hasOutputWeights[o])
+        {
+            UpdateHeadWeights(m_outputs[o]);
+        }
+    }
+
+    // Errors and values stay fixed during the pass, so order of updates does not matter
+    for (size_t neuron = 0; neuron < m_neurons; ++neuron)
+    {
+        for (uint32_t visit = 0; visit < m_visits.m_weightVisits[neuron]; ++visit)
+        {
+            UpdateHeadWeights(neuron);
+        }
+    }
+}
+
+void PopulationTrainer::UpdateHeadWeights(const size_t neuron)
+{
+    const size_t lanes = m_members;
+    const float *learningRates = &m_learningRates[neuron * lanes];
+    const float *errors = &m_errors[neuron * lanes];
+    for (size_t e = m_headOffsets[neuron]; e < m_headOffsets[neuron + 1]; ++e)
+    {
+        const float *values = &m_values[m_headParents[e] * lanes];
+        float *weights = &m_headWeights[e * lanes];
+        for (size_t lane = 0; lane < lanes; ++lane)
+        {
+            weights[lane] -= learningRates[lane] * errors[lane] * values[lane];
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "BackwardVisits.hpp"
+#include "NNetwork.hpp"
+
+namespace fnn
+{
+    /**
+     * @class PopulationTrainer
+     * @brief Trains many networks of identical topology in lockstep
+     *
+     * Topology, dataset and per neuron bookkeeping are stored once, weights, values, errors and learning rates of all
+     * members are interleaved so every edge holds one contiguous lane per member and a single traversal updates them
+     * all. Members may differ in weights and learning rates, activation functions must be the same strategy instances
+     * as interned ones are. Training reproduces Fit of each member, which requires the default value, error and weight
+     * strategies
+     */
+    class PopulationTrainer final
+    {
+    public:
+        /**
+         * @brief Copies topology and state of members into interleaved storage
+         * @param members [in] Networks with identical keys, connections and strategies
+         * @return True if members were loaded, false when topologies differ, a strategy is not supported or graph is cyclic
+         */
+        bool Load(const std::span<NNetwork> members);
+
+        /**
+         * @brief Writes weights, values, errors and targets back into members
+         * @param members [in, out] Networks passed to Load, in the same order
+         * @return True if state was written, false when members do not match the loaded population
+         */
+        bool Store(const std::span<NNetwork> members) const;
+
+        /**
+         * @brief Trains all members on the same data as Fit would train each of them
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations, default is 10
+         * @return True if training is successful, false otherwise
+         */
+        bool Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs = 10);
+
+        /**
+         * @brief Predicts outputs of every member
+         * @param testX [in] Input features for prediction
+         * @param output [out] Predicted outputs indexed by member, input vector and output
+         * @return True if prediction is successful, false otherwise
+         */
+        bool Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<std::vector<float>>> &output);
+
+        /**
+         * @brief Computes mean squared error of every member
+         * @param testX [in] Input features
+         * @param testY [in] Expected outputs
+         * @param meanSquaredErrors [out] Mean over input vectors and outputs of squared differences, one per member
+         * @return True if evaluation is successful, false otherwise
+         */
+        bool Evaluate(const std::vector<std::vector<float>> &testX, const std::vector<std::vector<float>> &testY, std::vector<float> &meanSquaredErrors);
+
+        /**
+         * @brief Returns number of loaded members
+         * @return Population size
+         */
+        size_t Members() const;
+
+    private:
+        size_t m_members = 0; ///< Number of lanes of every interleaved array
+
+        // Topology shared by all members, neurons are indexed by dense storage index of the graph
+        size_t m_neurons = 0; ///< Number of neurons
+        std::vector<size_t> m_inputs; ///< Neuron index of each input in input vector order
+        std::vector<size_t> m_outputs; ///< Neuron index of each output in output vector order
+        std::vector<size_t> m_forward; ///< Neurons evaluated by ForwardPropagate in level order
+        std::vector<INeuronFunctionStrategy*> m_activations; ///< Activation of each neuron, shared by all members
+        std::vector<size_t> m_headOffsets; ///< Start of each neuron's head edges, followed by edge count
+        std::vector<size_t> m_headParents; ///< Neuron index of the head of each head edge
+        std::vector<size_t> m_tailOffsets; ///< Start of each neuron's tail edges, followed by edge count
+        BackwardVisits m_visits; ///< How often the error and weight passes process each neuron, replayed per sample
+
+        // Member state, element [i * m_members + member]
+        std::vector<float> m_headWeights; ///< Weights of head edges
+        std::vector<float> m_tailWeights; ///< Weights of tail edges, read by error calculation
+        std::vector<float> m_values; ///< Neuron values
+        std::vector<float> m_errors; ///< Neuron errors
+        std::vector<float> m_targets; ///< Last targets of outputs, indexed by output position
+        std::vector<float> m_learningRates; ///< Neuron learning rates, zero when a neuron has none
+
+        std::vector<float> m_sums; ///< Scratch lanes of pre-activation and weight sums
+        std::vector<float> m_partials; ///< Scratch lanes of error sums
+
+        /**
+         * @brief Checks a member against the topology of the first member
+         * @param first [in] Graph of the first member
+         * @param member [in] Graph to check
+         * @return True if keys, types, connections and strategies match
+         */
+        static bool IsSameTopology(const NGraph &first, const NGraph &member);
+
+        /**
+         * @brief Sets inputs and evaluates all members
+         * @param x [in] Single set of input features
+         * @return True if propagation is successful, false otherwise
+         */
+        bool ForwardPropagate(const std::vector<float> &x);
+
+        /**
+         * @brief Computes errors of all members
+         * @param y [in] Single set of target outputs
+         * @return True if error propagation is successful, false otherwise
+         */
+        bool BackwardPropagateError(const std::vector<float> &y);
+
+        /**
+         * @brief Updates weights of all members from their errors
+         */
+        void BackwardPropagateWeights();
+
+        /**
+         * @brief Applies one weight update of a neuron to all members
+         * @param neuron [in] Neuron index
+         */
+        void UpdateHeadWeights(const size_t neuron);
+    };
+}
@@ -0,0 +1,124 @@
+#include "PredictionCache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+using namespace fnn;
+
+PredictionCache::PredictionCache(const size_t capacity) : m_capacity(std::max<size_t>(capacity, 1))
+{
+}
+
+void PredictionCache::Validate(const uint64_t structureVersion, const uint64_t parameterVersion)
+{
+    if (m_structureVersion == structureVersion && m_parameterVersion == parameterVersion)
+    {
+        return;
+    }
+
+    if (! m_entries.empty())
+    {
+        ++m_counters.m_invalidations;
+    }
+    Clear();
+    m_structureVersion = structureVersion;
+    m_parameterVersion = parameterVersion;
+}
+
+const std::vector<float> *PredictionCache::Find(const std::vector<float> &input)
+{
+    const auto entry = Lookup(input, Hash(input));
+    if (entry == m_entries.end())
+    {
+        ++m_counters.m_misses;
+        return nullptr;
+    }
+
+    ++m_counters.m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, entry);
+    return &entry->m_output;
+}
+
+void PredictionCache::Insert(const std::vector<float> &input, const std::vector<float> &output)
+{
+    const uint64_t hash = Hash(input);
+    if (Lookup(input, hash) != m_entries.end())
+    {
+        return;
+    }
+
+    if (m_entries.size() >= m_capacity)
+    {
+        // Least recently used entry is at the back
+        const auto last = std::prev(m_entries.end());
+        auto [first, end] = m_index.equal_range(last->m_hash);
+        for (; first != end; ++first)
+        {
+            if (first->second == last)
+            {
+                m_index.erase(first);
+                break;
+            }
+        }
+        m_entries.pop_back();
+        ++m_counters.m_evictions;
+    }
+
+    m_entries.push_front(Entry{ hash, input, output });
+    m_index.emplace(hash, m_entries.begin());
+}
+
+void PredictionCache::Clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+size_t PredictionCache::Size() const
+{
+    return m_entries.size();
+}
+
+size_t PredictionCache::Capacity() const
+{
+    return m_capacity;
+}
+
+const PredictionCacheCounters &PredictionCache::Counters() const
+{
+    return m_counters;
+}
+
+void PredictionCache::ResetCounters()
+{
+    m_counters = PredictionCacheCounters();
+}
+
+uint64_t PredictionCache::Hash(const std::vector<float> &input)
+{
+    // Multiply and rotate per value, splitmix64 finalizer to spread the result over all bits
+    uint64_t hash = input.size();
+    for (const float value : input)
+    {
+        hash = std::rotl((hash ^ std::bit_cast<uint32_t>(value)) * 0x9E3779B97F4A7C15ull, 29);
+    }
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+    return hash ^ (hash >> 31);
+}
+
+std::list<PredictionCache::Entry>::iterator PredictionCache::Lookup(const std::vector<float> &input, const uint64_t hash)
+{
+    auto [first, end] = m_index.equal_range(hash);
+    for (; first != end; ++first)
+    {
+        // Bytes are compared so rows hit exactly when they hash equally, also for -0.0f and NaN
+        const auto &cached = first->second->m_input;
+        if (cached.size() == input.size() && (input.empty() || std::memcmp(cached.data(), input.data(), input.size() * sizeof(float)) == 0))
+        {
+            return first->second;
+        }
+    }
+    return m_entries.end();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace fnn
+{
+    /**
+     * @struct PredictionCacheCounters
+     * @brief Activity of a prediction cache since it was created or last reset
+     */
+    struct PredictionCacheCounters final
+    {
+    public:
+        uint64_t m_hits = 0; ///< Lookups answered from the cache
+        uint64_t m_misses = 0; ///< Lookups that had to be predicted
+        uint64_t m_evictions = 0; ///< Entries dropped to make room for new ones
+        uint64_t m_invalidations = 0; ///< Times the whole cache was dropped because the network changed
+    };
+
+    /**
+     * @class PredictionCache
+     * @brief Bounded least recently used map from input rows to predicted outputs
+     *
+     * Rows are looked up by hash and confirmed by comparing their bytes, so only bit identical rows hit. Entries are
+     * tagged with graph structure and parameter versions, any change of either drops them all
+     */
+    class PredictionCache final
+    {
+    public:
+        /**
+         * @brief Creates empty cache
+         * @param capacity [in] Maximum number of cached rows, at least 1
+         */
+        explicit PredictionCache(const size_t capacity);
+
+        /**
+         * @brief Drops all entries when versions differ from the ones entries were stored for
+         * @param structureVersion [in] Current NGraph::StructureVersion
+         * @param parameterVersion [in] Current NGraph::ParameterVersion
+         */
+        void Validate(const uint64_t structureVersion, const uint64_t parameterVersion);
+
+        /**
+         * @brief Looks up output of a row, marking it as most recently used
+         * @param input [in] Input row
+         * @return Pointer to cached output valid until the next Insert, Validate or Clear, nullptr on miss
+         */
+        const std::vector<float> *Find(const std::vector<float> &input);
+
+        /**
+         * @brief Stores output of a row missing from the cache, evicting the least recently used entry when full
+         * @param input [in] Input row
+         * @param output [in] Predicted output of the row
+         */
+        void Insert(const std::vector<float> &input, const std::vector<float> &output);
+
+        /**
+         * @brief Drops all entries without counting an invalidation
+         */
+        void Clear();
+
+        /**
+         * @brief Returns number of cached rows
+         * @return Cached rows
+         */
+        size_t Size() const;
+
+        /**
+         * @brief Returns maximum number of cached rows
+         * @return Capacity
+         */
+        size_t Capacity() const;
+
+        /**
+         * @brief Returns activity counters
+         * @return Counters since creation or last reset
+         */
+        const PredictionCacheCounters &Counters() const;
+
+        /**
+         * @brief Sets all counters to zero
+         */
+        void ResetCounters();
+
+    private:
+        /**
+         * @struct Entry
+         * @brief Cached row with its output
+         */
+        struct Entry final
+        {
+        public:
+            uint64_t m_hash; ///< Hash of m_input
+            std::vector<float> m_input; ///< Input row
+            std::vector<float> m_output; ///< Predicted output
+        };
+
+        size_t m_capacity; ///< Maximum number of entries
+        uint64_t m_structureVersion = UINT64_MAX; ///< Structure version of stored entries
+        uint64_t m_parameterVersion = UINT64_MAX; ///< Parameter version of stored entries
+        std::list<Entry> m_entries; ///< Entries from most to least recently used
+        std::unordered_multimap<uint64_t, std::list<Entry>::iterator> m_index; ///< Entries by hash of their input
+        PredictionCacheCounters m_counters; ///< Activity counters
+
+        /**
+         * @brief Hashes bytes of a row
+         * @param input [in] Input row
+         * @return 64 bit hash
+         */
+        static uint64_t Hash(const std::vector<float> &input);
+
+        /**
+         * @brief Returns entry holding a row
+         * @param input [in] Input row
+         * @param hash [in] Hash of input
+         * @return Iterator to the entry, m_entries.end() when missing
+         */
+        std::list<Entry>::iterator Lookup(const std::vector<float> &input, const uint64_t hash);
+    };
+}
@@ -0,0 +1,468 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "NGraph.hpp"
+#include "../Neuron/NeuronStrategy.hpp"
+
+namespace fnn
+{
+    /**
+     * @class StaticNetwork
+     * @brief Fully connected layered network with layer sizes fixed at compile time
+     *
+     * Weights, values and errors live in std::array members and every loop bound is a constant, so small networks are
+     * unrolled completely without any indirection. Arithmetic follows NNetwork built from the same layer sizes with
+     * MapFunction<Activation>(), including summation order of value, error and weight strategies, so Predict and Fit
+     * return the same values as NNetwork holding the same state. Import and Export copy that state from and to an
+     * NGraph of matching shape
+     * @tparam Activation Activation strategy of all hidden and output neurons, called directly instead of virtually
+     * @tparam Layers Number of neurons in each layer, input layer first
+     */
+    template <typename Activation, size_t... Layers>
+    class StaticNetwork final
+    {
+        static_assert(std::is_base_of_v<INeuronFunctionStrategy, Activation>, "Activation must be an activation strategy");
+        static_assert(sizeof...(Layers) >= 2, "Network needs at least an input and an output layer");
+        static_assert(((Layers > 0) && ...), "Layers cannot be empty");
+
+    public:
+        static constexpr size_t LAYERS = sizeof...(Layers); ///< Number of layers including input and output
+        static constexpr std::array<size_t, LAYERS> SHAPE = { Layers... }; ///< Neurons of each layer
+        static constexpr size_t INPUTS = SHAPE.front(); ///< Length of input vectors
+        static constexpr size_t OUTPUTS = SHAPE.back(); ///< Length of output vectors
+        static constexpr size_t NEURONS = (Layers + ...); ///< Number of neurons
+
+        /// First neuron of each layer, equal to its key in NGraph built from the same layer sizes
+        static constexpr std::array<size_t, LAYERS> NEURON_OFFSETS = []
+        {
+            std::array<size_t, LAYERS> offsets{};
+            for (size_t layer = 1; layer < LAYERS; ++layer)
+            {
+                offsets[layer] = offsets[layer - 1] + SHAPE[layer - 1];
+            }
+            return offsets;
+        }();
+
+        /// First head weight of each layer, weight from neuron i of layer l - 1 to neuron j of layer l is at [l] + j * SHAPE[l - 1] + i
+        static constexpr std::array<size_t, LAYERS + 1> WEIGHT_OFFSETS = []
+        {
+            std::array<size_t, LAYERS + 1> offsets{};
+            offsets[1] = 0;
+            for (size_t layer = 1; layer < LAYERS; ++layer)
+            {
+                offsets[layer + 1] = offsets[layer] + SHAPE[layer - 1] * SHAPE[layer];
+            }
+            return offsets;
+        }();
+
+        static constexpr size_t WEIGHTS = WEIGHT_OFFSETS[LAYERS]; ///< Number of connections between neighbouring layers
+
+        /**
+         * @brief Constructs network with random weights drawn in the order NGraph draws them for the same layer sizes
+         * @param randomStrategy [in] Random strategy for initializing weights
+         * @param activation [in] Activation of hidden and output neurons
+         */
+        explicit StaticNetwork(const std::shared_ptr<IRandomStrategy> randomStrategy = std::make_shared<FastRandomStrategy>(), const Activation &activation = Activation())
+            : m_activation(activation)
+        {
+            for (size_t layer = 1; layer < LAYERS; ++layer)
+            {
+                for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                {
+                    for (size_t j = 0; j < SHAPE[layer]; ++j)
+                    {
+                        const size_t edge = WEIGHT_OFFSETS[layer] + j * SHAPE[layer - 1] + i;
+                        m_headWeights[edge] = randomStrategy->GetWeight(0.0f, 1.0f);
+                        m_tailWeights[edge] = randomStrategy->GetWeight(0.0f, 1.0f);
+                    }
+                }
+            }
+            MapLearningRate(0.2f);
+        }
+
+        /**
+         * @brief Trains network sample by sample as NNetwork::Fit does
+         * @param trainX [in] Input features for training
+         * @param trainY [in] Target outputs for training
+         * @param epochs [in] Number of training iterations, default is 10
+         * @return True if training is successful, false when sizes do not match the network
+         */
+        bool Fit(const std::vector<std::vector<float>> &trainX, const std::vector<std::vector<float>> &trainY, const size_t epochs = 10)
+        {
+            if (trainX.size() != trainY.size())
+            {
+                return false;
+            }
+
+            for (size_t epoch = 0; epoch < epochs; ++epoch)
+            {
+                for (size_t i = 0; i < trainX.size(); ++i)
+                {
+                    if (trainX[i].size() != INPUTS || trainY[i].size() != OUTPUTS)
+                    {
+                        return false;
+                    }
+                    Train(std::span<const float, INPUTS>(trainX[i].data(), INPUTS), std::span<const float, OUTPUTS>(trainY[i].data(), OUTPUTS));
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Trains network on a single sample
+         * @param x [in] Input features
+         * @param y [in] Target outputs
+         */
+        void Train(const std::span<const float, INPUTS> x, const std::span<const float, OUTPUTS> y)
+        {
+            ForwardPropagate(x);
+            BackwardPropagateError(y);
+            BackwardPropagateWeights();
+        }
+
+        /**
+         * @brief Predicts outputs for given input data
+         * @param testX [in] Input features for prediction
+         * @param output [out] Predicted outputs
+         * @return True if prediction is successful, false when an input vector has wrong size
+         */
+        bool Predict(const std::vector<std::vector<float>> &testX, std::vector<std::vector<float>> &output)
+        {
+            output.clear();
+            output.reserve(testX.size());
+            for (const auto &inputVector : testX)
+            {
+                if (inputVector.size() != INPUTS)
+                {
+                    return false;
+                }
+
+                std::vector<float> currentOutput(OUTPUTS);
+                Predict(std::span<const float, INPUTS>(inputVector.data(), INPUTS), std::span<float, OUTPUTS>(currentOutput.data(), OUTPUTS));
+                output.push_back(std::move(currentOutput));
+            }
+            return true;
+        }
+
+        /**
+         * @brief Predicts outputs of a single input vector
+         * @param x [in] Input features
+         * @param y [out] Predicted outputs
+         */
+        void Predict(const std::span<const float, INPUTS> x, const std::span<float, OUTPUTS> y)
+        {
+            ForwardPropagate(x);
+            std::copy_n(m_values.begin() + NEURON_OFFSETS[LAYERS - 1], OUTPUTS, y.begin());
+        }
+
+        /**
+         * @brief Sets learning rate of all hidden and output neurons
+         * @param learningRate [in] New learning rate
+         */
+        void MapLearningRate(const float learningRate)
+        {
+            std::fill(m_learningRates.begin() + SHAPE[0], m_learningRates.end(), learningRate);
+        }
+
+        /**
+         * @brief Returns head weights
+         * @return Weights laid out as described by WEIGHT_OFFSETS
+         */
+        const std::array<float, WEIGHTS> &Weights() const
+        {
+            return m_headWeights;
+        }
+
+        /**
+         * @brief Copies weights, values, errors and learning rates from a graph of matching shape
+         * @param graph [in] Graph built from the same layer sizes with default strategies and Activation
+         * @return True if state was copied, false when graph does not match
+         */
+        bool Import(const NGraph &graph)
+        {
+            if (! IsMatching(graph))
+            {
+                return false;
+            }
+
+            for (size_t layer = 0; layer < LAYERS; ++layer)
+            {
+                for (size_t j = 0; j < SHAPE[layer]; ++j)
+                {
+                    const size_t index = NEURON_OFFSETS[layer] + j;
+                    const Neuron &neuron = *graph.GetNeuron(index);
+                    m_values[index] = neuron.m_value;
+                    m_errors[index] = neuron.m_error;
+                    m_learningRates[index] = neuron.m_learningRate.value_or(0.0f);
+                    if (layer > 0)
+                    {
+                        for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                        {
+                            m_headWeights[WEIGHT_OFFSETS[layer] + j * SHAPE[layer - 1] + i] = neuron.m_headConnections.value()[i].m_weight;
+                        }
+                    }
+                    if (layer + 1 < LAYERS)
+                    {
+                        for (size_t k = 0; k < SHAPE[layer + 1]; ++k)
+                        {
+                            m_tailWeights[WEIGHT_OFFSETS[layer + 1] + k * SHAPE[layer] + j] = neuron.m_tailConnections.value()[k].m_weight;
+                        }
+                    }
+                    if (layer + 1 == LAYERS)
+                    {
+                        m_targets[j] = neuron.m_target.value_or(0.0f);
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Copies weights, values, errors and learning rates into a graph of matching shape
+         * @param graph [in, out] Graph built from the same layer sizes with default strategies and Activation
+         * @return True if state was copied, false when graph does not match
+         */
+        bool Export(NGraph &graph) const
+        {
+            if (! IsMatching(graph))
+            {
+                return false;
+            }
+
+            for (size_t layer = 0; layer < LAYERS; ++layer)
+            {
+                for (size_t j = 0; j < SHAPE[layer]; ++j)
+                {
+                    const size_t index = NEURON_OFFSETS[layer] + j;
+                    Neuron &neuron = *graph.GetNeuron(index);
+                    neuron.m_value = m_values[index];
+                    neuron.m_error = m_errors[index];
+                    if (layer > 0)
+                    {
+                        neuron.m_learningRate = m_learningRates[index];
+                        for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                        {
+                            neuron.m_headConnections.value()[i].m_weight = m_headWeights[WEIGHT_OFFSETS[layer] + j * SHAPE[layer - 1] + i];
+                        }
+                    }
+                    if (layer + 1 < LAYERS)
+                    {
+                        for (size_t k = 0; k < SHAPE[layer + 1]; ++k)
+                        {
+                            neuron.m_tailConnections.value()[k].m_weight = m_tailWeights[WEIGHT_OFFSETS[layer + 1] + k * SHAPE[layer] + j];
+                        }
+                    }
+                    if (layer + 1 == LAYERS)
+                    {
+                        neuron.m_target = m_targets[j];
+                    }
+                }
+            }
+            graph.InvalidateParameters();
+            return true;
+        }
+
+    private:
+        Activation m_activation; ///< Activation of hidden and output neurons
+        std::array<float, WEIGHTS> m_headWeights{}; ///< Weights of head edges, read by value and weight calculation
+        std::array<float, WEIGHTS> m_tailWeights{}; ///< Weights of tail edges, read by error calculation, same layout as head weights
+        std::array<float, NEURONS> m_values{}; ///< Neuron values
+        std::array<float, NEURONS> m_errors{}; ///< Neuron errors
+        std::array<float, NEURONS> m_learningRates{}; ///< Neuron learning rates, zero for inputs
+        std::array<float, OUTPUTS> m_targets{}; ///< Last targets of outputs
+
+        /**
+         * @brief Checks keys, types, connections and strategies against the layout of this network
+         * @param graph [in] Graph to check
+         * @return True if graph was built from the same layer sizes with default strategies and Activation
+         */
+        static bool IsMatching(const NGraph &graph)
+        {
+            if (graph.Size() != NEURONS || graph.m_inputs.size() != INPUTS || graph.m_outputs.size() != OUTPUTS)
+            {
+                return false;
+            }
+            for (size_t i = 0; i < INPUTS; ++i)
+            {
+                if (graph.m_inputs[i] != i)
+                {
+                    return false;
+                }
+            }
+            for (size_t o = 0; o < OUTPUTS; ++o)
+            {
+                if (graph.m_outputs[o] != NEURON_OFFSETS[LAYERS - 1] + o)
+                {
+                    return false;
+                }
+            }
+
+            for (size_t layer = 0; layer < LAYERS; ++layer)
+            {
+                const NeuronType type = layer == 0 ? NeuronType::Input : layer + 1 == LAYERS ? NeuronType::Output : NeuronType::Hidden;
+                for (size_t j = 0; j < SHAPE[layer]; ++j)
+                {
+                    const auto &neuron = graph.GetNeuron(NEURON_OFFSETS[layer] + j);
+                    if (neuron == nullptr || neuron->m_neuronType != type)
+                    {
+                        return false;
+                    }
+
+                    if (layer > 0)
+                    {
+                        if (! neuron->m_learningRate.has_value() ||
+                            dynamic_cast<const Activation*>(neuron->m_activationFunction.value_or(nullptr).get()) == nullptr ||
+                            dynamic_cast<const NeuronValueStrategy*>(neuron->m_valueCalculation.value_or(nullptr).get()) == nullptr ||
+                            dynamic_cast<const NeuronErrorStrategy*>(neuron->m_errorCalculation.value_or(nullptr).get()) == nullptr ||
+                            dynamic_cast<const NeuronWeightStrategy*>(neuron->m_weightCalculation.value_or(nullptr).get()) == nullptr ||
+                            ! neuron->m_headConnections.has_value() || neuron->m_headConnections->size() != SHAPE[layer - 1])
+                        {
+                            return false;
+                        }
+                        for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                        {
+                            if (neuron->m_headConnections.value()[i].m_head != graph.GetNeuron(NEURON_OFFSETS[layer - 1] + i))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                    else if (neuron->m_headConnections.has_value() && ! neuron->m_headConnections->empty())
+                    {
+                        return false;
+                    }
+
+                    if (layer + 1 < LAYERS)
+                    {
+                        if (! neuron->m_tailConnections.has_value() || neuron->m_tailConnections->size() != SHAPE[layer + 1])
+                        {
+                            return false;
+                        }
+                        for (size_t k = 0; k < SHAPE[layer + 1]; ++k)
+                        {
+                            if (neuron->m_tailConnections.value()[k].m_tail != graph.GetNeuron(NEURON_OFFSETS[layer + 1] + k))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                    else if (neuron->m_tailConnections.has_value() && ! neuron->m_tailConnections->empty())
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Sets inputs and evaluates all layers
+         * @param x [in] Input features
+         */
+        void ForwardPropagate(const std::span<const float, INPUTS> x)
+        {
+            std::copy_n(x.begin(), INPUTS, m_values.begin());
+            [this]<size_t... Layer>(std::index_sequence<Layer...>)
+            {
+                (ForwardLayer<Layer + 1>(), ...);
+            }(std::make_index_sequence<LAYERS - 1>());
+        }
+
+        /**
+         * @brief Evaluates one layer from the values of the previous one
+         * @tparam Layer Index of evaluated layer
+         */
+        template <size_t Layer>
+        void ForwardLayer()
+        {
+            constexpr size_t previous = SHAPE[Layer - 1];
+            const float *inputs = m_values.data() + NEURON_OFFSETS[Layer - 1];
+
+            std::array<float, SHAPE[Layer]> sums;
+            for (size_t j = 0; j < SHAPE[Layer]; ++j)
+            {
+                const float *weights = m_headWeights.data() + WEIGHT_OFFSETS[Layer] + j * previous;
+
+                float sum = 0.0f;
+                size_t i = 0;
+                for (; previous - i >= 4; i += 4)
+                {
+                    sum = sum + ((inputs[i] * weights[i] + inputs[i + 1] * weights[i + 1]) + (inputs[i + 2] * weights[i + 2] + inputs[i + 3] * weights[i + 3]));
+                }
+                for (; i < previous; ++i)
+                {
+                    sum = sum + inputs[i] * weights[i];
+                }
+                sums[j] = sum;
+            }
+
+            m_activation.ActivationBatch(sums, std::span<float>(m_values.data() + NEURON_OFFSETS[Layer], SHAPE[Layer]));
+        }
+
+        /**
+         * @brief Computes errors with the rules of NeuronErrorStrategy
+         * @param y [in] Target outputs
+         */
+        void BackwardPropagateError(const std::span<const float, OUTPUTS> y)
+        {
+            // Output error is computed from its previous error, as SetErrorsAndDiscoverConnections passes it
+            for (size_t o = 0; o < OUTPUTS; ++o)
+            {
+                m_targets[o] = y[o];
+                float &error = m_errors[NEURON_OFFSETS[LAYERS - 1] + o];
+                error = y[o] - error;
+            }
+
+            // Hidden errors depend only on their own previous value, so layer order does not matter
+            for (size_t layer = 1; layer + 1 < LAYERS; ++layer)
+            {
+                for (size_t j = 0; j < SHAPE[layer]; ++j)
+                {
+                    const float *headWeights = m_headWeights.data() + WEIGHT_OFFSETS[layer] + j * SHAPE[layer - 1];
+                    float weightSum = 0.0f;
+                    for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                    {
+                        weightSum = weightSum + headWeights[i];
+                    }
+
+                    float &error = m_errors[NEURON_OFFSETS[layer] + j];
+                    float total = 0.0f;
+                    for (size_t k = 0; k < SHAPE[layer + 1]; ++k)
+                    {
+                        const float tailWeight = m_tailWeights[WEIGHT_OFFSETS[layer + 1] + k * SHAPE[layer] + j];
+                        total = total + (weightSum == 0.0f ? 0.0f : tailWeight / weightSum * error);
+                    }
+                    error = total;
+                }
+            }
+        }
+
+        /**
+         * @brief Updates head weights with the rule of NeuronWeightStrategy, once per hidden and output neuron
+         */
+        void BackwardPropagateWeights()
+        {
+            for (size_t layer = 1; layer < LAYERS; ++layer)
+            {
+                for (size_t j = 0; j < SHAPE[layer]; ++j)
+                {
+                    const size_t index = NEURON_OFFSETS[layer] + j;
+                    const float *values = m_values.data() + NEURON_OFFSETS[layer - 1];
+                    float *weights = m_headWeights.data() + WEIGHT_OFFSETS[layer] + j * SHAPE[layer - 1];
+                    for (size_t i = 0; i < SHAPE[layer - 1]; ++i)
+                    {
+                        weights[i] -= m_learningRates[index] * m_errors[index] * values[i];
+                    }
+                }
+            }
+        }
+    };
+}
@@ -2,6 +2,7 @@
 
 #include "ActivationStrategy.hpp"
 #include "NeuronStrategy.hpp"
+#include "StrategyRegistry.hpp"
 #include "../Edge/Edge.hpp"
 
 using namespace fnn;
@@ -15,33 +16,35 @@ NeuronBuilder NeuronBuilder::CreateAsType(const NeuronType type)
 {
     using enum fnn::NeuronType;
 
+    // Default strategies are stateless, every neuron shares the interned instances
+
     switch (type)
     {
     case Input:
         return NeuronBuilder()
             .AsType(Input)
             .HasTailConnection()
-            .WithErrorCalculation(std::make_shared<NeuronErrorStrategy>());
+            .WithErrorCalculation(StrategyRegistry::Get<NeuronErrorStrategy>());
     case Output:
         return NeuronBuilder()
             .AsType(Output)
             .HasTarget()
             .HasLearningRate()
             .HasHeadConnection()
-            .WithActivationFunction(std::make_shared<EmptyActivationStrategy>())
-            .WithErrorCalculation(std::make_shared<NeuronErrorStrategy>())
-            .WithValueCalculation(std::make_shared<NeuronValueStrategy>())
-            .WithWeightCalculation(std::make_shared<NeuronWeightStrategy>());
+            .WithActivationFunction(StrategyRegistry::Get<EmptyActivationStrategy>())
+            .WithErrorCalculation(StrategyRegistry::Get<NeuronErrorStrategy>())
+            .WithValueCalculation(StrategyRegistry::Get<NeuronValueStrategy>())
+            .WithWeightCalculation(StrategyRegistry::Get<NeuronWeightStrategy>());
     case Hidden:
         return NeuronBuilder()
             .AsType(Hidden)
             .HasLearningRate()
             .HasHeadConnection()
             .HasTailConnection()
-            .WithActivationFunction(std::make_shared<EmptyActivationStrategy>())
-            .WithErrorCalculation(std::make_shared<NeuronErrorStrategy>())
-            .WithValueCalculation(std::make_shared<NeuronValueStrategy>())
-            .WithWeightCalculation(std::make_shared<NeuronWeightStrategy>());
+            .WithActivationFunction(StrategyRegistry::Get<EmptyActivationStrategy>())
+            .WithErrorCalculation(StrategyRegistry::Get<NeuronErrorStrategy>())
+            .WithValueCalculation(StrategyRegistry::Get<NeuronValueStrategy>())
+            .WithWeightCalculation(StrategyRegistry::Get<NeuronWeightStrategy>());
     default:
         return NeuronBuilder();
     }
@@ -1,4 +1,4 @@
-#include "neuronStrategy.hpp"
+#include "NeuronStrategy.hpp"
 
 #include <numeric>
 
@@ -48,15 +48,24 @@ float NeuronValueStrategy::CalculateValue(const std::vector<Edge> &headEdges, co
     {
         return 0.0f;
     }
+    return activationFunction->Activation(WeightedSum(headEdges));
+}
 
-    const float total = std::transform_reduce(
-        headEdges.begin(), headEdges.end(),
-        0.0f,
-        std::plus<>(),
-        [] (const Edge &edge) { return edge.m_head->m_value * edge.m_weight; }
-    );
-
-    return activationFunction->Activation(total);
+float NeuronValueStrategy::WeightedSum(const std::vector<Edge> &headEdges)
+{
+    // Groups of four products are added pairwise, then the remainder one by one
+    float total = 0.0f;
+    size_t e = 0;
+    for (; headEdges.size() - e >= 4; e += 4)
+    {
+        total = total + ((headEdges[e].m_head->m_value * headEdges[e].m_weight + headEdges[e + 1].m_head->m_value * headEdges[e + 1].m_weight) +
+                         (headEdges[e + 2].m_head->m_value * headEdges[e + 2].m_weight + headEdges[e + 3].m_head->m_value * headEdges[e + 3].m_weight));
+    }
+    for (; e < headEdges.size(); ++e)
+    {
+        total = total + headEdges[e].m_head->m_value * headEdges[e].m_weight;
+    }
+    return total;
 }
 
 void NeuronWeightStrategy::UpdateConectedWeights(std::vector<Edge> &headEdges, const float learningRate, const float error)
@@ -66,3 +75,196 @@ void NeuronWeightStrategy::UpdateConectedWeights(std::vector<Edge> &headEdges, c
         edge.m_weight -= learningRate * error * edge.m_head->m_value;
     }
 }
+
+
+double SparsityCounters::Fraction(const uint64_t skipped, const uint64_t total)
+{
+    return total == 0 ? 0.0 : static_cast<double>(skipped) / static_cast<double>(total);
+}
+
+SparsityCounters &SparsityCounters::operator+=(const SparsityCounters &other)
+{
+    m_valueEdges += other.m_valueEdges;
+    m_valueEdgesSkipped += other.m_valueEdgesSkipped;
+    m_errorNeurons += other.m_errorNeurons;
+    m_errorNeuronsSkipped += other.m_errorNeuronsSkipped;
+    m_weightEdges += other.m_weightEdges;
+    m_weightEdgesSkipped += other.m_weightEdgesSkipped;
+    return *this;
+}
+
+float SparseNeuronErrorStrategy::CalculateError(const std::vector<Edge> &tailEdges, const std::vector<Edge> &headEdges, const float error)
+{
+    m_neurons.fetch_add(1, std::memory_order_relaxed);
+
+    // Every portion is a multiple of the error
+    if (error == 0.0f)
+    {
+        m_neuronsSkipped.fetch_add(1, std::memory_order_relaxed);
+        return 0.0f;
+    }
+    return m_dense.CalculateError(tailEdges, headEdges, error);
+}
+
+float SparseNeuronErrorStrategy::CalculateError(const float target, const float actual)
+{
+    return m_dense.CalculateError(target, actual);
+}
+
+SparsityCounters SparseNeuronErrorStrategy::Counters() const
+{
+    SparsityCounters counters;
+    counters.m_errorNeurons = m_neurons.load(std::memory_order_relaxed);
+    counters.m_errorNeuronsSkipped = m_neuronsSkipped.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void SparseNeuronErrorStrategy::ResetCounters()
+{
+    m_neurons = 0;
+    m_neuronsSkipped = 0;
+}
+
+float SparseNeuronValueStrategy::CalculateValue(const std::vector<Edge> &headEdges, const std::shared_ptr<INeuronFunctionStrategy> activationFunction)
+{
+    if (headEdges.empty() || activationFunction == nullptr)
+    {
+        return 0.0f;
+    }
+
+    uint64_t skipped = 0;
+    const auto product = [&skipped](const Edge &edge)
+    {
+        const float value = edge.m_head->m_value;
+        if (value == 0.0f)
+        {
+            ++skipped;
+            return 0.0f;
+        }
+        return value * edge.m_weight;
+    };
+
+    // Same grouping as NeuronValueStrategy::WeightedSum, a skipped product is +0 within its group
+    float total = 0.0f;
+    size_t e = 0;
+    for (; headEdges.size() - e >= 4; e += 4)
+    {
+        total = total + ((product(headEdges[e]) + product(headEdges[e + 1])) + (product(headEdges[e + 2]) + product(headEdges[e + 3])));
+    }
+    for (; e < headEdges.size(); ++e)
+    {
+        total = total + product(headEdges[e]);
+    }
+
+    // Counted once per neuron, not per edge, to keep atomics off the inner loop
+    m_edges.fetch_add(headEdges.size(), std::memory_order_relaxed);
+    m_edgesSkipped.fetch_add(skipped, std::memory_order_relaxed);
+
+    return activationFunction->Activation(total);
+}
+
+float SparseNeuronValueStrategy::CalculateValue(const std::vector<Edge> &headEdges, const std::span<const uint32_t> nonZeroHeads, const std::shared_ptr<INeuronFunctionStrategy> activationFunction)
+{
+    if (headEdges.empty() || activationFunction == nullptr)
+    {
+        return 0.0f;
+    }
+
+    // Groups without a non zero head would add +0, which leaves the running sum unchanged, so they are not visited
+    const size_t grouped = headEdges.size() - headEdges.size() % 4;
+    float total = 0.0f;
+    size_t i = 0;
+    while (i < nonZeroHeads.size() && nonZeroHeads[i] < grouped)
+    {
+        const size_t group = nonZeroHeads[i] - nonZeroHeads[i] % 4;
+        float products[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (; i < nonZeroHeads.size() && nonZeroHeads[i] < group + 4; ++i)
+        {
+            const Edge &edge = headEdges[nonZeroHeads[i]];
+            products[nonZeroHeads[i] - group] = edge.m_head->m_value * edge.m_weight;
+        }
+        total = total + ((products[0] + products[1]) + (products[2] + products[3]));
+    }
+    for (; i < nonZeroHeads.size(); ++i)
+    {
+        const Edge &edge = headEdges[nonZeroHeads[i]];
+        total = total + edge.m_head->m_value * edge.m_weight;
+    }
+
+    m_edges.fetch_add(headEdges.size(), std::memory_order_relaxed);
+    m_edgesSkipped.fetch_add(headEdges.size() - nonZeroHeads.size(), std::memory_order_relaxed);
+
+    return activationFunction->Activation(total);
+}
+
+SparsityCounters SparseNeuronValueStrategy::Counters() const
+{
+    SparsityCounters counters;
+    counters.m_valueEdges = m_edges.load(std::memory_order_relaxed);
+    counters.m_valueEdgesSkipped = m_edgesSkipped.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void SparseNeuronValueStrategy::ResetCounters()
+{
+    m_edges = 0;
+    m_edgesSkipped = 0;
+}
+
+void SparseNeuronWeightStrategy::UpdateConectedWeights(std::vector<Edge> &headEdges, const float learningRate, const float error)
+{
+    m_edges.fetch_add(headEdges.size(), std::memory_order_relaxed);
+
+    const float step = learningRate * error;
+    if (step == 0.0f)
+    {
+        m_edgesSkipped.fetch_add(headEdges.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t skipped = 0;
+    for (auto &edge : headEdges)
+    {
+        const float value = edge.m_head->m_value;
+        if (value == 0.0f)
+        {
+            ++skipped;
+            continue;
+        }
+        edge.m_weight -= step * value;
+    }
+    m_edgesSkipped.fetch_add(skipped, std::memory_order_relaxed);
+}
+
+void SparseNeuronWeightStrategy::UpdateConectedWeights(std::vector<Edge> &headEdges, const std::span<const uint32_t> nonZeroHeads, const float learningRate, const float error)
+{
+    m_edges.fetch_add(headEdges.size(), std::memory_order_relaxed);
+
+    const float step = learningRate * error;
+    if (step == 0.0f)
+    {
+        m_edgesSkipped.fetch_add(headEdges.size(), std::memory_order_relaxed);
+        return;
+    }
+
+    for (const uint32_t position : nonZeroHeads)
+    {
+        Edge &edge = headEdges[position];
+        edge.m_weight -= step * edge.m_head->m_value;
+    }
+    m_edgesSkipped.fetch_add(headEdges.size() - nonZeroHeads.size(), std::memory_order_relaxed);
+}
+
+SparsityCounters SparseNeuronWeightStrategy::Counters() const
+{
+    SparsityCounters counters;
+    counters.m_weightEdges = m_edges.load(std::memory_order_relaxed);
+    counters.m_weightEdgesSkipped = m_edgesSkipped.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void SparseNeuronWeightStrategy::ResetCounters()
+{
+    m_edges = 0;
+    m_edgesSkipped = 0;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <memory>
 
@@ -58,11 +61,22 @@ namespace fnn
 
         /**
          * @brief Calculates neuron value
+         *
+         * Products of head values and weights are summed in a fixed order on every platform: each group of four is
+         * added as ((p0 + p1) + (p2 + p3)) to the running sum, remaining products are added one by one. NModel,
+         * StaticNetwork, PopulationTrainer and generated sources sum in the same order to give identical results
          * @param headEdges [in] Edges to input neurons
          * @param activationFunction [in] Activation function
          * @return Calculated value
          */
         float CalculateValue(const std::vector<Edge> &headEdges, const std::shared_ptr<INeuronFunctionStrategy> activationFunction) override;
+
+        /**
+         * @brief Sums products of head values and weights in the order CalculateValue uses
+         * @param headEdges [in] Edges to input neurons
+         * @return Pre-activation sum
+         */
+        static float WeightedSum(const std::vector<Edge> &headEdges);
     };
 
     /**
@@ -82,4 +96,173 @@ namespace fnn
          */
         void UpdateConectedWeights(std::vector<Edge> &headEdges, const float learningRate, const float error) override;
     };
+
+    /// Sparsity aware neuron strategies
+
+    /**
+     * @struct SparsityCounters
+     * @brief Work done and skipped by sparsity aware strategies
+     */
+    struct SparsityCounters final
+    {
+    public:
+        uint64_t m_valueEdges = 0; ///< Edges seen by value calculation
+        uint64_t m_valueEdgesSkipped = 0; ///< Edges skipped because head neuron value was zero
+        uint64_t m_errorNeurons = 0; ///< Neurons seen by error calculation
+        uint64_t m_errorNeuronsSkipped = 0; ///< Neurons skipped because their error was zero
+        uint64_t m_weightEdges = 0; ///< Edges seen by weight update
+        uint64_t m_weightEdgesSkipped = 0; ///< Edges skipped because neuron error or head neuron value was zero
+
+
+        /**
+         * @brief Returns fraction of skipped work
+         * @param skipped [in] Skipped items
+         * @param total [in] All items
+         * @return Skipped fraction, 0 when total is 0
+         */
+        static double Fraction(const uint64_t skipped, const uint64_t total);
+
+        /**
+         * @brief Adds counters of another strategy
+         * @param other [in] Counters to add
+         * @return Reference to this
+         */
+        SparsityCounters &operator+=(const SparsityCounters &other);
+    };
+
+    /**
+     * @class SparseNeuronErrorStrategy
+     * @brief Error calculation of NeuronErrorStrategy that returns zero without touching edges when the error is zero
+     *
+     * Counters are atomic, one instance can be shared by all neurons of a network and by concurrent calls
+     */
+    class SparseNeuronErrorStrategy final : public INeuronErrorStrategy
+    {
+    public:
+        ~SparseNeuronErrorStrategy() override = default;
+
+        /**
+         * @brief Calculates error based on neuron connections, skipping neurons with zero error
+         * @param tailEdges [in] Edges from output neurons
+         * @param headEdges [in] Edges to input neurons
+         * @param error [in] Current error
+         * @return Calculated error
+         */
+        float CalculateError(const std::vector<Edge> &tailEdges, const std::vector<Edge> &headEdges, const float error) override;
+
+        /**
+         * @brief Calculates error based on target and actual values, applied only for output layer
+         * @param target [in] Target value
+         * @param actual [in] Actual neuron output
+         * @return Calculated error
+         */
+        float CalculateError(const float target, const float actual) override;
+
+        /**
+         * @brief Returns counters accumulated since construction or last reset
+         * @return Error counters, other fields are zero
+         */
+        SparsityCounters Counters() const;
+
+        /**
+         * @brief Sets counters to zero
+         */
+        void ResetCounters();
+
+    private:
+        NeuronErrorStrategy m_dense; ///< Calculation used for non zero errors
+        std::atomic<uint64_t> m_neurons = 0; ///< Neurons seen
+        std::atomic<uint64_t> m_neuronsSkipped = 0; ///< Neurons skipped
+    };
+
+    /**
+     * @class SparseNeuronValueStrategy
+     * @brief Value calculation that only multiplies edges whose head neuron value is non zero
+     *
+     * Products of zero heads count as +0 within their group of four, so the result equals NeuronValueStrategy bit
+     * for bit for finite weights. Counters are atomic, one instance can be shared by all neurons of a network and by
+     * concurrent calls
+     */
+    class SparseNeuronValueStrategy final : public INeuronValueStrategy
+    {
+    public:
+        ~SparseNeuronValueStrategy() override = default;
+
+        /**
+         * @brief Calculates neuron value, skipping zero inputs
+         * @param headEdges [in] Edges to input neurons
+         * @param activationFunction [in] Activation function
+         * @return Calculated value
+         */
+        float CalculateValue(const std::vector<Edge> &headEdges, const std::shared_ptr<INeuronFunctionStrategy> activationFunction) override;
+
+        /**
+         * @brief Calculates neuron value from edges of known non zero heads only, other edges are not touched
+         * @param headEdges [in] Edges to input neurons
+         * @param nonZeroHeads [in] Ascending positions of edges in headEdges whose head value is non zero
+         * @param activationFunction [in] Activation function
+         * @return Calculated value, equal to CalculateValue of all edges
+         */
+        float CalculateValue(const std::vector<Edge> &headEdges, const std::span<const uint32_t> nonZeroHeads, const std::shared_ptr<INeuronFunctionStrategy> activationFunction);
+
+        /**
+         * @brief Returns counters accumulated since construction or last reset
+         * @return Value counters, other fields are zero
+         */
+        SparsityCounters Counters() const;
+
+        /**
+         * @brief Sets counters to zero
+         */
+        void ResetCounters();
+
+    private:
+        std::atomic<uint64_t> m_edges = 0; ///< Edges seen
+        std::atomic<uint64_t> m_edgesSkipped = 0; ///< Edges skipped
+    };
+
+    /**
+     * @class SparseNeuronWeightStrategy
+     * @brief Weight update that leaves edges alone when the update is zero because of zero error or zero input
+     *
+     * Updated weights are bitwise equal to NeuronWeightStrategy for finite values.
+     * Counters are atomic, one instance can be shared by all neurons of a network and by concurrent calls
+     */
+    class SparseNeuronWeightStrategy final : public INeuronWeightStrategy
+    {
+    public:
+        ~SparseNeuronWeightStrategy() override = default;
+
+        /**
+         * @brief Updates weights of connected edges, skipping zero updates
+         * @param headEdges [in, out] Edges to input neurons
+         * @param learningRate [in] Learning rate
+         * @param error [in] Error value
+         */
+        void UpdateConectedWeights(std::vector<Edge> &headEdges, const float learningRate, const float error) override;
+
+        /**
+         * @brief Updates weights of edges of known non zero heads only, other edges are not touched
+         * @param headEdges [in, out] Edges to input neurons
+         * @param nonZeroHeads [in] Positions of edges in headEdges whose head value is non zero
+         * @param learningRate [in] Learning rate
+         * @param error [in] Error value
+         */
+        void UpdateConectedWeights(std::vector<Edge> &headEdges, const std::span<const uint32_t> nonZeroHeads, const float learningRate, const float error);
+
+        /**
+         * @brief Returns counters accumulated since construction or last reset
+         * @return Weight counters, other fields are zero
+         */
+        SparsityCounters Counters() const;
+
+        /**
+         * @brief Sets counters to zero
+         */
+        void ResetCounters();
+
+    private:
+        std::atomic<uint64_t> m_edges = 0; ///< Edges seen
+        std::atomic<uint64_t> m_edgesSkipped = 0; ///< Edges skipped
+    };
 }
@@ -0,0 +1,64 @@
+#include "StrategyRegistry.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+using namespace fnn;
+
+namespace
+{
+    /**
+     * @struct RegistryKeyHash
+     * @brief Hash of strategy type and parameter bytes
+     */
+    struct RegistryKeyHash final
+    {
+    public:
+        size_t operator()(const std::pair<std::type_index, std::string> &key) const
+        {
+            return key.first.hash_code() ^ (std::hash<std::string>()(key.second) * 31);
+        }
+    };
+
+    /**
+     * @struct RegistryState
+     * @brief Interned instances and the lock guarding them
+     */
+    struct RegistryState final
+    {
+    public:
+        std::mutex m_mutex; ///< Guards m_instances
+        std::unordered_map<std::pair<std::type_index, std::string>, std::shared_ptr<void>, RegistryKeyHash> m_instances; ///< Instances by type and parameters
+    };
+
+    /**
+     * @brief Returns process wide registry state
+     * @return Registry state, created on first use
+     */
+    RegistryState &state()
+    {
+        static RegistryState registryState;
+        return registryState;
+    }
+}
+
+size_t StrategyRegistry::Size()
+{
+    auto &registry = state();
+    const std::lock_guard lock(registry.m_mutex);
+    return registry.m_instances.size();
+}
+
+std::shared_ptr<void> StrategyRegistry::Intern(const std::type_index &type, const std::string &parameters, std::shared_ptr<void> (*factory)(const void*), const void *context)
+{
+    auto &registry = state();
+    const std::lock_guard lock(registry.m_mutex);
+
+    auto &instance = registry.m_instances[std::make_pair(type, parameters)];
+    if (instance == nullptr)
+    {
+        instance = factory(context);
+    }
+    return instance;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+
+namespace fnn
+{
+    /**
+     * @class StrategyRegistry
+     * @brief Interns stateless strategies so all neurons share one instance per strategy type and parameters
+     *
+     * Strategies handed out by the registry are shared between neurons and threads, so only strategies whose
+     * methods do not modify their state may be interned. Instances live until the end of the program.
+     */
+    class StrategyRegistry final
+    {
+    public:
+        /**
+         * @brief Returns shared instance of a strategy, creating it on first request
+         * @tparam Strategy Strategy type, constructed from parameters
+         * @tparam Parameters Trivially copyable constructor parameters without padding, their types and bytes are part
+         * of the instance key, so equal bytes of different types and zeros of different sign give different instances
+         * @param parameters [in] Constructor parameters
+         * @return Shared instance of Strategy constructed with parameters
+         */
+        template <typename Strategy, typename... Parameters>
+        static std::shared_ptr<Strategy> Get(const Parameters&... parameters);
+
+        /**
+         * @brief Returns number of interned instances
+         * @return Number of distinct strategy type and parameter combinations created so far
+         */
+        static size_t Size();
+
+    private:
+        /**
+         * @brief Returns instance registered under key, registering the instance created by factory when missing
+         * @param type [in] Strategy type
+         * @param parameters [in] Type names and raw bytes of constructor parameters
+         * @param factory [in] Creates the instance from context, called at most once per key
+         * @param context [in] Constructor parameters passed to factory
+         * @return Registered instance
+         */
+        static std::shared_ptr<void> Intern(const std::type_index &type, const std::string &parameters, std::shared_ptr<void> (*factory)(const void*), const void *context);
+    };
+
+    template <typename Strategy, typename... Parameters>
+    std::shared_ptr<Strategy> StrategyRegistry::Get(const Parameters&... parameters)
+    {
+        static_assert((std::is_trivially_copyable_v<Parameters> && ...), "Interned strategy parameters must be trivially copyable");
+        static_assert(((std::has_unique_object_representations_v<Parameters> || std::is_floating_point_v<Parameters>) && ...),
+            "Interned strategy parameters must not contain padding, their bytes would not identify the value");
+
+        const auto factory = [](const void *context) -> std::shared_ptr<void>
+        {
+            const auto &arguments = *static_cast<const std::tuple<const Parameters&...>*>(context);
+            return std::apply([](const auto&... values) { return std::make_shared<Strategy>(values...); }, arguments);
+        };
+        const std::tuple<const Parameters&...> arguments(parameters...);
+
+        if constexpr (sizeof...(Parameters) == 0)
+        {
+            // Parameterless strategies are looked up once, later requests skip the registry lock
+            static const auto instance = std::static_pointer_cast<Strategy>(Intern(std::type_index(typeid(Strategy)), std::string(), factory, &arguments));
+            return instance;
+        }
+        else
+        {
+            // Key is the type name of every parameter followed by its byte representation, the type fixes the length
+            std::string key;
+            ((key.append(typeid(Parameters).name()).push_back('\0'), key.append(reinterpret_cast<const char*>(&parameters), sizeof(Parameters))), ...);
+            return std::static_pointer_cast<Strategy>(Intern(std::type_index(typeid(Strategy)), key, factory, &arguments));
+        }
+    }
+}
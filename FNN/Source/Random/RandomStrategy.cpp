@@ -1,16 +1,112 @@
 #include "RandomStrategy.hpp"
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace fnn;
 
-float FastRandomStrategy::GetWeight(const float min, const float max)
+namespace
 {
-    constexpr uint64_t a = 1664525;    // LCG multiplier
-    constexpr uint64_t c = 1013904223; // LCG increment
-    constexpr uint64_t m = 2147483647; // Modulus (2^31 - 1)
+    constexpr uint64_t LCG_MULTIPLIER = 1664525;    ///< LCG multiplier
+    constexpr uint64_t LCG_INCREMENT = 1013904223;  ///< LCG increment
+    constexpr uint64_t LCG_MODULUS = 2147483647;    ///< Modulus (2^31 - 1)
+
+    constexpr size_t PARALLEL_FILL_SIZE = 1 << 20; ///< Weights per thread before Fill splits the work
+
+    /**
+     * @brief Advances LCG seed, equal to (a * seed + c) % m with 64 bit wrap-around
+     * @param seed [in] Current seed
+     * @return Next seed
+     */
+    uint64_t nextSeed(const uint64_t seed)
+    {
+        // 2^31 is 1 modulo 2^31 - 1, so high bits fold onto low bits instead of a 64 bit division
+        const uint64_t x = LCG_MULTIPLIER * seed + LCG_INCREMENT;
+        uint64_t r = (x & LCG_MODULUS) + (x >> 31);
+        r = (r & LCG_MODULUS) + (r >> 31);
+        return r >= LCG_MODULUS ? r - LCG_MODULUS : r;
+    }
 
+    /**
+     * @brief Returns weight number index of a counter based sequence
+     * @param seed [in] Key of the sequence
+     * @param index [in] Index of the weight
+     * @param min [in] Minimum value for the weight
+     * @param max [in] Maximum value for the weight
+     * @return A random float between min and max
+     */
+    float counterWeight(const uint64_t seed, const uint64_t index, const float min, const float max)
+    {
+        // SplitMix64 finalizer of the index-th state, top 24 bits fill the float mantissa exactly
+        uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+        return static_cast<float>(z >> 40) * 0x1.0p-24f * (max - min) + min;
+    }
+}
+
+float FastRandomStrategy::GetWeight(const float min, const float max)
+{
     // Update the seed
-    m_seed = (a * m_seed + c) % m;
+    m_seed = nextSeed(m_seed);
 
     // Scale and then adjust to min, max
-    return static_cast<float>(m_seed) / static_cast<float>(m) * (max - min) + min;
+    return static_cast<float>(m_seed) / static_cast<float>(LCG_MODULUS) * (max - min) + min;
+}
+
+void FastRandomStrategy::Fill(const std::span<float> weights, const float min, const float max)
+{
+    uint64_t seed = m_seed;
+    for (float &weight : weights)
+    {
+        seed = nextSeed(seed);
+        weight = static_cast<float>(seed) / static_cast<float>(LCG_MODULUS) * (max - min) + min;
+    }
+    m_seed = seed;
+}
+
+CounterRandomStrategy::CounterRandomStrategy(const uint64_t seed)
+    : m_seed(seed)
+{
+}
+
+float CounterRandomStrategy::GetWeight(const float min, const float max)
+{
+    return counterWeight(m_seed, m_counter.fetch_add(1, std::memory_order_relaxed), min, max);
+}
+
+void CounterRandomStrategy::Fill(const std::span<float> weights, const float min, const float max)
+{
+    const uint64_t first = m_counter.fetch_add(weights.size(), std::memory_order_relaxed);
+
+    // Every weight depends on its index only, so chunks give the same result on any number of threads
+    const size_t threads = std::min<size_t>(weights.size() / PARALLEL_FILL_SIZE, std::max(std::thread::hardware_concurrency(), 1u));
+    if (threads <= 1)
+    {
+        FillAt(weights, first, min, max);
+        return;
+    }
+
+    const size_t chunk = (weights.size() + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (size_t begin = chunk; begin < weights.size(); begin += chunk)
+    {
+        const size_t count = std::min(chunk, weights.size() - begin);
+        workers.emplace_back([this, weights, first, begin, count, min, max] { FillAt(weights.subspan(begin, count), first + begin, min, max); });
+    }
+    FillAt(weights.first(chunk), first, min, max);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void CounterRandomStrategy::FillAt(const std::span<float> weights, const uint64_t first, const float min, const float max) const
+{
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = counterWeight(m_seed, first + i, min, max);
+    }
 }
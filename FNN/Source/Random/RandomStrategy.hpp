@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 
@@ -26,7 +27,64 @@ namespace fnn
          */
         float GetWeight(const float min = 0, const float max = 1) override;
 
+        /**
+         * @brief Generates many random weights at once without a virtual call per weight
+         * @param weights [out] Weights to generate
+         * @param min [in] Minimum value for the weights
+         * @param max [in] Maximum value for the weights
+         */
+        void Fill(const std::span<float> weights, const float min, const float max) override;
+
     private:
         uint64_t m_seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()); ///< Seed for the random number generator
     };
+
+    /**
+     * @class CounterRandomStrategy
+     * @brief Generates every weight from its index alone, so weights can be generated in any order and in parallel
+     *
+     * Weight number i is a SplitMix64 hash of seed and i, the strategy only counts how many weights were handed out.
+     * For a given seed the same weights come out whether they are drawn one by one, filled at once or generated by
+     * several threads, and GetWeight and Fill are safe to call concurrently
+     */
+    class CounterRandomStrategy final : public IRandomStrategy
+    {
+    public:
+        /**
+         * @brief Creates strategy starting at weight index zero
+         * @param seed [in] Key of the generated sequence
+         */
+        explicit CounterRandomStrategy(const uint64_t seed);
+
+        ~CounterRandomStrategy() override = default;
+
+        /**
+         * @brief Generates next weight of the sequence
+         * @param min [in] Minimum value for the weight, default is 0
+         * @param max [in] Maximum value for the weight, default is 1
+         * @return A random float between min and max
+         */
+        float GetWeight(const float min = 0, const float max = 1) override;
+
+        /**
+         * @brief Generates next weights of the sequence, large spans are split between threads
+         * @param weights [out] Weights to generate
+         * @param min [in] Minimum value for the weights
+         * @param max [in] Maximum value for the weights
+         */
+        void Fill(const std::span<float> weights, const float min, const float max) override;
+
+        /**
+         * @brief Generates weights at given indices without advancing the sequence
+         * @param weights [out] Weights to generate
+         * @param first [in] Index of the first weight
+         * @param min [in] Minimum value for the weights
+         * @param max [in] Maximum value for the weights
+         */
+        void FillAt(const std::span<float> weights, const uint64_t first, const float min, const float max) const;
+
+    private:
+        uint64_t m_seed; ///< Key of the generated sequence
+        std::atomic<uint64_t> m_counter = 0; ///< Index of the next weight
+    };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 namespace fnn
 {
     /**
@@ -20,5 +22,19 @@ namespace fnn
          * @return A random weight as a float between min and max
          */
         virtual float GetWeight(const float min, const float max) = 0;
+
+        /**
+         * @brief Generates many random weights at once, equal to calling GetWeight for every element in order
+         * @param weights [out] Weights to generate
+         * @param min [in] Minimum bound for the generated weights
+         * @param max [in] Maximum bound for the generated weights
+         */
+        virtual void Fill(const std::span<float> weights, const float min, const float max)
+        {
+            for (float &weight : weights)
+            {
+                weight = GetWeight(min, max);
+            }
+        }
     };
 }
@@ -0,0 +1,287 @@
+#include "GraphReport.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <queue>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace fnn;
+
+namespace
+{
+    constexpr size_t CONTROL_BLOCK_BYTES = 2 * sizeof(void*); ///< Reference counts of a make_shared allocation, excluding vtable
+
+    /**
+     * @brief Estimates bytes taken by a heap allocation of given size
+     *
+     * Follows common malloc implementations: one word of header, 16 byte alignment and 32 byte minimal chunk
+     * @param bytes [in] Requested bytes
+     * @return Estimated allocated bytes, 0 for empty request
+     */
+    size_t allocationBytes(const size_t bytes)
+    {
+        if (bytes == 0)
+        {
+            return 0;
+        }
+        return std::max<size_t>(32, (bytes + sizeof(void*) + 15) & ~size_t(15));
+    }
+
+    /**
+     * @brief Returns histogram bucket of a degree
+     * @param degree [in] Number of edges
+     * @return 0 for degree 0, otherwise i such that degree is in [2^(i-1), 2^i)
+     */
+    size_t histogramBucket(const size_t degree)
+    {
+        return static_cast<size_t>(std::bit_width(degree));
+    }
+
+    /**
+     * @brief Increments histogram bucket of a degree, growing the histogram when needed
+     * @param histogram [in, out] Histogram to update
+     * @param degree [in] Number of edges
+     */
+    void addToHistogram(std::vector<size_t> &histogram, const size_t degree)
+    {
+        const size_t bucket = histogramBucket(degree);
+        if (histogram.size() <= bucket)
+        {
+            histogram.resize(bucket + 1, 0);
+        }
+        ++histogram[bucket];
+    }
+
+    /**
+     * @brief Writes array of numbers as JSON
+     * @param stream [in, out] Stream to write to
+     * @param values [in] Values to write
+     */
+    void writeJsonArray(std::ostringstream &stream, const std::vector<size_t> &values)
+    {
+        stream << "[";
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            stream << (i == 0 ? "" : ", ") << values[i];
+        }
+        stream << "]";
+    }
+}
+
+size_t MemoryFootprint::TotalBytes() const
+{
+    return m_neuronBytes + m_edgeBytes + m_strategyBytes + m_storageBytes + m_inputsBytes + m_outputsBytes + m_workspaceBytes;
+}
+
+std::string GraphReport::ToJson() const
+{
+    std::ostringstream stream;
+
+    stream << "{\n  \"memory\": {"
+           << "\"total_bytes\": " << m_memory.TotalBytes()
+           << ", \"neuron_bytes\": " << m_memory.m_neuronBytes
+           << ", \"edge_bytes\": " << m_memory.m_edgeBytes
+           << ", \"strategy_bytes\": " << m_memory.m_strategyBytes
+           << ", \"strategy_instances\": " << m_memory.m_strategyInstances
+           << ", \"storage_bytes\": " << m_memory.m_storageBytes
+           << ", \"inputs_bytes\": " << m_memory.m_inputsBytes
+           << ", \"outputs_bytes\": " << m_memory.m_outputsBytes
+           << ", \"workspace_bytes\": " << m_memory.m_workspaceBytes
+           << "},\n";
+
+    stream << "  \"shape\": {"
+           << "\"neurons\": " << m_shape.m_neurons
+           << ", \"inputs\": " << m_shape.m_inputs
+           << ", \"outputs\": " << m_shape.m_outputs
+           << ", \"head_edges\": " << m_shape.m_headEdges
+           << ", \"tail_edges\": " << m_shape.m_tailEdges
+           << ", \"duplicate_edges\": " << m_shape.m_duplicateEdges
+           << ", \"dangling_edges\": " << m_shape.m_danglingEdges
+           << ", \"acyclic\": " << (m_shape.m_isAcyclic ? "true" : "false")
+           << ", \"depth\": " << m_shape.m_depth
+           << ", \"max_fan_in\": " << m_shape.m_maxFanIn
+           << ", \"max_fan_out\": " << m_shape.m_maxFanOut
+           << ",\n    \"level_widths\": ";
+    writeJsonArray(stream, m_shape.m_levelWidths);
+    stream << ",\n    \"fan_in_histogram\": ";
+    writeJsonArray(stream, m_shape.m_fanInHistogram);
+    stream << ",\n    \"fan_out_histogram\": ";
+    writeJsonArray(stream, m_shape.m_fanOutHistogram);
+    stream << "}\n}\n";
+
+    return stream.str();
+}
+
+bool GraphReport::WriteJson(const std::string &path) const
+{
+    std::ofstream file(path);
+    file << ToJson();
+    return static_cast<bool>(file);
+}
+
+GraphReport utility::graphReport(const NGraph &graph)
+{
+    GraphReport report;
+    auto &memory = report.m_memory;
+    auto &shape = report.m_shape;
+
+    const size_t size = graph.Size();
+    shape.m_neurons = size;
+    shape.m_inputs = graph.m_inputs.size();
+    shape.m_outputs = graph.m_outputs.size();
+
+    memory.m_storageBytes = allocationBytes(graph.StorageBytes());
+    memory.m_inputsBytes = allocationBytes(graph.m_inputs.capacity() * sizeof(size_t));
+    memory.m_outputsBytes = allocationBytes(graph.m_outputs.capacity() * sizeof(size_t));
+
+    // Dense index of every neuron, edges are resolved through it
+    std::unordered_map<const Neuron*, size_t> indices;
+    indices.reserve(size);
+    for (const auto &neuron : graph.Neurons())
+    {
+        if (neuron != nullptr)
+        {
+            indices.emplace(neuron.get(), indices.size());
+        }
+    }
+
+    std::unordered_set<const void*> strategies;
+    if (graph.m_randomStrategy != nullptr)
+    {
+        strategies.insert(graph.m_randomStrategy.get());
+    }
+
+    std::vector<std::vector<size_t>> children(indices.size());
+    std::vector<size_t> parentCounts(indices.size(), 0);
+
+    for (const auto &[neuronPointer, index] : indices)
+    {
+        const Neuron &neuron = *neuronPointer;
+        // Neurons are created by make_shared, object and control block share one allocation
+        memory.m_neuronBytes += allocationBytes(sizeof(Neuron) + CONTROL_BLOCK_BYTES);
+
+        if (neuron.m_activationFunction.has_value() && neuron.m_activationFunction.value() != nullptr)
+        {
+            strategies.insert(neuron.m_activationFunction.value().get());
+        }
+        if (neuron.m_errorCalculation.has_value() && neuron.m_errorCalculation.value() != nullptr)
+        {
+            strategies.insert(neuron.m_errorCalculation.value().get());
+        }
+        if (neuron.m_valueCalculation.has_value() && neuron.m_valueCalculation.value() != nullptr)
+        {
+            strategies.insert(neuron.m_valueCalculation.value().get());
+        }
+        if (neuron.m_weightCalculation.has_value() && neuron.m_weightCalculation.value() != nullptr)
+        {
+            strategies.insert(neuron.m_weightCalculation.value().get());
+        }
+
+        size_t fanIn = 0;
+        if (neuron.m_headConnections.has_value())
+        {
+            const auto &headEdges = neuron.m_headConnections.value();
+            memory.m_edgeBytes += allocationBytes(headEdges.capacity() * sizeof(Edge));
+            fanIn = headEdges.size();
+            shape.m_headEdges += fanIn;
+
+            // Head edges point to parents through m_head
+            std::unordered_set<size_t> parents;
+            for (const auto &edge : headEdges)
+            {
+                const auto it = indices.find(edge.m_head.get());
+                if (it == indices.end())
+                {
+                    ++shape.m_danglingEdges;
+                }
+                else if (! parents.insert(it->second).second)
+                {
+                    ++shape.m_duplicateEdges;
+                }
+            }
+            for (const size_t parent : parents)
+            {
+                children[parent].push_back(index);
+            }
+            parentCounts[index] = parents.size();
+        }
+
+        size_t fanOut = 0;
+        if (neuron.m_tailConnections.has_value())
+        {
+            const auto &tailEdges = neuron.m_tailConnections.value();
+            memory.m_edgeBytes += allocationBytes(tailEdges.capacity() * sizeof(Edge));
+            fanOut = tailEdges.size();
+            shape.m_tailEdges += fanOut;
+
+            // Tail edges point to children through m_tail
+            std::unordered_set<const Neuron*> targets;
+            for (const auto &edge : tailEdges)
+            {
+                if (! indices.contains(edge.m_tail.get()))
+                {
+                    ++shape.m_danglingEdges;
+                }
+                else if (! targets.insert(edge.m_tail.get()).second)
+                {
+                    ++shape.m_duplicateEdges;
+                }
+            }
+        }
+
+        shape.m_maxFanIn = std::max(shape.m_maxFanIn, fanIn);
+        shape.m_maxFanOut = std::max(shape.m_maxFanOut, fanOut);
+        addToHistogram(shape.m_fanInHistogram, fanIn);
+        addToHistogram(shape.m_fanOutHistogram, fanOut);
+    }
+
+    // Strategies are created by make_shared, size of derived type is unknown so only the vtable pointer is counted
+    memory.m_strategyInstances = strategies.size();
+    memory.m_strategyBytes = strategies.size() * allocationBytes(sizeof(void*) + CONTROL_BLOCK_BYTES);
+
+    // Longest path levels by Kahn's algorithm, neurons left unprocessed lie on or behind a cycle
+    std::vector<size_t> levels(indices.size(), 0);
+    std::queue<size_t> ready;
+    for (size_t i = 0; i < parentCounts.size(); ++i)
+    {
+        if (parentCounts[i] == 0)
+        {
+            ready.push(i);
+        }
+    }
+
+    size_t processed = 0;
+    while (! ready.empty())
+    {
+        const size_t current = ready.front();
+        ready.pop();
+        ++processed;
+
+        if (shape.m_levelWidths.size() <= levels[current])
+        {
+            shape.m_levelWidths.resize(levels[current] + 1, 0);
+        }
+        ++shape.m_levelWidths[levels[current]];
+
+        for (const size_t child : children[current])
+        {
+            levels[child] = std::max(levels[child], levels[current] + 1);
+            if (--parentCounts[child] == 0)
+            {
+                ready.push(child);
+            }
+        }
+    }
+    shape.m_isAcyclic = processed == indices.size();
+    shape.m_depth = shape.m_levelWidths.size();
+
+    // Propagation keeps current and next frontier as hash sets of shared pointers, bounded by the widest level
+    const size_t maxWidth = shape.m_levelWidths.empty() ? 0 : *std::ranges::max_element(shape.m_levelWidths);
+    const size_t frontierBytes = allocationBytes(maxWidth * sizeof(void*)) + maxWidth * allocationBytes(sizeof(void*) + sizeof(std::shared_ptr<Neuron>));
+    memory.m_workspaceBytes = 2 * frontierBytes;
+
+    return report;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../NNetwork/NGraph.hpp"
+
+namespace fnn
+{
+    /**
+     * @struct MemoryFootprint
+     * @brief Estimated heap and object bytes held by a graph
+     *
+     * Sizes of containers and shared objects are estimated from their element counts, bucket counts and
+     * typical allocator overhead, totals approximate the resident memory a loaded model adds to the process
+     */
+    struct MemoryFootprint final
+    {
+    public:
+        size_t m_neuronBytes = 0; ///< Neuron objects including their shared pointer control blocks
+        size_t m_edgeBytes = 0; ///< Head and tail edge vectors, counted by capacity
+        size_t m_strategyBytes = 0; ///< Distinct strategy objects referenced by neurons
+        size_t m_storageBytes = 0; ///< Dense neuron storage of NGraph and its key remap
+        size_t m_inputsBytes = 0; ///< Key array NGraph::m_inputs
+        size_t m_outputsBytes = 0; ///< Key array NGraph::m_outputs
+        size_t m_workspaceBytes = 0; ///< Transient frontier sets of the widest propagation pass
+        size_t m_strategyInstances = 0; ///< Number of distinct strategy objects
+
+
+        /**
+         * @brief Returns sum of all byte counts
+         * @return Total estimated bytes
+         */
+        size_t TotalBytes() const;
+    };
+
+    /**
+     * @struct GraphShape
+     * @brief Structural statistics of a graph
+     *
+     * Levels are longest path depths from neurons without head connections, width of a level is the number of
+     * neurons on it. Histogram bucket 0 counts degree 0, bucket i > 0 counts degrees in [2^(i-1), 2^i)
+     */
+    struct GraphShape final
+    {
+    public:
+        size_t m_neurons = 0; ///< Number of neurons
+        size_t m_inputs = 0; ///< Number of input neurons
+        size_t m_outputs = 0; ///< Number of output neurons
+        size_t m_headEdges = 0; ///< Number of head edges, the edges carrying trained weights
+        size_t m_tailEdges = 0; ///< Number of tail edges
+        size_t m_duplicateEdges = 0; ///< Head or tail edges connecting the same pair of neurons as an earlier edge
+        size_t m_danglingEdges = 0; ///< Edges pointing to neurons that are not part of the graph
+        bool m_isAcyclic = true; ///< False when head connections form a cycle, levels then only cover the acyclic part
+        size_t m_depth = 0; ///< Number of levels
+        size_t m_maxFanIn = 0; ///< Largest number of head edges of a neuron
+        size_t m_maxFanOut = 0; ///< Largest number of tail edges of a neuron
+        std::vector<size_t> m_levelWidths; ///< Number of neurons on each level
+        std::vector<size_t> m_fanInHistogram; ///< Neurons per head edge count bucket
+        std::vector<size_t> m_fanOutHistogram; ///< Neurons per tail edge count bucket
+    };
+
+    /**
+     * @struct GraphReport
+     * @brief Memory footprint and shape of a graph
+     */
+    struct GraphReport final
+    {
+    public:
+        MemoryFootprint m_memory; ///< Estimated memory use
+        GraphShape m_shape; ///< Structural statistics
+
+
+        /**
+         * @brief Serializes report as JSON object
+         * @return JSON document
+         */
+        std::string ToJson() const;
+
+        /**
+         * @brief Writes report as JSON to file
+         * @param path [in] Path of the written file
+         * @return True if file was written, false otherwise
+         */
+        bool WriteJson(const std::string &path) const;
+    };
+
+    namespace utility
+    {
+        /**
+         * @brief Computes memory footprint and shape of a graph
+         * @param graph [in] Graph to inspect
+         * @return Report of the graph
+         */
+        GraphReport graphReport(const NGraph &graph);
+    }
+}
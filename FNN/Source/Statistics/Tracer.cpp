@@ -0,0 +1,404 @@
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace fnn;
+
+namespace
+{
+    constexpr size_t CHUNK_SIZE = 4096; ///< Events per buffer chunk
+
+    /**
+     * @struct TraceEvent
+     * @brief Single begin or end event
+     */
+    struct TraceEvent final
+    {
+    public:
+        const char *m_name = nullptr; ///< Event name
+        uint64_t m_timestamp = 0; ///< Nanoseconds since Tracer::Start
+        char m_phase = 'B'; ///< 'B' for begin, 'E' for end
+    };
+
+    /**
+     * @struct TraceChunk
+     * @brief Fixed size block of events, chunks never move so a reader can walk them while the owner appends
+     */
+    struct TraceChunk final
+    {
+    public:
+        std::array<TraceEvent, CHUNK_SIZE> m_events; ///< Event storage
+        std::atomic<size_t> m_size = 0; ///< Number of published events
+        std::atomic<TraceChunk*> m_next = nullptr; ///< Following chunk, published once this one is full
+    };
+
+    /**
+     * @struct ThreadBuffer
+     * @brief Events of a single thread, written only by the thread owning it
+     *
+     * Begin and End calls of a thread must nest. A begin event is recorded only when there is room left for its end
+     * event, so a full buffer drops whole scopes and every recorded begin event gets its end event
+     */
+    struct ThreadBuffer final
+    {
+    public:
+        uint32_t m_threadID = 0; ///< Sequential id used as tid in the trace
+        std::atomic<TraceChunk*> m_head = nullptr; ///< First chunk, owns the chain, allocated with the first event
+        TraceChunk *m_tail = nullptr; ///< Chunk events are appended to
+        size_t m_recorded = 0; ///< Events recorded since last reset
+        size_t m_pendingEnds = 0; ///< Recorded begin events whose end event is still to be recorded
+        std::vector<bool> m_open; ///< Open Begin calls from outermost, true when the begin event was recorded
+        std::atomic<uint64_t> m_epoch = 0; ///< Recording the events belong to, written by the owner only
+
+        ~ThreadBuffer()
+        {
+            Reset(0);
+            delete m_head.load();
+        }
+
+        /**
+         * @brief Frees all chunks except the first one and empties it, called by the owner or under the registry lock
+         * when the buffer has no owner
+         * @param epoch [in] Recording the emptied buffer belongs to
+         */
+        void Reset(const uint64_t epoch)
+        {
+            TraceChunk *head = m_head.load(std::memory_order_relaxed);
+            if (head != nullptr)
+            {
+                TraceChunk *chunk = head->m_next.exchange(nullptr);
+                while (chunk != nullptr)
+                {
+                    TraceChunk *next = chunk->m_next.load();
+                    delete chunk;
+                    chunk = next;
+                }
+                head->m_size = 0;
+            }
+            m_tail = head;
+            m_recorded = 0;
+            m_pendingEnds = 0;
+
+            // Begin events of scopes still open belong to the discarded recording, their end events are dropped
+            std::fill(m_open.begin(), m_open.end(), false);
+
+            // Publish emptied buffer, readers skip it while its epoch is outdated
+            m_epoch.store(epoch, std::memory_order_release);
+        }
+    };
+
+    /**
+     * @struct TracerState
+     * @brief Process wide tracer state
+     */
+    struct TracerState final
+    {
+    public:
+        std::atomic<bool> m_active = false; ///< Events are recorded only while active
+        std::atomic<size_t> m_dropped = 0; ///< Events dropped because a buffer was full
+        std::atomic<size_t> m_maxEventsPerThread = 0; ///< Capacity of each thread buffer
+        std::atomic<int64_t> m_start = 0; ///< Steady clock time of Start in nanoseconds, events are relative to it
+        std::atomic<uint64_t> m_epoch = 0; ///< Incremented by Clear, buffers of older epochs are reset by their owner
+
+        std::mutex m_registryMutex; ///< Guards registration and release of thread buffers
+        std::vector<std::unique_ptr<ThreadBuffer>> m_buffers; ///< Buffers of all threads that recorded an event
+        std::vector<ThreadBuffer*> m_free; ///< Buffers of exited threads, reused by new threads
+    };
+
+    /**
+     * @brief Returns process wide tracer state
+     * @return Tracer state, created on first use
+     */
+    TracerState &state()
+    {
+        static TracerState tracerState;
+        return tracerState;
+    }
+
+    /**
+     * @brief Returns current steady clock time
+     * @return Nanoseconds since steady clock epoch
+     */
+    int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @class ThreadBufferOwner
+     * @brief Holds buffer of a thread and returns it to the free list when the thread exits
+     */
+    class ThreadBufferOwner final
+    {
+    public:
+        ThreadBuffer *m_buffer = nullptr; ///< Buffer of the thread, nullptr until first recorded event
+
+        ~ThreadBufferOwner()
+        {
+            if (m_buffer == nullptr)
+            {
+                return;
+            }
+
+            // Recorded events stay in the buffer until a Clear or a new thread resets it
+            auto &tracer = state();
+            const std::lock_guard lock(tracer.m_registryMutex);
+            m_buffer->m_open.clear();
+            m_buffer->m_pendingEnds = 0;
+            tracer.m_free.push_back(m_buffer);
+        }
+    };
+
+    thread_local ThreadBufferOwner bufferOwner; ///< Buffer of the calling thread
+
+    /**
+     * @brief Returns buffer of the calling thread, taking a free or new one on first use
+     * @return Buffer of the calling thread, emptied when recorded before last Clear
+     */
+    ThreadBuffer &threadBuffer()
+    {
+        auto &tracer = state();
+        if (bufferOwner.m_buffer == nullptr)
+        {
+            const std::lock_guard lock(tracer.m_registryMutex);
+            if (! tracer.m_free.empty())
+            {
+                bufferOwner.m_buffer = tracer.m_free.back();
+                tracer.m_free.pop_back();
+            }
+            else
+            {
+                tracer.m_buffers.push_back(std::make_unique<ThreadBuffer>());
+                bufferOwner.m_buffer = tracer.m_buffers.back().get();
+                bufferOwner.m_buffer->m_threadID = static_cast<uint32_t>(tracer.m_buffers.size());
+                bufferOwner.m_buffer->m_epoch.store(tracer.m_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+        }
+
+        // Only the owner resets its buffer, Clear running on another thread just starts a new epoch
+        ThreadBuffer &buffer = *bufferOwner.m_buffer;
+        const uint64_t epoch = tracer.m_epoch.load(std::memory_order_acquire);
+        if (buffer.m_epoch.load(std::memory_order_relaxed) != epoch)
+        {
+            buffer.Reset(epoch);
+        }
+        return buffer;
+    }
+
+    /**
+     * @brief Appends event to the buffer of the calling thread
+     * @param buffer [in, out] Buffer of the calling thread
+     * @param name [in] Event name
+     * @param phase [in] 'B' for begin, 'E' for end
+     */
+    void append(ThreadBuffer &buffer, const char *name, const char phase)
+    {
+        TraceChunk *chunk = buffer.m_tail;
+        size_t size = chunk != nullptr ? chunk->m_size.load(std::memory_order_relaxed) : 0;
+        if (chunk == nullptr || size == CHUNK_SIZE)
+        {
+            auto *next = new TraceChunk();
+            if (chunk == nullptr)
+            {
+                buffer.m_head.store(next, std::memory_order_release);
+            }
+            else
+            {
+                chunk->m_next.store(next, std::memory_order_release);
+            }
+            buffer.m_tail = next;
+            chunk = next;
+            size = 0;
+        }
+
+        const int64_t elapsed = now() - state().m_start.load(std::memory_order_relaxed);
+        chunk->m_events[size] = TraceEvent{ name, static_cast<uint64_t>(std::max<int64_t>(elapsed, 0)), phase };
+
+        // Publish event to readers
+        chunk->m_size.store(size + 1, std::memory_order_release);
+        ++buffer.m_recorded;
+    }
+
+    /**
+     * @brief Records begin event on the calling thread when its end event fits into the buffer too
+     * @param name [in] Event name
+     */
+    void recordBegin(const char *name)
+    {
+        auto &tracer = state();
+        auto &buffer = threadBuffer();
+
+        const bool hasRoom = buffer.m_recorded + buffer.m_pendingEnds + 2 <= tracer.m_maxEventsPerThread.load(std::memory_order_relaxed);
+        buffer.m_open.push_back(hasRoom);
+        if (! hasRoom)
+        {
+            // Begin and end event of the scope
+            tracer.m_dropped.fetch_add(2, std::memory_order_relaxed);
+            return;
+        }
+
+        append(buffer, name, 'B');
+        ++buffer.m_pendingEnds;
+    }
+
+    /**
+     * @brief Records end event on the calling thread when the begin event of the innermost open scope was recorded
+     * @param name [in] Event name
+     */
+    void recordEnd(const char *name)
+    {
+        if (bufferOwner.m_buffer == nullptr)
+        {
+            // Thread never recorded, so it has no open scope
+            return;
+        }
+
+        auto &buffer = threadBuffer();
+        if (buffer.m_open.empty())
+        {
+            return;
+        }
+
+        const bool isRecorded = buffer.m_open.back();
+        buffer.m_open.pop_back();
+        if (isRecorded)
+        {
+            append(buffer, name, 'E');
+            --buffer.m_pendingEnds;
+        }
+    }
+}
+
+void Tracer::Start(const size_t maxEventsPerThread)
+{
+    Clear();
+
+    auto &tracer = state();
+    tracer.m_maxEventsPerThread.store(maxEventsPerThread, std::memory_order_relaxed);
+    tracer.m_start.store(now(), std::memory_order_relaxed);
+    tracer.m_active.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop()
+{
+    state().m_active.store(false, std::memory_order_release);
+}
+
+bool Tracer::IsActive()
+{
+    return state().m_active.load(std::memory_order_acquire);
+}
+
+void Tracer::Clear()
+{
+    auto &tracer = state();
+    const std::lock_guard lock(tracer.m_registryMutex);
+
+    // Buffers of running threads may be appended to right now, their owners reset them on their next event
+    const uint64_t epoch = tracer.m_epoch.load(std::memory_order_relaxed) + 1;
+    tracer.m_epoch.store(epoch, std::memory_order_release);
+    for (auto *buffer : tracer.m_free)
+    {
+        buffer->Reset(epoch);
+    }
+    tracer.m_dropped = 0;
+}
+
+size_t Tracer::DroppedEvents()
+{
+    return state().m_dropped.load(std::memory_order_relaxed);
+}
+
+bool Tracer::WriteChromeTrace(const std::string &path)
+{
+    std::ofstream file(path);
+    if (! file)
+    {
+        return false;
+    }
+
+    auto &tracer = state();
+    const std::lock_guard lock(tracer.m_registryMutex);
+
+    file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    file << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"FNN\"}}";
+
+    // Clear waits for the lock, so buffers of the current epoch are not reset while they are written
+    const uint64_t epoch = tracer.m_epoch.load(std::memory_order_relaxed);
+
+    char line[256];
+    for (const auto &buffer : tracer.m_buffers)
+    {
+        if (buffer->m_epoch.load(std::memory_order_acquire) != epoch)
+        {
+            // Events were recorded before the last Clear and are discarded once the owner records again
+            continue;
+        }
+
+        snprintf(line, sizeof(line), ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"Thread %u\"}}",
+            buffer->m_threadID, buffer->m_threadID);
+        file << line;
+
+        for (const TraceChunk *chunk = buffer->m_head.load(std::memory_order_acquire); chunk != nullptr; chunk = chunk->m_next.load(std::memory_order_acquire))
+        {
+            const size_t size = chunk->m_size.load(std::memory_order_acquire);
+            for (size_t i = 0; i < size; ++i)
+            {
+                const auto &event = chunk->m_events[i];
+
+                // Trace timestamps are microseconds, keep nanosecond resolution in the fraction
+                snprintf(line, sizeof(line), ",\n{\"name\": \"%s\", \"cat\": \"fnn\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %u}",
+                    event.m_name, event.m_phase, static_cast<double>(event.m_timestamp) / 1000.0, buffer->m_threadID);
+                file << line;
+            }
+        }
+    }
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
+
+void Tracer::Begin(const char *name)
+{
+    if (IsActive())
+    {
+        recordBegin(name);
+    }
+    else if (bufferOwner.m_buffer != nullptr)
+    {
+        // Keeps nesting of a thread that recorded before, the matching End must not close an outer scope
+        threadBuffer().m_open.push_back(false);
+    }
+}
+
+void Tracer::End(const char *name)
+{
+    recordEnd(name);
+}
+
+TraceScope::TraceScope(const char *name)
+    : m_name(Tracer::IsActive() ? name : nullptr)
+{
+    if (m_name != nullptr)
+    {
+        recordBegin(m_name);
+    }
+}
+
+TraceScope::~TraceScope()
+{
+    // Close the event even when tracer was stopped meanwhile, so begin and end stay paired
+    if (m_name != nullptr)
+    {
+        recordEnd(m_name);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace fnn
+{
+#if defined(FNN_ENABLE_TRACING)
+    constexpr bool TRACING_ENABLED = true; ///< Trace events are recorded, enabled by FNN_ENABLE_TRACING
+#else
+    constexpr bool TRACING_ENABLED = false; ///< Trace events are not recorded, enable by defining FNN_ENABLE_TRACING
+#endif
+
+    /**
+     * @class Tracer
+     * @brief Records begin and end events of Fit and Predict phases per thread and writes them as Chrome trace
+     *
+     * Every thread appends to its own buffer without locking, the only locks are taken when a thread takes its buffer
+     * on its first event and returns it on exit, buffers of exited threads are reused by new threads. Begin and end
+     * events of a thread must nest; when a buffer is full whole scopes are dropped, so every recorded begin event has
+     * its end event. Start and Clear may run while other threads record, each buffer is emptied by its own thread on
+     * its next event. Resulting file can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+     */
+    class Tracer final
+    {
+    public:
+        /**
+         * @brief Discards previously recorded events and starts recording
+         * @param maxEventsPerThread [in] Events recorded per thread before further events are dropped, default is 2^20
+         */
+        static void Start(const size_t maxEventsPerThread = size_t(1) << 20);
+
+        /**
+         * @brief Stops recording, recorded events are kept until next Start or Clear
+         */
+        static void Stop();
+
+        /**
+         * @brief Checks whether events are being recorded
+         * @return True if recording, false otherwise
+         */
+        static bool IsActive();
+
+        /**
+         * @brief Discards all recorded events
+         */
+        static void Clear();
+
+        /**
+         * @brief Returns number of events dropped because a thread buffer was full
+         * @return Number of dropped events since last Start or Clear
+         */
+        static size_t DroppedEvents();
+
+        /**
+         * @brief Writes recorded events in Chrome trace event JSON format
+         * @param path [in] Path of the written file
+         * @return True if file was written, false otherwise
+         */
+        static bool WriteChromeTrace(const std::string &path);
+
+
+        /**
+         * @brief Records begin of a named event on the calling thread
+         * @param name [in] Event name, must outlive the tracer, string literals are expected
+         */
+        static void Begin(const char *name);
+
+        /**
+         * @brief Records end of a named event on the calling thread if its begin event was recorded, also when the
+         * tracer was stopped meanwhile
+         * @param name [in] Event name, must match the name passed to Begin
+         */
+        static void End(const char *name);
+    };
+
+    /**
+     * @class TraceScope
+     * @brief Records begin event on construction and matching end event on destruction
+     */
+    class TraceScope final
+    {
+    public:
+        /**
+         * @brief Records begin event if tracer is active
+         * @param name [in] Event name, must outlive the tracer, string literals are expected
+         */
+        explicit TraceScope(const char *name);
+
+        /**
+         * @brief Records end event if begin event was recorded
+         */
+        ~TraceScope();
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope &operator=(const TraceScope&) = delete;
+
+    private:
+        const char *m_name; ///< Event name, nullptr when tracer was not active on construction
+    };
+}
+
+// Recording macro, expands to nothing unless FNN_ENABLE_TRACING is defined
+#if defined(FNN_ENABLE_TRACING)
+    #define FNN_TRACE_CONCAT_IMPL(a, b) a##b
+    #define FNN_TRACE_CONCAT(a, b) FNN_TRACE_CONCAT_IMPL(a, b)
+
+    #define FNN_TRACE_SCOPE(name) const fnn::TraceScope FNN_TRACE_CONCAT(fnnTraceScope, __LINE__)(name)
+#else
+    #define FNN_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
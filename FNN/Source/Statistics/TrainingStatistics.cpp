@@ -0,0 +1,127 @@
+#include "TrainingStatistics.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using namespace fnn;
+
+std::string fnn::utility::trainingPhaseToString(const TrainingPhase phase)
+{
+    using enum TrainingPhase;
+
+    switch (phase)
+    {
+        case Validation:
+            return "validation";
+        case ForwardPropagation:
+            return "forward";
+        case ErrorPropagation:
+            return "error";
+        case WeightUpdate:
+            return "weights";
+        case BackwardPropagation:
+            return "backward";
+        default:
+            return "unknown";
+    }
+}
+
+PhaseStatistics &TrainingStatistics::Phase(const TrainingPhase phase)
+{
+    return m_phases[static_cast<size_t>(phase)];
+}
+
+const PhaseStatistics &TrainingStatistics::Phase(const TrainingPhase phase) const
+{
+    return m_phases[static_cast<size_t>(phase)];
+}
+
+void TrainingStatistics::Reset()
+{
+    m_phases.fill(PhaseStatistics());
+    m_samples = 0;
+}
+
+std::string TrainingStatistics::ToPrometheus() const
+{
+    std::ostringstream stream;
+    stream.precision(9);
+
+    // Each metric family is written with its HELP and TYPE header followed by one sample per phase
+    const auto writeFamily = [this, &stream] (const char *name, const char *help, auto value)
+    {
+        stream << "# HELP " << name << " " << help << "\n";
+        stream << "# TYPE " << name << " counter\n";
+        for (size_t i = 0; i < m_phases.size(); ++i)
+        {
+            stream << name << "{phase=\"" << utility::trainingPhaseToString(static_cast<TrainingPhase>(i)) << "\"} " << value(m_phases[i]) << "\n";
+        }
+    };
+
+    writeFamily("fnn_phase_seconds_total", "Cumulative time spent in training phase.",
+        [] (const PhaseStatistics &phase) { return static_cast<double>(phase.m_nanoseconds) * 1.0e-9; });
+    writeFamily("fnn_phase_calls_total", "Number of times training phase was entered.",
+        [] (const PhaseStatistics &phase) { return phase.m_calls; });
+    writeFamily("fnn_phase_neurons_visited_total", "Neurons processed by training phase.",
+        [] (const PhaseStatistics &phase) { return phase.m_neuronsVisited; });
+    writeFamily("fnn_phase_edges_visited_total", "Edges read or updated by training phase.",
+        [] (const PhaseStatistics &phase) { return phase.m_edgesVisited; });
+
+    stream << "# HELP fnn_samples_total Samples processed by Fit and Predict.\n";
+    stream << "# TYPE fnn_samples_total counter\n";
+    stream << "fnn_samples_total " << m_samples << "\n";
+
+    return stream.str();
+}
+
+std::string TrainingStatistics::ToJson() const
+{
+    std::ostringstream stream;
+    stream.precision(9);
+
+    stream << "{\n  \"samples\": " << m_samples << ",\n  \"phases\": {\n";
+    for (size_t i = 0; i < m_phases.size(); ++i)
+    {
+        const auto &phase = m_phases[i];
+        // Propagation phases process single sample per call
+        const double perSample = phase.m_calls == 0 ? 0.0 : 1.0 / static_cast<double>(phase.m_calls);
+
+        stream << "    \"" << utility::trainingPhaseToString(static_cast<TrainingPhase>(i)) << "\": {"
+               << "\"calls\": " << phase.m_calls
+               << ", \"seconds\": " << static_cast<double>(phase.m_nanoseconds) * 1.0e-9
+               << ", \"neurons_visited\": " << phase.m_neuronsVisited
+               << ", \"edges_visited\": " << phase.m_edgesVisited
+               << ", \"neurons_per_sample\": " << static_cast<double>(phase.m_neuronsVisited) * perSample
+               << ", \"edges_per_sample\": " << static_cast<double>(phase.m_edgesVisited) * perSample
+               << "}" << (i + 1 < m_phases.size() ? "," : "") << "\n";
+    }
+    stream << "  }\n}\n";
+
+    return stream.str();
+}
+
+bool TrainingStatistics::WritePrometheus(const std::string &path) const
+{
+    std::ofstream file(path);
+    file << ToPrometheus();
+    return static_cast<bool>(file);
+}
+
+bool TrainingStatistics::WriteJson(const std::string &path) const
+{
+    std::ofstream file(path);
+    file << ToJson();
+    return static_cast<bool>(file);
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(TrainingStatistics &statistics, const TrainingPhase phase)
+    : m_phase(statistics.Phase(phase)), m_start(std::chrono::steady_clock::now())
+{
+}
+
+ScopedPhaseTimer::~ScopedPhaseTimer()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - m_start;
+    m_phase.m_nanoseconds += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    ++m_phase.m_calls;
+}
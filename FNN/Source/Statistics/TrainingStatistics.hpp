@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace fnn
+{
+#if defined(FNN_ENABLE_STATISTICS)
+    constexpr bool STATISTICS_ENABLED = true; ///< Statistics are recorded, enabled by FNN_ENABLE_STATISTICS
+#else
+    constexpr bool STATISTICS_ENABLED = false; ///< Statistics are not recorded, enable by defining FNN_ENABLE_STATISTICS
+#endif
+
+    /**
+     * @enum TrainingPhase
+     * @brief Enumerates the phases of Fit and Predict measured by TrainingStatistics
+     */
+    enum class TrainingPhase
+    {
+        Validation,         ///< Cycle detection done before training or prediction
+        ForwardPropagation, ///< Propagating inputs towards outputs
+        ErrorPropagation,   ///< Propagating errors from outputs towards inputs
+        WeightUpdate,       ///< Updating weights from outputs towards inputs
+        BackwardPropagation, ///< Propagating errors and updating weights in a single sweep
+        Count,              ///< Number of phases, not a phase
+    };
+
+    namespace utility
+    {
+        /**
+         * @brief Converts a TrainingPhase to its string representation
+         * @param phase [in] The TrainingPhase to convert
+         * @return A string representing the TrainingPhase
+         */
+        std::string trainingPhaseToString(const TrainingPhase phase);
+    }
+
+    /**
+     * @struct PhaseStatistics
+     * @brief Cumulative counters of a single training phase
+     */
+    struct PhaseStatistics final
+    {
+    public:
+        uint64_t m_calls = 0; ///< Number of times the phase was entered
+        uint64_t m_nanoseconds = 0; ///< Total time spent in the phase
+        uint64_t m_neuronsVisited = 0; ///< Neurons processed by the phase
+        uint64_t m_edgesVisited = 0; ///< Edges read or updated by the phase
+    };
+
+    /**
+     * @struct TrainingStatistics
+     * @brief Cumulative statistics of Fit and Predict calls of a network
+     *
+     * Counters are only updated when the library is built with FNN_ENABLE_STATISTICS,
+     * otherwise all recording compiles away and the counters stay zero
+     */
+    struct TrainingStatistics final
+    {
+    public:
+        std::array<PhaseStatistics, static_cast<size_t>(TrainingPhase::Count)> m_phases; ///< Counters of each phase, indexed by TrainingPhase
+        uint64_t m_samples = 0; ///< Samples processed by Fit and Predict
+
+
+        /**
+         * @brief Returns counters of a phase
+         * @param phase [in] Phase to return
+         * @return Counters of the phase
+         */
+        PhaseStatistics &Phase(const TrainingPhase phase);
+
+        /**
+         * @brief Returns counters of a phase
+         * @param phase [in] Phase to return
+         * @return Counters of the phase
+         */
+        const PhaseStatistics &Phase(const TrainingPhase phase) const;
+
+        /**
+         * @brief Sets all counters to zero
+         */
+        void Reset();
+
+
+        /**
+         * @brief Serializes statistics in Prometheus text exposition format
+         * @return Prometheus metrics
+         */
+        std::string ToPrometheus() const;
+
+        /**
+         * @brief Serializes statistics as JSON object
+         * @return JSON document
+         */
+        std::string ToJson() const;
+
+        /**
+         * @brief Writes statistics in Prometheus text exposition format to file
+         * @param path [in] Path of the written file
+         * @return True if file was written, false otherwise
+         */
+        bool WritePrometheus(const std::string &path) const;
+
+        /**
+         * @brief Writes statistics as JSON to file
+         * @param path [in] Path of the written file
+         * @return True if file was written, false otherwise
+         */
+        bool WriteJson(const std::string &path) const;
+    };
+
+    /**
+     * @class ScopedPhaseTimer
+     * @brief Adds time spent in its scope and one call to the counters of a phase
+     */
+    class ScopedPhaseTimer final
+    {
+    public:
+        /**
+         * @brief Starts measuring
+         * @param statistics [in, out] Statistics receiving the measurement
+         * @param phase [in] Measured phase
+         */
+        ScopedPhaseTimer(TrainingStatistics &statistics, const TrainingPhase phase);
+
+        /**
+         * @brief Stops measuring and records the measurement
+         */
+        ~ScopedPhaseTimer();
+
+        ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+        ScopedPhaseTimer &operator=(const ScopedPhaseTimer&) = delete;
+
+    private:
+        PhaseStatistics &m_phase; ///< Counters receiving the measurement
+        std::chrono::steady_clock::time_point m_start; ///< Time the scope was entered
+    };
+}
+
+// Recording macros, expand to nothing unless FNN_ENABLE_STATISTICS is defined
+#if defined(FNN_ENABLE_STATISTICS)
+    #define FNN_STATISTICS_CONCAT_IMPL(a, b) a##b
+    #define FNN_STATISTICS_CONCAT(a, b) FNN_STATISTICS_CONCAT_IMPL(a, b)
+
+    #define FNN_STATISTICS_SCOPE(statistics, phase) const fnn::ScopedPhaseTimer FNN_STATISTICS_CONCAT(fnnPhaseTimer, __LINE__)((statistics), (phase))
+    #define FNN_STATISTICS_VISIT(statistics, phase, neurons, edges) \
+        do { auto &fnnPhase = (statistics).Phase(phase); fnnPhase.m_neuronsVisited += (neurons); fnnPhase.m_edgesVisited += (edges); } while (false)
+    #define FNN_STATISTICS_SAMPLES(statistics, samples) ((statistics).m_samples += (samples))
+#else
+    #define FNN_STATISTICS_SCOPE(statistics, phase) static_cast<void>(0)
+    #define FNN_STATISTICS_VISIT(statistics, phase, neurons, edges) static_cast<void>(0)
+    #define FNN_STATISTICS_SAMPLES(statistics, samples) static_cast<void>(0)
+#endif